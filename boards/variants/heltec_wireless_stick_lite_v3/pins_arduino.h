@@ -65,4 +65,7 @@ static const uint8_t LoRa_RST = 12;
 static const uint8_t LoRa_BUSY = 13;
 static const uint8_t LoRa_DIO1 = 14;
 
+// IIM42652 INT1 output, header pin of the stick wired on the measurement board (RTC GPIO for deep sleep wake up)
+static const uint8_t IMU_INT1 = 2;
+
 #endif /* Pins_Arduino_h */
@@ -27,11 +27,29 @@ namespace Board
     // I2C interface configuration
     namespace I2cConfig
     {
-        constexpr uint32_t frequency = 100000; // 100kHz
+        constexpr uint32_t frequency = 400000; // 400kHz (fast mode)
         constexpr auto pinSda = GPIO_NUM_34;   // I2C SDA pin
         constexpr auto pinScl = GPIO_NUM_33;   // I2C SCL pin
     } // namespace I2C
 
+    // IMU interrupt configuration
+    namespace ImuConfig
+    {
+        constexpr auto pinInt1 = static_cast<gpio_num_t>(IMU_INT1); // IMU INT1 pin (board variant)
+
+        // INT1 wakes up the board by EXT1, only RTC GPIOs can do it
+        static_assert(pinInt1 <= GPIO_NUM_21, "IMU INT1 should be an RTC GPIO");
+        // Strapping pins are sampled on reset, the IMU push-pull output would change the boot mode
+        static_assert(pinInt1 != GPIO_NUM_0 && pinInt1 != GPIO_NUM_3 && pinInt1 != GPIO_NUM_45 &&
+                          pinInt1 != GPIO_NUM_46,
+                      "IMU INT1 shouldn't be a strapping pin");
+        // Pins used by the board
+        static_assert(pinInt1 != I2cConfig::pinSda && pinInt1 != I2cConfig::pinScl &&
+                          pinInt1 != ADC_IN && pinInt1 != ADC_CTRL && pinInt1 != Vext_CTRL &&
+                          (pinInt1 < LoRa_NSS || pinInt1 > LoRa_DIO1),
+                      "IMU INT1 pin is used by the board");
+    } // namespace ImuConfig
+
     // SPI interface configuration
     namespace SpiConfig
     {
@@ -86,7 +104,22 @@ namespace Board
      * @brief Goes into deep sleep mode and wait wake up events
      * @warning This function never returns
      *
-     * @param sleepDuration Time to sleep, seconds
+     * @param sleepDuration Time to sleep, seconds (0 - no timer wake up)
+     * @param wakeOnImu Wake up on IMU INT1 pin too (IMU stays powered)
+     */
+    void deepSleep(size_t sleepDuration, bool wakeOnImu = false);
+
+    /**
+     * @brief Check if the board is woken up from the deep sleep by IMU INT1 pin
+     *
+     * @return true if woken up by IMU, false otherwise
+     */
+    bool isWokenByImu();
+
+    /**
+     * @brief Check if the board is woken up from the deep sleep by timer
+     *
+     * @return true if woken up by timer, false otherwise
      */
-    void deepSleep(size_t sleepDuration);
+    bool isWokenByTimer();
 } // namespace Power
@@ -11,29 +11,60 @@
 
 #pragma once
 
+#include <stdarg.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #include <SdFat.h>
 
 /**
  * @brief SD card file object
- * Located in the specified directory on external storage
+ * Located in the specified directory on external storage.
+ * Data is combined in the RAM buffer and written to the card by whole sectors only (the rest is written by close).
+ * In the journaled mode the data is written to the journal and applied to the file by close at once
  */
 class FileSD
 {
-    constexpr static size_t pathMaxLength = 100; ///< Maximum length of path to file
+    constexpr static size_t pathMaxLength = 100;     ///< Maximum length of path to file
+    constexpr static size_t sectorSize = 512;        ///< SD card sector size, bytes
+    constexpr static size_t bufferSize = sectorSize; ///< Write combining buffer size, bytes (multiple of sector size)
+    constexpr static size_t printfMaxLength = 128;   ///< Maximum length of formatted string crossing the sector boundary
 
 public:
+    using MountHandler = void (*)(); ///< Handler of the background mounting finish
+
+    /**
+     * @brief Destroy the SD file object, buffered data is written to the file
+     */
+    ~FileSD();
+
     /**
      * @brief Start SD file system class
+     * The card is mounted by the background task (or by the first access), so the boot doesn't wait for the card init
      *
      * @param[in] frequency Maximum SCK frequency
-     * @return true if SD file system was started successfully, false otherwise
      */
-    static bool startFileSystem(uint32_t frequency);
+    static void startFileSystem(uint32_t frequency);
 
     /**
-     * @brief Start SD file system class
+     * @brief Set the handler called when the background mounting is finished (successfully or not)
+     * The handler is called right away if the mounting is already finished, so the card access it starts doesn't block.
+     * Called from the mount task (or from the caller), it must not block for long
+     *
+     * @param[in] handler Handler function
+     */
+    static void onMounted(MountHandler handler);
+
+    /**
+     * @brief Mount SD file system if it isn't mounted yet.
+     * Call it under @ref lock
+     *
+     * @return true if SD file system is mounted, false otherwise
+     */
+    static bool mount();
+
+    /**
+     * @brief Stop SD file system class
      */
     static void stopFileSystem();
 
@@ -45,20 +76,58 @@ public:
     static bool isCardAttached();
 
     /**
-     * @brief Get SD file system
+     * @brief Enable or disable the journaled mode of the files created after that
+     * Journaled file data is written to the preallocated journal first and applied to the file by close,
+     * so power fail leaves the file either without the data or with the whole data (after the recovery)
+     *
+     * @param[in] enable true to enable journaled mode, false to write files directly
+     */
+    static void setJournaling(bool enable);
+
+    /**
+     * @brief Get the journaled mode state, it is disabled if the journal can't be used
+     *
+     * @return true if the files are created in the journaled mode, false otherwise
+     */
+    static bool getJournaling();
+
+    /**
+     * @brief Recover the journal: apply the pending data (if any) to its file
+     * Time is bounded by the journal size, not by the card size
      *
-     * @return SD file system
+     * @return true if there is nothing to recover or the data is recovered, false otherwise
+     */
+    static bool recoverJournal();
+
+    /**
+     * @brief Lock SD card access, files are written by several tasks
      */
-    static SdFs &sdFs();
+    static void lock();
+
+    /**
+     * @brief Unlock SD card access
+     */
+    static void unlock();
+
+    /**
+     * @brief Get cached handle of the directory, the directory is created if it doesn't exist
+     * Handles stay opened until the file system is stopped, so the path is walked once only.
+     * File system is mounted by the first call. Call it under @ref lock
+     *
+     * @param[in] directory Directory path (nested directories are separated by "/")
+     * @return Pointer to the opened directory handle, nullptr if directory can't be opened
+     */
+    static FsFile *directory(const char *directory);
 
     /**
      * @brief Create new SD file
      *
      * @param directory Directory name
      * @param fileName File name
+     * @param extension File extension
      * @return True if file has been created successfully, false otherwise
      */
-    bool create(const char *directory, const char *fileName);
+    bool create(const char *directory, const char *fileName, const char *extension = "csv");
 
     /**
      * @brief Open existing file
@@ -90,6 +159,45 @@ public:
      */
     bool println(const char *string);
 
+    /**
+     * @brief Print formatted data to the file
+     *
+     * @param format Format string (printf style)
+     * @param ... Format arguments
+     * @return True if data has been added to the file, false otherwise
+     */
+    bool printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+    /**
+     * @brief Print data to the file by the custom formatter writing directly into the buffer
+     *
+     * @tparam Formatter Callable size_t(char *string), returns length of the formatted data
+     * @param lengthMax Maximum length of the formatted data
+     * @param formatter Formatter
+     * @return True if data has been added to the file, false otherwise
+     */
+    template <typename Formatter>
+    bool format(size_t lengthMax, Formatter formatter)
+    {
+        if (!_file || lengthMax > printfMaxLength)
+        {
+            return false;
+        }
+
+        if (_bufferLimit - _bufferLength > lengthMax)
+        {
+            // Formatted data fits to the current sector
+            _bufferLength += formatter(reinterpret_cast<char *>(&_buffer[_bufferLength]));
+            return true;
+        }
+
+        // Formatted data may cross the sector boundary, format it aside to split between sectors
+        char string[printfMaxLength];
+        size_t length = formatter(string);
+
+        return append(string, length);
+    }
+
     /**
      * @brief Write buffer to the file
      *
@@ -99,14 +207,82 @@ public:
      */
     bool write(const void *buffer, size_t size);
 
+    /**
+     * @brief Write buffered data to the file
+     *
+     * @return True if buffered data has been written to the file, false otherwise
+     */
+    bool flush();
+
     /**
      * @brief Get file size
      *
-     * @return File size, bytes
+     * @return File size (including buffered data), bytes
      */
     size_t size();
 
+    /**
+     * @brief Read data from the file, buffered data is written first
+     *
+     * @param position Position in the file to read from
+     * @param buffer Pointer to the buffer to read to
+     * @param size Number of bytes to read
+     * @return True if all the bytes have been read, false otherwise
+     */
+    bool read(size_t position, void *buffer, size_t size);
+
+    /**
+     * @brief Cut the file, buffered data is written first. Data is still added at the end of the file
+     *
+     * @param length New length of the file
+     * @return True if the file has been cut, false otherwise
+     */
+    bool truncate(size_t length);
+
 private:
+    /**
+     * @brief Add data to the write combining buffer, the buffer is flushed when the sector is full
+     *
+     * @param data Pointer to the data
+     * @param size Number of bytes to add
+     * @return True if data has been added, false otherwise
+     */
+    bool append(const void *data, size_t size);
+
+    /**
+     * @brief Align the buffer limit to the end of the file sector
+     */
+    void alignBuffer();
+
+    /**
+     * @brief Start the journaled mode of the opened file if it is enabled
+     */
+    void startJournal();
+
+    /**
+     * @brief Write data to the end of the file, or to the journal in the journaled mode
+     *
+     * @param data Pointer to the data
+     * @param size Number of bytes to write
+     * @return True if data has been written, false otherwise
+     */
+    bool writeData(const void *data, size_t size);
+
+    /**
+     * @brief Commit the journaled data: mark the journal pending, apply it to the file, mark it done
+     * Power fail before the pending mark leaves the file untouched, after it the data is applied by the recovery
+     *
+     * @return True if the data has been applied to the file, false otherwise
+     */
+    bool commitJournal();
+
     char _path[pathMaxLength + 1] = {0}; // Path to file in external storage
+    size_t _nameOffset = 0;              // Offset of the file name in the path
     FsFile _file;                        // Opened file handler
+    uint8_t _buffer[bufferSize];         // Write combining buffer
+    size_t _bufferLength = 0;            // Number of buffered bytes
+    size_t _bufferLimit = bufferSize;    // Number of bytes to buffer up to the sector boundary of the file
+    bool _isJournaled = false;           // File data is written to the journal (applied to the file by close)
+    size_t _targetOffset = 0;            // Length of the file the journaled data is added at
+    size_t _journalLength = 0;           // Number of journaled bytes
 };
\ No newline at end of file
@@ -24,16 +24,18 @@ enum class SettingsModules
 {
     SerialManager, // SerialManager settings id
     Measurements,  // Measurements setting id
+    TemperatureCompensation, // Temperature compensation table id
 
     Count // Total count of settings modules
 };
 
 namespace
 {
-    // Modules settings sizes
+    // Modules settings sizes, growing modules reserve space so the next modules keep their addresses
     constexpr size_t settingsSizeList[] = {
         6,  // SerialManager (int + uint8_t + CRC8) = 6
-        14, // Measurements (uint32_t * 2 + uint16_t + uint8_t * 3 + CRC8) = 14
+        64, // Measurements (uint32_t * 3 + uint16_t * 3 + uint8_t * 10 + CRC8) = 29, reserved 64
+        25, // TemperatureCompensation (float * 6 + CRC8) = 25
     };
     static_assert(sizeof(settingsSizeList) / sizeof(*settingsSizeList) == static_cast<size_t>(SettingsModules::Count),
                   "Settings size list doesn't match to modules count!");
@@ -0,0 +1,95 @@
+/**
+ * @file BlockRing.h
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Lock-free single producer single consumer ring of data blocks API
+ * @version 0.1
+ * @date 2024-08-26
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <stdbool.h>
+#include <stddef.h>
+
+namespace Measurements
+{
+    /**
+     * @brief Lock-free single producer single consumer ring of data block slots
+     * The ring manages slot indexes only, data blocks are stored by the owner at the slot index.
+     * Producer never overwrites a slot that isn't released by consumer, new blocks are dropped instead
+     */
+    class BlockRing
+    {
+    public:
+        /**
+         * @brief Ring backpressure statistics structure
+         */
+        struct Stats
+        {
+            size_t depth;     // Number of blocks waiting for consumer
+            size_t depthMax;  // Maximum number of blocks waiting for consumer
+            size_t committed; // Total number of blocks committed by producer
+            size_t overruns;  // Number of blocks dropped because the ring was full
+        };
+
+        /**
+         * @brief Reset the ring and its statistics
+         * @warning Both producer and consumer should be stopped
+         *
+         * @param[in] slotCount Number of block slots in the ring (should be greater than zero)
+         */
+        void reset(size_t slotCount);
+
+        /**
+         * @brief Get number of block slots in the ring
+         *
+         * @return Number of block slots
+         */
+        size_t slotCount() const;
+
+        /**
+         * @brief Producer: acquire the slot to fill the next block
+         * Acquiring again without commit returns the same slot
+         *
+         * @param[out] slot Slot index to fill
+         * @return true if the slot is free, false if the ring is full (overrun is counted)
+         */
+        bool acquire(size_t &slot);
+
+        /**
+         * @brief Producer: publish the filled block to consumer
+         */
+        void commit();
+
+        /**
+         * @brief Consumer: get the oldest filled block
+         *
+         * @param[out] slot Slot index of the block
+         * @return true if there is a block to consume, false otherwise
+         */
+        bool peek(size_t &slot) const;
+
+        /**
+         * @brief Consumer: release the consumed block slot to producer
+         */
+        void release();
+
+        /**
+         * @brief Get ring backpressure statistics
+         *
+         * @return Statistics
+         */
+        Stats stats() const;
+
+    private:
+        std::atomic<size_t> _head;     // Number of committed blocks, written by producer only
+        std::atomic<size_t> _tail;     // Number of released blocks, written by consumer only
+        std::atomic<size_t> _depthMax; // Maximum number of blocks waiting for consumer, written by producer only
+        std::atomic<size_t> _overruns; // Number of dropped blocks, written by producer only
+        size_t _slotCount;             // Number of block slots
+    };
+} // namespace Measurements
@@ -0,0 +1,48 @@
+/**
+ * @file ImuFifo.h
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief IMU FIFO batch draining API
+ * @version 0.1
+ * @date 2024-08-14
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <IIM42652.h>
+
+namespace Measurements::ImuFifo
+{
+    /**
+     * @brief Packet handler, called for every valid packet in FIFO order
+     */
+    using PacketHandler = void (*)(const IIM42652_fifo_packet_t &packet);
+
+    /**
+     * @brief FIFO batch statistics structure
+     */
+    struct Batch
+    {
+        size_t packets;  // Number of whole packets read from FIFO
+        size_t stored;   // Number of valid packets passed to the handler
+        size_t invalid;  // Number of invalid packets skipped (no sensor data or data isn't ready)
+        bool isOverflow; // FIFO was full, older samples are lost
+    };
+
+    /**
+     * @brief Drain whole packets of the IMU FIFO in one burst and pass valid packets to the handler
+     *
+     * @param[in] imu IMU driver
+     * @param[out] buffer FIFO raw data buffer (at least IIM42652_FIFO_SIZE bytes)
+     * @param[in] handler Handler of valid packets
+     * @param[out] batch Batch statistics
+     * @return true if FIFO has been read, false if I2C reading failed (no packets are handled then)
+     */
+    bool drain(IIM42652 &imu, uint8_t *buffer, PacketHandler handler, Batch &batch);
+} // namespace Measurements::ImuFifo
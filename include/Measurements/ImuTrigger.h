@@ -0,0 +1,82 @@
+/**
+ * @file ImuTrigger.h
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief IMU data trigger API: INT1 interrupt with the timer polling fallback
+ * @version 0.1
+ * @date 2024-08-14
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <Events.h>
+#include <freertos/FreeRTOS.h>
+
+namespace Measurements
+{
+    /**
+     * @brief IMU data trigger, wakes up the IMU task on the interrupt event or on the task schedule
+     * Timer polling is used as the fallback when the interrupt doesn't come in time.
+     * Schedule period is in microseconds on top of the OS tick, period fractions of the tick are carried over
+     * to the next wake up, so the average period is exact
+     */
+    class ImuTrigger
+    {
+    public:
+        // Interrupt timeout to fall back to the timer polling, expected interrupt intervals
+        constexpr static size_t interruptTimeoutFactor = 4;
+
+        /**
+         * @brief Construct a new IMU trigger object
+         *
+         * @param[in] eventGroup Event group of the interrupt and stop events
+         * @param[in] dataReadyEvent Event set by the interrupt handler
+         * @param[in] stopEvent Event to stop waiting
+         */
+        ImuTrigger(RTOS::EventGroup &eventGroup, EventBits_t dataReadyEvent, EventBits_t stopEvent);
+
+        /**
+         * @brief Start schedule from the current time
+         *
+         * @param[in] intervalUs Expected interval between IMU data, microseconds
+         * @param[in] useInterrupt Wait for the interrupt event (true) or poll on the schedule only (false)
+         */
+        void start(size_t intervalUs, bool useInterrupt);
+
+        /**
+         * @brief Wait for the next IMU data
+         *
+         * @param[out] isMissed Deadline is missed: the interrupt timeout or the late schedule wake up
+         * @return Occurred data ready and stop events, zero on the timer polling wake up
+         */
+        EventBits_t wait(bool &isMissed);
+
+        /**
+         * @brief Check if the interrupt is used
+         *
+         * @return true if interrupt is used, false if the timer polling is used
+         */
+        bool isInterrupt() const
+        {
+            return _useInterrupt;
+        }
+
+    private:
+        TickType_t periodTicks() const;
+        BaseType_t waitSchedule();
+
+        RTOS::EventGroup &_eventGroup; // Event group of the interrupt and stop events
+        EventBits_t _dataReadyEvent;   // Event set by the interrupt handler
+        EventBits_t _stopEvent;        // Event to stop waiting
+        bool _useInterrupt;            // Interrupt is used, cleared on the fallback to the timer polling
+
+        TickType_t _lastWakeTime; // Time of the last wake up, OS ticks
+        size_t _periodUs;         // Schedule period, microseconds
+        size_t _carryUs;          // Period fraction carried over to the next wake up, microseconds
+    };
+} // namespace Measurements
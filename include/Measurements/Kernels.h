@@ -0,0 +1,82 @@
+/**
+ * @file Kernels.h
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Vector reduction kernels API
+ * @version 0.1
+ * @date 2024-08-20
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace Measurements::Kernels
+{
+    /**
+     * @brief Get the minimum of the data set
+     *
+     * @param[in] data Data buffer
+     * @param[in] size Data size (should be greater than zero)
+     * @return Minimum value
+     */
+    int16_t min(const int16_t *data, size_t size);
+    float min(const float *data, size_t size);
+
+    /**
+     * @brief Get the maximum of the data set
+     *
+     * @param[in] data Data buffer
+     * @param[in] size Data size (should be greater than zero)
+     * @return Maximum value
+     */
+    int16_t max(const int16_t *data, size_t size);
+    float max(const float *data, size_t size);
+
+    /**
+     * @brief Get the sum of the data set
+     * Float values are accumulated in double precision
+     *
+     * @param[in] data Data buffer
+     * @param[in] size Data size
+     * @return Sum of values
+     */
+    int64_t sum(const int16_t *data, size_t size);
+    double sum(const float *data, size_t size);
+
+    /**
+     * @brief Get the sum of squares of the data set
+     * Float values are accumulated in double precision
+     *
+     * @param[in] data Data buffer
+     * @param[in] size Data size
+     * @return Sum of squared values
+     */
+    int64_t sumSquares(const int16_t *data, size_t size);
+    double sumSquares(const float *data, size_t size);
+
+    /**
+     * @brief Get the sum of squared deviations of the data set from the centre
+     *
+     * @param[in] data Data buffer
+     * @param[in] size Data size
+     * @param[in] centre Centre of the deviations (usually the mean of the data set)
+     * @return Sum of squared deviations
+     */
+    double sumSquares(const int16_t *data, size_t size, double centre);
+    double sumSquares(const float *data, size_t size, double centre);
+
+    /**
+     * @brief Get the dot product of two data sets
+     *
+     * @param[in] data1 The first data buffer
+     * @param[in] data2 The second data buffer
+     * @param[in] size Size of each data buffer
+     * @return Sum of pairwise products
+     */
+    int64_t dot(const int16_t *data1, const int16_t *data2, size_t size);
+    float dot(const float *data1, const float *data2, size_t size);
+} // namespace Measurements::Kernels
@@ -24,6 +24,7 @@ namespace Measurements::Manager
 
     /**
      * @brief Perform sensor input data processing
+     * Blocks until the measurement is complete or serial input is received (or the card is mounted)
      */
     void process();
 } // namespace Measurements::Manager
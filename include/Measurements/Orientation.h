@@ -0,0 +1,216 @@
+/**
+ * @file Orientation.h
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Orientation (roll/pitch) filters API
+ * @version 0.1
+ * @date 2024-08-24
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <MadgwickAHRS.h>
+
+// Orientation filters, selected at compile time with ORIENTATION_FILTER build flag
+#define ORIENTATION_FILTER_MADGWICK (0)
+#define ORIENTATION_FILTER_MAHONY (1)
+#define ORIENTATION_FILTER_COMPLEMENTARY (2)
+
+#ifndef ORIENTATION_FILTER
+#define ORIENTATION_FILTER (ORIENTATION_FILTER_MADGWICK)
+#endif
+
+// Mahony's filter default gains, may be set with build flags
+#ifndef MAHONY_KP
+#define MAHONY_KP (0.5f) // Proportional gain
+#endif
+#ifndef MAHONY_KI
+#define MAHONY_KI (0.0f) // Integral gain (gyroscope bias compensation), zero disables it
+#endif
+
+/**
+ * All filters share the same interface:
+ *  begin(sampleFrequency) - setup filter for the sampling frequency, Hz
+ *  update(gx, gy, gz, ax, ay, az) - feed the sample, gyroscope in deg/s and accelerometer in G
+ *  roll(), pitch() - angles in degrees, computed lazily on the first request after the update
+ * Angles follow the same convention for all filters: roll = atan2(gravityY, gravityZ), pitch = asin(-gravityX)
+ */
+namespace Measurements::Orientation
+{
+    /**
+     * @brief Madgwick's gradient descent filter (library implementation)
+     */
+    class MadgwickFilter
+    {
+    public:
+        /**
+         * @brief Setup filter for the sampling frequency
+         *
+         * @param[in] sampleFrequency Sampling frequency, Hz
+         */
+        void begin(float sampleFrequency);
+
+        /**
+         * @brief Update filter with the new sample
+         *
+         * @param[in] gx Gyroscope X axis, deg/s
+         * @param[in] gy Gyroscope Y axis, deg/s
+         * @param[in] gz Gyroscope Z axis, deg/s
+         * @param[in] ax Accelerometer X axis, G
+         * @param[in] ay Accelerometer Y axis, G
+         * @param[in] az Accelerometer Z axis, G
+         */
+        void update(float gx, float gy, float gz, float ax, float ay, float az);
+
+        /**
+         * @brief Get roll angle
+         *
+         * @return Roll angle, degrees
+         */
+        float roll();
+
+        /**
+         * @brief Get pitch angle
+         *
+         * @return Pitch angle, degrees
+         */
+        float pitch();
+
+    private:
+        Madgwick _filter; // Library filter, computes angles lazily by itself
+    };
+
+    /**
+     * @brief Mahony's proportional-integral complementary filter on quaternion
+     */
+    class MahonyFilter
+    {
+    public:
+        /**
+         * @brief Setup filter for the sampling frequency
+         *
+         * @param[in] sampleFrequency Sampling frequency, Hz
+         */
+        void begin(float sampleFrequency);
+
+        /**
+         * @brief Set filter gains, the integral error is reset
+         *
+         * @param[in] kp Proportional gain
+         * @param[in] ki Integral gain (gyroscope bias compensation), zero disables it
+         */
+        void setGains(float kp, float ki);
+
+        /**
+         * @brief Update filter with the new sample
+         *
+         * @param[in] gx Gyroscope X axis, deg/s
+         * @param[in] gy Gyroscope Y axis, deg/s
+         * @param[in] gz Gyroscope Z axis, deg/s
+         * @param[in] ax Accelerometer X axis, G
+         * @param[in] ay Accelerometer Y axis, G
+         * @param[in] az Accelerometer Z axis, G
+         */
+        void update(float gx, float gy, float gz, float ax, float ay, float az);
+
+        /**
+         * @brief Get roll angle
+         *
+         * @return Roll angle, degrees
+         */
+        float roll();
+
+        /**
+         * @brief Get pitch angle
+         *
+         * @return Pitch angle, degrees
+         */
+        float pitch();
+
+    private:
+        /**
+         * @brief Compute roll and pitch angles from the quaternion
+         */
+        void computeAngles();
+
+        float _twoKp = 2.0f * MAHONY_KP;                      // Proportional gain (doubled)
+        float _twoKi = 2.0f * MAHONY_KI;                      // Integral gain (doubled)
+        float _q0 = 1, _q1 = 0, _q2 = 0, _q3 = 0;              // Quaternion of sensor frame relative to earth frame
+        float _integralX = 0, _integralY = 0, _integralZ = 0; // Integral error terms, rad/s
+        float _sampleInterval = 0;                            // Interval between samples, seconds
+        float _roll = 0;                                      // Roll angle, radians
+        float _pitch = 0;                                     // Pitch angle, radians
+        bool _isAnglesComputed = false;                       // Angles correspond to the quaternion
+    };
+
+    /**
+     * @brief Complementary filter on the gravity vector
+     * Gravity direction is propagated by the gyroscope and pulled to the accelerometer,
+     * no normalisation and no trigonometry are done per sample
+     */
+    class ComplementaryFilter
+    {
+    public:
+        /**
+         * @brief Setup filter for the sampling frequency
+         *
+         * @param[in] sampleFrequency Sampling frequency, Hz
+         */
+        void begin(float sampleFrequency);
+
+        /**
+         * @brief Update filter with the new sample
+         *
+         * @param[in] gx Gyroscope X axis, deg/s
+         * @param[in] gy Gyroscope Y axis, deg/s
+         * @param[in] gz Gyroscope Z axis, deg/s
+         * @param[in] ax Accelerometer X axis, G
+         * @param[in] ay Accelerometer Y axis, G
+         * @param[in] az Accelerometer Z axis, G
+         */
+        void update(float gx, float gy, float gz, float ax, float ay, float az);
+
+        /**
+         * @brief Get roll angle
+         *
+         * @return Roll angle, degrees
+         */
+        float roll();
+
+        /**
+         * @brief Get pitch angle
+         *
+         * @return Pitch angle, degrees
+         */
+        float pitch();
+
+    private:
+        /**
+         * @brief Compute roll and pitch angles from the gravity vector
+         */
+        void computeAngles();
+
+        float _gravityX = 0, _gravityY = 0, _gravityZ = 0; // Gravity direction in sensor frame, G
+        float _sampleInterval = 0;                         // Interval between samples, seconds
+        float _gyroWeight = 0;                             // Weight of the gyroscope propagation
+        bool _isStarted = false;                           // Gravity vector is initialized by accelerometer
+        float _roll = 0;                                   // Roll angle, radians
+        float _pitch = 0;                                  // Pitch angle, radians
+        bool _isAnglesComputed = false;                    // Angles correspond to the gravity vector
+    };
+
+#if (ORIENTATION_FILTER == ORIENTATION_FILTER_MADGWICK)
+    using Filter = MadgwickFilter;
+#elif (ORIENTATION_FILTER == ORIENTATION_FILTER_MAHONY)
+    using Filter = MahonyFilter;
+#elif (ORIENTATION_FILTER == ORIENTATION_FILTER_COMPLEMENTARY)
+    using Filter = ComplementaryFilter;
+#else
+#error "Unknown ORIENTATION_FILTER"
+#endif
+} // namespace Measurements::Orientation
@@ -41,6 +41,14 @@ namespace Measurements
          */
         void setup(size_t sampleCount, size_t sampleFrequency);
 
+        /**
+         * @brief Update sampling frequency (e.g. measured instead of nominal one)
+         * Applies to the segments accumulated so far as well, since scaling is done by the results
+         *
+         * @param[in] sampleFrequency Sampling frequency, Hz
+         */
+        void setSampleFrequency(double sampleFrequency);
+
         /**
          * @brief Compute PSD for the next segment
          *
@@ -63,7 +71,7 @@ namespace Measurements
          */
         void clear();
 
-        size_t _sampleFrequency; // Sampling frequency
+        double _sampleFrequency; // Sampling frequency
         size_t _sampleCount;     // Number of sample in segment
         size_t _segmentCount;    // Number of computed segments
         size_t _binCount;        // Number of bins
@@ -0,0 +1,200 @@
+/**
+ * @file PsdRecord.h
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Binary PSD result record format API
+ * @version 0.1
+ * @date 2024-09-02
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <FastCRC.h>
+
+class FileSD;
+
+/**
+ * Record layout (little endian, packed):
+ *   Header
+ *   Channel descriptor + bins (binCount of them if the channel has PSD) per channel
+ *   CRC32 (PKZIP) of all the preceding bytes
+ */
+namespace Measurements::PsdRecord
+{
+    // Record magic number ("IPSD")
+    constexpr uint32_t magic = 0x44535049;
+    // Record format version
+    constexpr uint16_t version = 1;
+    // Maximum length of the channel name with the terminating zero
+    constexpr size_t nameLength = 12;
+    // Maximum length of the channel units with the terminating zero
+    constexpr size_t unitsLength = 8;
+    // Maximum length of the firmware version with the terminating zero
+    constexpr size_t firmwareLength = 16;
+    // Maximum number of bytes of the LogDelta bin (zigzag varint of 17 bits)
+    constexpr size_t logDeltaBytesMax = 3;
+
+    /**
+     * @brief PSD bins encodings
+     */
+    enum class BinEncoding : uint8_t
+    {
+        Float32,  // IEEE 754 single precision bin values
+        Log16,    // Bins quantised in log10 scale to uint16 (0 is a zero bin), see @ref ChannelDescriptor
+        LogDelta, // Log16 codes with the configured resolution, delta coded and packed to varints, see @ref ChannelDescriptor
+
+        Count // Total number of bin encodings
+    };
+
+#pragma pack(push, 1)
+    /**
+     * @brief Record header structure
+     */
+    struct Header
+    {
+        uint32_t magic;                  // Record magic number @ref magic
+        uint16_t version;                // Record format version @ref version
+        uint16_t headerSize;             // Size of this header, readers skip unknown trailing fields
+        uint8_t binEncoding;             // PSD bins encoding @ref BinEncoding
+        uint8_t channelCount;            // Number of channels in the record
+        uint16_t segmentSize;            // PSD segment size, samples
+        uint16_t binCount;               // Number of bins of every PSD channel
+        uint16_t loggingRate;            // Nominal sampling frequency, Hz
+        float measuredRate;              // Measured sampling frequency, Hz
+        float sampleClockPpm;            // Measured sampling frequency error, ppm
+        float timerDriftPpm;             // System timer drift against RTC, ppm (NaN if not estimated)
+        uint8_t startTime[6];            // Measurement start: second, minute, hour, day, month, year (since 1970)
+        uint8_t session;                 // Measurement session type (0 timer, 1 motion, 2 short)
+        uint8_t batteryLevel;            // Battery level, percents
+        uint16_t batteryVoltage;         // Battery voltage, millivolts
+        char firmware[firmwareLength];   // Firmware version string
+        uint32_t samples;                // Number of acquired samples
+        uint32_t missedDeadlines;        // Number of missed sampling deadlines
+        uint32_t duplicatedSamples;      // Number of duplicated samples
+        uint32_t readFailures;           // Number of IMU reading failures
+        uint32_t droppedSegments;        // Number of dropped segments
+        uint32_t batchIntervalMaxUs;     // Maximum mean interval between the samples of one batch, microseconds
+        float intervalMeanUs;            // Mean interval between samples, microseconds
+        uint32_t fifoOverflows;          // Number of IMU FIFO overflows
+        uint32_t invalidPackets;         // Number of skipped IMU FIFO packets
+        uint8_t lightSleep;              // Automatic light sleep was active (1) or not (0)
+    };
+
+    /**
+     * @brief Channel descriptor structure, followed by the PSD bins if the channel has them
+     * Log16 bin value is 0 for zero bin, or 10 ^ (logMin + (value - 1) * logStep) otherwise.
+     * LogDelta bins are binCount varints (7 bits per byte, least significant first, bit 7 is set if more bytes follow),
+     * each is zigzag coded ((delta << 1) ^ (delta >> 31)) difference of the Log16 code from the previous bin code
+     * (0 before the first bin). The code is decoded as Log16 then
+     */
+    struct ChannelDescriptor
+    {
+        char name[nameLength];   // Channel name
+        char units[unitsLength]; // Channel units
+        uint8_t hasPsd;          // Channel has PSD bins (1) or statistics only (0)
+        uint8_t reserved[3];     // Reserved for alignment, zeros
+        float maximum;           // Maximum value
+        float minimum;           // Minimum value
+        float mean;              // Mean value
+        float deviation;         // Standard deviation
+        float coreFrequency;     // Core (maximum amplitude) bin frequency, Hz
+        float coreAmplitude;     // Core (maximum amplitude) bin amplitude
+        float logMin;            // Log16/LogDelta encoding: log10 of the smallest non-zero bin
+        float logStep;           // Log16/LogDelta encoding: log10 step of the quantisation
+    };
+#pragma pack(pop)
+
+    /**
+     * @brief Quantise PSD bins to uint16 in log10 scale
+     * The whole range of non-zero bins is spread over 65535 codes, so relative error stays below range / 65534 decades
+     *
+     * @param[in] bins PSD bins
+     * @param[in] count Number of bins
+     * @param[out] codes Quantised bins
+     * @param[out] logMin log10 of the smallest non-zero bin
+     * @param[out] logStep log10 step of the quantisation
+     */
+    void quantizeLog(const double *bins, size_t count, uint16_t *codes, float &logMin, float &logStep);
+
+    /**
+     * @brief Restore PSD bins from Log16 codes
+     *
+     * @param[in] codes Quantised bins
+     * @param[in] count Number of bins
+     * @param[in] logMin log10 of the smallest non-zero bin
+     * @param[in] logStep log10 step of the quantisation
+     * @param[out] bins PSD bins
+     */
+    void dequantizeLog(const uint16_t *codes, size_t count, float logMin, float logStep, double *bins);
+
+    /**
+     * @brief Compress PSD bins: quantise them in log10 scale with the resolution, delta code and pack to varints
+     * Bins are power densities, so the quantisation step is resolution / 10 decades and every non-zero bin is
+     * reconstructed within +-resolution / 2 dB (the step is made coarser only if the bins span more than 65534 steps)
+     *
+     * @param[in] bins PSD bins
+     * @param[in] count Number of bins
+     * @param[in] resolutionDb Quantisation resolution, dB
+     * @param[out] data Compressed bins (at least count * @ref logDeltaBytesMax bytes)
+     * @param[out] logMin log10 of the smallest non-zero bin
+     * @param[out] logStep log10 step of the quantisation
+     * @return Size of the compressed bins, bytes
+     */
+    size_t compressLog(const double *bins, size_t count, float resolutionDb, uint8_t *data, float &logMin, float &logStep);
+
+    /**
+     * @brief Restore PSD bins from LogDelta data
+     *
+     * @param[in] data Compressed bins
+     * @param[in] size Size of the data (may be followed by other data), bytes
+     * @param[in] count Number of bins
+     * @param[in] logMin log10 of the smallest non-zero bin
+     * @param[in] logStep log10 step of the quantisation
+     * @param[out] bins PSD bins
+     * @return Size of the compressed bins, bytes (0 if the data ends before the bins or a code is out of Log16 range)
+     */
+    size_t decompressLog(const uint8_t *data, size_t size, size_t count, float logMin, float logStep, double *bins);
+
+    /**
+     * @brief Record writer, accumulates CRC of the written data
+     */
+    class Writer
+    {
+    public:
+        /**
+         * @brief Construct a new record writer
+         *
+         * @param[in] file Opened file to write the record to
+         */
+        explicit Writer(FileSD &file);
+
+        /**
+         * @brief Write record data
+         *
+         * @param[in] data Pointer to the data
+         * @param[in] size Number of bytes to write
+         * @return true if data has been written, false if this or any previous writing failed
+         */
+        bool write(const void *data, size_t size);
+
+        /**
+         * @brief Finish the record with CRC
+         *
+         * @return true if the whole record has been written, false otherwise
+         */
+        bool finish();
+
+    private:
+        FileSD &_file;    // File to write the record to
+        FastCRC32 _crc32; // CRC calculator
+        uint32_t _crc;    // Accumulated CRC value
+        size_t _size;     // Number of written bytes
+        bool _result;     // Result of all the writings
+    };
+} // namespace Measurements::PsdRecord
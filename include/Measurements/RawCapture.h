@@ -0,0 +1,136 @@
+/**
+ * @file RawCapture.h
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Raw IMU samples capture to SD card API
+ * @version 0.1
+ * @date 2024-09-06
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <limits>
+
+/**
+ * Raw file layout:
+ *   Text header (key,value lines) padded with zeros to the first sector (512 bytes)
+ *   Packed little endian int16 samples: ACC_X, ACC_Y, ACC_Z, GYRO_X, GYRO_Y, GYRO_Z
+ *   Block marks in place of samples after the samples of the acquired block:
+ *   ACC_X and ACC_Y are the block marker, the rest is int64 system timer time of the latest sample, us
+ */
+namespace Measurements::RawCapture
+{
+    // Marker of the block mark in ACC_X and ACC_Y, samples matching it are clamped by 1 LSB
+    constexpr int16_t blockMarker = std::numeric_limits<int16_t>::min();
+    // Minimum interval between block marks, microseconds (polled samples are blocks of one sample)
+    constexpr int64_t blockMarkIntervalUs = 10000;
+
+#pragma pack(push, 1)
+    /**
+     * @brief Raw IMU sample structure
+     */
+    struct Sample
+    {
+        int16_t accX;
+        int16_t accY;
+        int16_t accZ;
+        int16_t gyrX;
+        int16_t gyrY;
+        int16_t gyrZ;
+    };
+
+    /**
+     * @brief Raw block mark structure, takes place of a sample
+     */
+    struct BlockMark
+    {
+        int16_t marker[2]; // Block marker in place of ACC_X and ACC_Y
+        int64_t timeUs;    // System timer time of the latest sample of the block, microseconds
+    };
+#pragma pack(pop)
+
+    static_assert(sizeof(BlockMark) == sizeof(Sample), "Block mark must take place of a sample!");
+
+    /**
+     * @brief Raw capture setup structure
+     */
+    struct Setup
+    {
+        const char *directory;    // Directory of the file
+        const char *fileName;     // File name (without directory and extension)
+        size_t sampleFrequency;   // Sampling frequency, Hz
+        size_t duration;          // Expected capture duration to preallocate the file, seconds
+        float accelScale;         // Accelerometer scale, m/s^2 per LSB
+        float gyroScale;          // Gyroscope scale, rad/s per LSB
+    };
+
+    /**
+     * @brief Raw capture statistics structure
+     */
+    struct Stats
+    {
+        uint32_t samples;      // Number of captured samples
+        uint32_t overruns;     // Number of samples and marks dropped because the ring was full
+        uint32_t marks;        // Number of captured block marks
+        uint32_t bytes;        // Number of bytes written to the file
+        uint32_t ringUsedMax;  // Maximum number of bytes waiting in the ring
+        uint32_t writeMaxUs;   // Maximum time of the sector writing, microseconds
+        uint64_t writeSumUs;   // Total time of the writings, microseconds
+    };
+
+    /**
+     * @brief Initialize raw capture, start the writer task
+     */
+    void initialize();
+
+    /**
+     * @brief Create the raw file and start capture
+     *
+     * @param[in] setup Capture setup
+     * @return true if capture is started, false otherwise
+     */
+    bool start(const Setup &setup);
+
+    /**
+     * @brief Stop capture, write the rest of samples and close the file
+     * Blocks until the writer task has finished the file
+     */
+    void stop();
+
+    /**
+     * @brief Check if capture is running
+     *
+     * @return true if capture is running, false otherwise
+     */
+    bool isRunning();
+
+    /**
+     * @brief Add sample to the capture (producer side, doesn't block)
+     *
+     * @param[in] sample Raw IMU sample
+     * @return true if sample is added or capture isn't running, false if sample is dropped
+     */
+    bool write(const Sample &sample);
+
+    /**
+     * @brief Mark the end of the acquired block with its timestamp (producer side, doesn't block)
+     * Marks closer than blockMarkIntervalUs to the previous one are skipped
+     *
+     * @param[in] timeUs System timer time of the latest sample of the block, microseconds
+     * @return true if mark is added, skipped or capture isn't running, false if mark is dropped
+     */
+    bool mark(int64_t timeUs);
+
+    /**
+     * @brief Get statistics of the current (or the last) capture
+     *
+     * @return Capture statistics
+     */
+    Stats stats();
+} // namespace Measurements::RawCapture
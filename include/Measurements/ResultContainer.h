@@ -0,0 +1,205 @@
+/**
+ * @file ResultContainer.h
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Daily container of measurement results API
+ * @version 0.1
+ * @date 2024-09-09
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+class FileSD;
+
+/**
+ * Container layout (little endian, packed):
+ *   Result records (CSV text or PSD records, see @ref PsdRecord), back to back in order of writing,
+ *   every record is followed by its RecordTrailer
+ *   Index: IndexEntry per record
+ *   Footer (the last bytes of the file)
+ *
+ * A reader takes the footer from the end of the file and the index at the footer index offset,
+ * then finds the records of the time range by binary search (times are ascending).
+ * Record size is the distance to the next record offset (or to the index offset for the last one)
+ * without the record trailer.
+ * Appending a record overwrites the index, then the index is written again after the new record.
+ * Power fail leaves the container without the footer, the index is rebuilt then from the record trailers
+ * (see @ref rebuildIndex) and the rest after the last whole record is dropped.
+ * A container of the other format version is left as is, the records are added to the next part of the day.
+ * The host tool (tools/PsdConvert) extracts the records to CSV files.
+ */
+namespace Measurements::ResultContainer
+{
+    // Container footer magic number ("IPDC")
+    constexpr uint32_t magic = 0x43445049;
+    // Record trailer magic number ("RPDC")
+    constexpr uint32_t trailerMagic = 0x43445052;
+    // Container format version
+    constexpr uint16_t version = 2;
+    // Maximum number of records in one container (one per 42 seconds per day), the next part is opened then
+    constexpr size_t recordsMax = 2048;
+    // Maximum number of container parts per day
+    constexpr size_t partsMax = 10;
+
+#pragma pack(push, 1)
+    /**
+     * @brief Index entry structure
+     */
+    struct IndexEntry
+    {
+        uint32_t offset; // Offset of the record from the beginning of the file
+        uint32_t time;   // Epoch time of the record, seconds
+    };
+
+    /**
+     * @brief Record trailer structure
+     */
+    struct RecordTrailer
+    {
+        uint32_t offset; // Offset of the record from the beginning of the file
+        uint32_t time;   // Epoch time of the record, seconds
+        uint32_t crc;    // CRC32 (PKZIP) of the preceding trailer fields
+        uint32_t magic;  // Record trailer magic number @ref trailerMagic
+    };
+
+    /**
+     * @brief Container footer structure
+     */
+    struct Footer
+    {
+        uint32_t indexOffset; // Offset of the index from the beginning of the file
+        uint16_t recordCount; // Number of records (index entries)
+        uint16_t version;     // Container format version @ref version
+        uint32_t crc;         // CRC32 (PKZIP) of the index and the preceding footer fields
+        uint32_t magic;       // Container magic number @ref magic
+    };
+#pragma pack(pop)
+
+    /**
+     * @brief Make the trailer of the record
+     *
+     * @param[in] offset Offset of the record from the beginning of the file
+     * @param[in] time Epoch time of the record, seconds
+     * @return Record trailer
+     */
+    RecordTrailer makeTrailer(uint32_t offset, uint32_t time);
+
+    /**
+     * @brief Check the trailer of the record
+     *
+     * @param[in] trailer Record trailer
+     * @param[in] offset Offset of the record from the beginning of the file
+     * @return true if the trailer is valid and belongs to the record, false otherwise
+     */
+    bool checkTrailer(const RecordTrailer &trailer, uint32_t offset);
+
+    /**
+     * @brief Check the footer layout against the file
+     *
+     * @param[in] footer Container footer
+     * @param[in] fileSize Size of the file, bytes
+     * @return true if the footer and the index fit the file, false otherwise
+     */
+    bool checkFooter(const Footer &footer, size_t fileSize);
+
+    /**
+     * @brief Calculate CRC of the index and the footer fields preceding the CRC
+     *
+     * @param[in] entries Index entries (footer record count)
+     * @param[in] footer Container footer
+     * @return CRC value
+     */
+    uint32_t calculateCrc(const IndexEntry *entries, const Footer &footer);
+
+    /**
+     * @brief Rebuild the index by scanning the records for their trailers from the beginning of the file
+     * The scanning stops at the first record without a valid trailer (the power fail cut it)
+     *
+     * @tparam Read Callable bool(size_t position, void *buffer, size_t size), reads the file
+     * @param[in] read File reading
+     * @param[in] fileSize Size of the file, bytes
+     * @param[out] entries Index entries
+     * @param[in] entriesMax Maximum number of the index entries
+     * @param[out] endOffset End of the last whole record with its trailer (the next record offset)
+     * @return Number of found records, 0 if the reading failed
+     */
+    template <typename Read>
+    size_t rebuildIndex(Read read, size_t fileSize, IndexEntry *entries, size_t entriesMax, uint32_t &endOffset)
+    {
+        // Scanning window, the trailer is looked for at every byte
+        uint8_t window[512];
+        size_t windowStart = 0;
+        size_t windowLength = 0;
+
+        size_t count = 0;
+        size_t recordOffset = 0;
+        for (size_t position = 0; position + sizeof(RecordTrailer) <= fileSize && count < entriesMax; position++)
+        {
+            if (position + sizeof(RecordTrailer) > windowStart + windowLength)
+            {
+                windowStart = position;
+                windowLength = (fileSize - position < sizeof(window)) ? fileSize - position : sizeof(window);
+                if (read(windowStart, window, windowLength) == false)
+                {
+                    count = 0;
+                    recordOffset = 0;
+                    break;
+                }
+            }
+
+            const uint8_t *bytes = &window[position - windowStart];
+            if (memcmp(&bytes[offsetof(RecordTrailer, magic)], &trailerMagic, sizeof(trailerMagic)) != 0)
+            {
+                continue;
+            }
+
+            RecordTrailer trailer;
+            memcpy(&trailer, bytes, sizeof(trailer));
+            if (checkTrailer(trailer, recordOffset) == false)
+            {
+                continue;
+            }
+
+            entries[count] = {
+                .offset = static_cast<uint32_t>(recordOffset),
+                .time = trailer.time,
+            };
+            count++;
+
+            // Next record starts right after the trailer
+            recordOffset = position + sizeof(RecordTrailer);
+            position = recordOffset - 1;
+        }
+
+        endOffset = recordOffset;
+
+        return count;
+    }
+
+    /**
+     * @brief Open the container (the first part with free index entries) and prepare it to add a record
+     * The record is written to the file by the usual file writings after that
+     *
+     * @param[out] file File to open the container in
+     * @param[in] directory Container directory
+     * @param[in] name Container name (parts have "_<part>" suffix)
+     * @return true if the container is ready to add a record, false otherwise
+     */
+    bool open(FileSD &file, const char *directory, const char *name);
+
+    /**
+     * @brief Finish the record with the index and the footer, close the container
+     *
+     * @param[in] file File of the opened container
+     * @param[in] time Epoch time of the record, seconds
+     * @return true if the index is written, false otherwise
+     */
+    bool close(FileSD &file, uint32_t time);
+} // namespace Measurements::ResultContainer
@@ -0,0 +1,151 @@
+/**
+ * @file ResultCsv.h
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Text (CSV) measurements result format, shared by the firmware and the host record converter
+ * @version 0.1
+ * @date 2024-09-02
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <FloatFormat.hpp>
+
+namespace Measurements::ResultCsv
+{
+    // Session type names by the session type code (0 timer, 1 motion, 2 short)
+    constexpr const char *sessionNames[] = {"Timer", "Motion", "Short"};
+
+    /**
+     * @brief Get the name of the session type
+     *
+     * @param[in] session Session type code
+     * @return Session type name (timer one for unknown codes)
+     */
+    inline const char *getSessionName(uint8_t session)
+    {
+        return (session < sizeof(sessionNames) / sizeof(*sessionNames)) ? sessionNames[session] : sessionNames[0];
+    }
+
+    /**
+     * @brief Result header structure
+     */
+    struct Header
+    {
+        const char *firmware;        // Firmware version string
+        uint16_t batteryVoltage;     // Battery voltage, millivolts
+        uint8_t batteryLevel;        // Battery level, percents
+        uint8_t startTime[6];        // Measurement start: second, minute, hour, day, month, year (since 1970)
+        uint16_t loggingRate;        // Nominal sampling frequency, Hz
+        double measuredRate;         // Measured sampling frequency, Hz
+        double sampleClockPpm;       // Measured sampling frequency error, ppm
+        double timerDriftPpm;        // System timer drift against RTC, ppm (NaN if not estimated)
+        uint8_t session;             // Measurement session type code
+        bool isLightSleep;           // Automatic light sleep was active during the measurement
+        uint32_t samples;            // Number of acquired samples
+        uint32_t missedDeadlines;    // Number of missed sampling deadlines
+        uint32_t duplicatedSamples;  // Number of duplicated samples
+        uint32_t readFailures;       // Number of IMU reading failures
+        uint32_t fifoOverflows;      // Number of IMU FIFO overflows
+        uint32_t invalidPackets;     // Number of skipped IMU FIFO packets
+        uint32_t droppedSegments;    // Number of dropped segments
+        uint32_t batchIntervalMaxUs; // Maximum mean interval between the samples of one batch, microseconds
+        float intervalMeanUs;        // Mean interval between samples, microseconds
+        uint16_t segmentSize;        // PSD segment size, samples
+        uint16_t binCount;           // Number of bins of every PSD channel
+    };
+
+    /**
+     * @brief Result channel structure
+     */
+    struct Channel
+    {
+        const char *name;     // Channel name
+        const char *units;    // Channel units
+        double maximum;       // Maximum value
+        double minimum;       // Minimum value
+        double mean;          // Mean value
+        double deviation;     // Standard deviation
+        const double *psd;    // PSD bins (nullptr if the channel has statistics only)
+        double coreFrequency; // Core (maximum amplitude) bin frequency, Hz
+        double coreAmplitude; // Core (maximum amplitude) bin amplitude
+    };
+
+    /**
+     * @brief Write result header and channels as text
+     *
+     * @tparam Output Output with printf, println and format (@ref FileSD interface)
+     * @param[in] output Output to write to
+     * @param[in] header Result header
+     * @param[in] channels Result channels
+     * @param[in] channelCount Number of result channels
+     */
+    template <typename Output>
+    void write(Output &output, const Header &header, const Channel *channels, size_t channelCount)
+    {
+        output.printf("FW %s\r\n", header.firmware);
+
+        // File header
+        float batteryVoltage = static_cast<float>(header.batteryVoltage) / 1000;
+        output.printf("BATT %.1fV\r\n", batteryVoltage);
+        output.printf("BATT %u%%\r\n", header.batteryLevel);
+        output.printf("START_TIME %u/%u/%u %u:%u:%u\r\n",
+                      header.startTime[3], header.startTime[4], header.startTime[5],
+                      header.startTime[2], header.startTime[1], header.startTime[0]);
+        output.printf("Logging Rate,%u\r\n", header.loggingRate);
+        output.printf("Measured Rate,%.4f\r\n", header.measuredRate);
+        output.printf("Sample Clock Error (ppm),%.0f\r\n", header.sampleClockPpm);
+        if (isnan(header.timerDriftPpm) == false)
+        {
+            output.printf("Timer Drift (ppm),%.1f\r\n", header.timerDriftPpm);
+        }
+        output.printf("Session,%s\r\n", getSessionName(header.session));
+        output.printf("Light Sleep,%u\r\n", header.isLightSleep);
+        output.printf("Samples,%u\r\n", header.samples);
+        output.printf("Missed Deadlines,%u\r\n", header.missedDeadlines);
+        output.printf("Duplicated Samples,%u\r\n", header.duplicatedSamples);
+        output.printf("Read Failures,%u\r\n", header.readFailures);
+        output.printf("FIFO Overflows,%u\r\n", header.fifoOverflows);
+        output.printf("Invalid Packets,%u\r\n", header.invalidPackets);
+        output.printf("Dropped Segments,%u\r\n", header.droppedSegments);
+        output.printf("Max Batch Mean Interval (us),%u\r\n", header.batchIntervalMaxUs);
+        output.printf("Mean Sample Interval (us),%.1f\r\n", header.intervalMeanUs);
+        output.println(""); // End of header
+
+        for (size_t channel = 0; channel < channelCount; channel++)
+        {
+            const Channel &result = channels[channel];
+
+            output.printf("Channel Name,%s\r\n", result.name);
+            output.printf("Channel Units,%s\r\n", result.units);
+            output.printf("Maximum,%G\r\n", result.maximum);
+            output.printf("Minimum,%G\r\n", result.minimum);
+            output.printf("Mean,%G\r\n", result.mean);
+            output.printf("Standard Deviation,%G\r\n", result.deviation);
+            if (result.psd != nullptr)
+            {
+                output.printf("Core Frequency (%dpt PSD),%G,%G\r\n", header.segmentSize, result.coreFrequency, result.coreAmplitude);
+                output.printf("PSD_%d_%d", header.binCount, header.segmentSize);
+                for (size_t idx = 0; idx < header.binCount; idx++)
+                {
+                    // Bins are the bulk of the file, format them without printf
+                    output.format(FloatFormat::lengthMax + 1,
+                                  [bin = result.psd[idx]](char *string)
+                                  {
+                                      string[0] = ',';
+                                      return 1 + FloatFormat::formatG(&string[1], bin);
+                                  });
+                }
+                output.println(""); // End of PSD
+            }
+            output.println(""); // End of channel
+        }
+    }
+} // namespace Measurements::ResultCsv
@@ -58,6 +58,8 @@ namespace Serials
         virtual void start() override
         {
             _serial.begin(serialBaudrate);
+            // Uart end() drops the receive callback, set it again on every start
+            _serial.onReceive(_receiveHandler);
             _serial.setPins(pinRx, pinTx);
 
             // Esp32 resets rxEnablePin pin mode after uart restart
@@ -108,7 +110,19 @@ namespace Serials
             return _serial.write(buffer, size);
         }
 
+        /**
+         * @brief Set the handler called when new data is received
+         *
+         * @param handler Handler function
+         */
+        virtual void onReceive(ReceiveHandler handler) override
+        {
+            _receiveHandler = handler;
+            _serial.onReceive(_receiveHandler);
+        }
+
     private:
-        HardwareSerial &_serial; ///< Reference to uart hardware serial interface object
+        HardwareSerial &_serial;        ///< Reference to uart hardware serial interface object
+        ReceiveHandler _receiveHandler; ///< Data received handler
     };
 } // namespace Serials
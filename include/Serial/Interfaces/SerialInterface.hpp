@@ -2,6 +2,8 @@
 
 #include <stddef.h>
 
+#include <functional>
+
 namespace Serials
 {
 /**
@@ -9,6 +11,11 @@ namespace Serials
  */
 struct SerialInterface
 {
+    /**
+     * @brief Data received handler function type
+     */
+    using ReceiveHandler = std::function<void()>;
+
     /**
      * @brief Initialize serial interface (pins, interfaces)
      */
@@ -52,5 +59,13 @@ struct SerialInterface
      * @param size Size of transmitted data
      */
     virtual size_t write(const char *buffer, size_t size) = 0;
+
+    /**
+     * @brief Set the handler called when new data is received
+     * Handler is called from the receiving task, not from the interrupt
+     *
+     * @param handler Handler function
+     */
+    virtual void onReceive(ReceiveHandler handler) = 0;
 };
 } // namespace Serials
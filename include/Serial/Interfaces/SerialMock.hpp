@@ -73,5 +73,14 @@ public:
     {
         return 0;
     }
+
+    /**
+     * @brief Set the handler called when new data is received
+     *
+     * @param handler Handler function
+     */
+    virtual void onReceive(ReceiveHandler handler) override
+    {
+    }
 };
 } // namespace Serials
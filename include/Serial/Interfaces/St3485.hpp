@@ -63,6 +63,8 @@ namespace Serials
         virtual void start() override
         {
             _serial.begin(serialBaudrate);
+            // Uart end() drops the receive callback, set it again on every start
+            _serial.onReceive(_receiveHandler);
             _serial.setPins(pinRx, pinTx);
 
             // Switch RS485 transceiver into receiver mode
@@ -121,7 +123,19 @@ namespace Serials
             return txSize;
         }
 
+        /**
+         * @brief Set the handler called when new data is received
+         *
+         * @param handler Handler function
+         */
+        virtual void onReceive(ReceiveHandler handler) override
+        {
+            _receiveHandler = handler;
+            _serial.onReceive(_receiveHandler);
+        }
+
     private:
-        HardwareSerial &_serial; ///< Reference to uart hardware serial interface object
+        HardwareSerial &_serial;        ///< Reference to uart hardware serial interface object
+        ReceiveHandler _receiveHandler; ///< Data received handler
     };
 } // namespace Serials
@@ -48,6 +48,8 @@ namespace Serials
         virtual void start() override
         {
             _serial.begin(serialBaudrate);
+            // Uart end() drops the receive callback, set it again on every start
+            _serial.onReceive(_receiveHandler);
         }
 
         /**
@@ -89,7 +91,19 @@ namespace Serials
             return _serial.write(buffer, size);
         }
 
+        /**
+         * @brief Set the handler called when new data is received
+         *
+         * @param handler Handler function
+         */
+        virtual void onReceive(ReceiveHandler handler) override
+        {
+            _receiveHandler = handler;
+            _serial.onReceive(_receiveHandler);
+        }
+
     private:
-        HardwareSerial &_serial; ///< Reference to usb serial interface object
+        HardwareSerial &_serial;        ///< Reference to usb serial interface object
+        ReceiveHandler _receiveHandler; ///< Data received handler
     };
 } // namespace Serials
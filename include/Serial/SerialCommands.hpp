@@ -43,6 +43,20 @@ namespace Serials
         LogLevel,         // 10: Set/Get serial debug log level
         FwVersion,        // 11: Get FW version information
         BatteryStatus,    // 12: Get battery status
+        AcquisitionMode,  // 13: Set/Get the IMU acquisition mode (0 polling, 1 FIFO, 2 data ready IRQ, 3 FIFO threshold IRQ)
+        SamplingHealth,   // 14: Get sampling health counters
+        SessionMode,      // 15: Set/Get the measurement session mode (0 timer, 1 wake on motion)
+        WomThreshold,     // 16: Set/Get the wake on motion threshold, mg
+        ShortInterval,    // 17: Set/Get the interval of short (no motion) measurements, 0 to skip them
+        PowerMode,        // 18: Set/Get the power mode of measurements (0 performance, 1 light sleep), get adds light sleep activity
+        ActiveTime,       // 19: Get active time of measurement tasks, percents
+        TemperatureCompensation, // 20: Set/Get accel temperature compensation (axis slope offset), LSB
+        ResultFormat,     // 21: Set/Get the result file format (0 CSV, 1 binary float32, 2 binary log16, 3 binary compressed)
+        RawCapture,       // 22: Set/Get raw samples capture state (1 enable, 0 disable)
+        StorageLayout,    // 23: Set/Get the result storage layout (0 file per measurement, 1 daily container)
+        PsdResolution,    // 24: Set/Get the resolution of the compressed PSD bins (0.01 dB units, 1..255)
+        StorageStats,     // 25: Get result storage queue depth and write latency
+        Journaling,       // 26: Set/Get journaled result writing state (1 enable, 0 disable)
 
         Commands // Total number of serial commands
     };
@@ -124,6 +138,76 @@ namespace Serials
             .string = "BATT",
             .accessMask = AccessMask::read,
         },
+        {
+            .id = CommandId::AcquisitionMode,
+            .string = "ACQM",
+            .accessMask = AccessMask::read | AccessMask::write,
+        },
+        {
+            .id = CommandId::SamplingHealth,
+            .string = "HLTH",
+            .accessMask = AccessMask::read,
+        },
+        {
+            .id = CommandId::SessionMode,
+            .string = "SESM",
+            .accessMask = AccessMask::read | AccessMask::write,
+        },
+        {
+            .id = CommandId::WomThreshold,
+            .string = "WOMT",
+            .accessMask = AccessMask::read | AccessMask::write,
+        },
+        {
+            .id = CommandId::ShortInterval,
+            .string = "SINT",
+            .accessMask = AccessMask::read | AccessMask::write,
+        },
+        {
+            .id = CommandId::PowerMode,
+            .string = "PWRM",
+            .accessMask = AccessMask::read | AccessMask::write,
+        },
+        {
+            .id = CommandId::ActiveTime,
+            .string = "ACTV",
+            .accessMask = AccessMask::read,
+        },
+        {
+            .id = CommandId::TemperatureCompensation,
+            .string = "TCMP",
+            .accessMask = AccessMask::read | AccessMask::write,
+        },
+        {
+            .id = CommandId::ResultFormat,
+            .string = "RFMT",
+            .accessMask = AccessMask::read | AccessMask::write,
+        },
+        {
+            .id = CommandId::RawCapture,
+            .string = "RAWC",
+            .accessMask = AccessMask::read | AccessMask::write,
+        },
+        {
+            .id = CommandId::StorageLayout,
+            .string = "STOR",
+            .accessMask = AccessMask::read | AccessMask::write,
+        },
+        {
+            .id = CommandId::PsdResolution,
+            .string = "PRES",
+            .accessMask = AccessMask::read | AccessMask::write,
+        },
+        {
+            .id = CommandId::StorageStats,
+            .string = "STST",
+            .accessMask = AccessMask::read,
+        },
+        {
+            .id = CommandId::Journaling,
+            .string = "JRNL",
+            .accessMask = AccessMask::read | AccessMask::write,
+        },
     };
     static_assert(sizeof(commandsList) / sizeof(*commandsList) == static_cast<size_t>(CommandId::Commands),
                   "Commands list doesn't match to commands count!");
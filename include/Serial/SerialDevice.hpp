@@ -89,6 +89,13 @@ public:
      */
     void stop();
 
+    /**
+     * @brief Set the handler called when new data is received by the serial interface
+     *
+     * @param handler Handler function
+     */
+    void onReceive(SerialInterface::ReceiveHandler handler);
+
     /**
      * @brief Print data to serial device
      *
@@ -43,6 +43,11 @@ namespace Serials
      */
     using CommandNotifyHandler = std::function<void(CommandType)>;
 
+    /**
+     * @brief Data received handler function type
+     */
+    using ReceiveHandler = SerialInterface::ReceiveHandler;
+
     namespace Manager
     {
         /**
@@ -57,6 +62,14 @@ namespace Serials
          */
         void process();
 
+        /**
+         * @brief Set the handler called when any serial device receives new data
+         * Lets the main loop sleep until the input comes instead of polling devices
+         *
+         * @param handler Handler function
+         */
+        void onReceive(ReceiveHandler &&handler);
+
         /**
          * @brief Subscribe to specified read command to provide read data
          * May be only one subscriber that provides read data
@@ -40,12 +40,12 @@
 #define PROGMEM
 #define pgm_read_byte(addr) (*(const unsigned char *)(addr))
 #define pgm_read_word(addr) ({ \
-	typeof(addr) _addr = (addr); \
+	__typeof__(addr) _addr = (addr); \
 	*(const unsigned short *)(_addr); \
 })
 #define pgm_read_dword(addr) ({ \
-	typeof(addr) _addr = (addr); \
-	*(const unsigned long *)(_addr); \
+	__typeof__(addr) _addr = (addr); \
+	*(const uint32_t *)(_addr); \
 })
 #endif
 
@@ -0,0 +1,236 @@
+/**
+ * @file FloatFormat.cpp
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Fast floating point to text formatting implementation
+ * @version 0.1
+ * @date 2024-09-04
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include "FloatFormat.hpp"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+
+namespace
+{
+    // Number of significant digits ("%G" default precision)
+    constexpr int precision = 6;
+    // The smallest mantissa with all the significant digits
+    constexpr int64_t mantissaMin = 100000;
+    // The largest mantissa with all the significant digits
+    constexpr int64_t mantissaMax = 999999;
+    // The largest exactly representable power of ten in double
+    constexpr int powerExactMax = 22;
+    // Relative distance to the rounding tie that scaling error may cross (a few ulps of double)
+    constexpr double tieTolerance = 1e-15;
+
+    // Exactly representable powers of ten
+    constexpr double powersOfTen[powerExactMax + 1] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    /**
+     * @brief Scale value to the mantissa of significant digits for the decimal exponent
+     * Only one correctly rounded operation is used, so the result matches the exact decimal rounding
+     * except for values within a few ulps of the rounding tie (they are rejected)
+     *
+     * @param[in] value Absolute value
+     * @param[in] exponent Decimal exponent of the first significant digit
+     * @param[out] mantissa Mantissa rounded to integer
+     * @return true if the mantissa is exact, false if the exponent is out of the exact range or the value is at the tie
+     */
+    bool scale(double value, int exponent, int64_t &mantissa)
+    {
+        int shift = precision - 1 - exponent;
+        if (shift > powerExactMax || shift < -powerExactMax)
+        {
+            return false;
+        }
+
+        double scaled = (shift >= 0) ? value * powersOfTen[shift] : value / powersOfTen[-shift];
+
+        // Scaling error could move the value across the rounding tie, exact decimal rounding is required there
+        double fraction = scaled - floor(scaled);
+        if (fabs(fraction - 0.5) <= scaled * tieTolerance)
+        {
+            return false;
+        }
+
+        mantissa = llround(scaled);
+
+        return true;
+    }
+
+    /**
+     * @brief Write digits of the mantissa without trailing zeros of the fraction
+     *
+     * @param[out] string Output string
+     * @param[in] digits Mantissa digits
+     * @param[in] integerCount Number of digits before the decimal point
+     * @return Length of the written string
+     */
+    size_t writeDigits(char *string, const char *digits, int integerCount)
+    {
+        int last = precision - 1;
+        while (last >= integerCount && digits[last] == '0')
+        {
+            last--;
+        }
+
+        size_t length = 0;
+        for (int idx = 0; idx <= last; idx++)
+        {
+            if (idx == integerCount)
+            {
+                string[length++] = '.';
+            }
+            string[length++] = digits[idx];
+        }
+
+        return length;
+    }
+
+    /**
+     * @brief Write all digits of the mantissa as fraction without trailing zeros
+     *
+     * @param[out] string Output string
+     * @param[in] digits Mantissa digits
+     * @return Length of the written string
+     */
+    size_t writeFraction(char *string, const char *digits)
+    {
+        int last = precision - 1;
+        while (last > 0 && digits[last] == '0')
+        {
+            last--;
+        }
+
+        size_t length = 0;
+        for (int idx = 0; idx <= last; idx++)
+        {
+            string[length++] = digits[idx];
+        }
+
+        return length;
+    }
+
+    /**
+     * @brief Format value by the library printf "%G" (for values the fast path doesn't cover)
+     *
+     * @param[out] string Output string
+     * @param[in] value Value to format
+     * @return Length of the formatted string
+     */
+    size_t formatLibrary(char *string, double value)
+    {
+        char buffer[FloatFormat::lengthMax + 1];
+        int count = snprintf(buffer, sizeof(buffer), "%G", value);
+        for (int idx = 0; idx < count; idx++)
+        {
+            string[idx] = buffer[idx];
+        }
+
+        return count;
+    }
+} // namespace
+
+/**
+ * @brief Format value with 6 significant digits in the same way as printf "%G"
+ * The string isn't zero terminated
+ *
+ * @param[out] string Output string (at least @ref lengthMax characters)
+ * @param[in] value Value to format
+ * @return Length of the formatted string
+ */
+size_t FloatFormat::formatG(char *string, double value)
+{
+    size_t length = 0;
+
+    if (isfinite(value) == false)
+    {
+        return formatLibrary(string, value);
+    }
+
+    if (signbit(value))
+    {
+        string[length++] = '-';
+        value = -value;
+    }
+
+    if (value == 0)
+    {
+        string[length++] = '0';
+        return length;
+    }
+
+    // Estimate decimal exponent from the binary one, then correct it by the rounded mantissa
+    int binaryExponent;
+    frexp(value, &binaryExponent);
+    int exponent = static_cast<int>(floor((binaryExponent - 1) * 0.30102999566398120));
+
+    int64_t mantissa = 0;
+    bool isExact = scale(value, exponent, mantissa);
+    while (isExact == true && mantissa > mantissaMax)
+    {
+        exponent++;
+        isExact = scale(value, exponent, mantissa);
+    }
+    while (isExact == true && mantissa < mantissaMin)
+    {
+        exponent--;
+        isExact = scale(value, exponent, mantissa);
+    }
+
+    if (isExact == false)
+    {
+        // Extreme exponents and rounding ties are rare, let the library do them
+        return length + formatLibrary(&string[length], value);
+    }
+
+    char digits[precision];
+    for (int idx = precision - 1; idx >= 0; idx--)
+    {
+        digits[idx] = '0' + mantissa % 10;
+        mantissa /= 10;
+    }
+
+    if (exponent >= -4 && exponent < precision)
+    {
+        // Fixed notation
+        if (exponent >= 0)
+        {
+            length += writeDigits(&string[length], digits, exponent + 1);
+        }
+        else
+        {
+            // All the digits are the fraction after the leading zeros
+            string[length++] = '0';
+            string[length++] = '.';
+            for (int idx = exponent + 1; idx < 0; idx++)
+            {
+                string[length++] = '0';
+            }
+            length += writeFraction(&string[length], digits);
+        }
+    }
+    else
+    {
+        // Scientific notation, exponent has two digits at least
+        length += writeDigits(&string[length], digits, 1);
+        string[length++] = 'E';
+        string[length++] = (exponent < 0) ? '-' : '+';
+        int exponentAbs = (exponent < 0) ? -exponent : exponent;
+        if (exponentAbs >= 100)
+        {
+            string[length++] = '0' + exponentAbs / 100;
+        }
+        string[length++] = '0' + exponentAbs / 10 % 10;
+        string[length++] = '0' + exponentAbs % 10;
+    }
+
+    return length;
+}
@@ -0,0 +1,30 @@
+/**
+ * @file FloatFormat.hpp
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Fast floating point to text formatting API
+ * @version 0.1
+ * @date 2024-09-04
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+namespace FloatFormat
+{
+    // Maximum length of the formatted value without the terminating zero ("-1.23456E-308")
+    constexpr size_t lengthMax = 13;
+
+    /**
+     * @brief Format value with 6 significant digits in the same way as printf "%G"
+     * The string isn't zero terminated
+     *
+     * @param[out] string Output string (at least @ref lengthMax characters)
+     * @param[in] value Value to format
+     * @return Length of the formatted string
+     */
+    size_t formatG(char *string, double value);
+} // namespace FloatFormat
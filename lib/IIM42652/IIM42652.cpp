@@ -403,6 +403,47 @@ bool IIM42652::get_gyro_data(IIM42652_axis_t *gyro_data)
     return result;
 }
 
+/*!
+ *  @brief  Get IIM42652 acceleration, gyroscope and optionally temperature data in one burst read.
+            Data registers are contiguous, so all values come from the same output data rate tick.
+ *  @param  accel_data	:Pointer to data of type @ IIM42652_axis_t.
+ *  @param  gyro_data	:Pointer to data of type @ IIM42652_axis_t.
+ *  @param  temperature	:Pointer to temperature variable or nullptr if not needed.
+ *  @return true if succeed, false otherwise.
+ */
+bool IIM42652::get_accel_gyro_data(IIM42652_axis_t *accel_data, IIM42652_axis_t *gyro_data, float *temperature)
+{
+    uint8_t rx_buf[14];
+
+    // Temperature registers precede accel data, read them only if requested
+    uint8_t *data = (temperature != nullptr) ? &rx_buf[0] : &rx_buf[2];
+    uint8_t registerAddress = (temperature != nullptr) ? IIM42652_REG_TEMP_DATA1_UI : IIM42652_REG_ACCEL_DATA_X1_UI;
+    uint8_t size = (temperature != nullptr) ? 14 : 12;
+
+    bool result = readRegister(registerAddress, data, size);
+    if (result == true)
+    {
+        if (temperature != nullptr)
+        {
+            int16_t tmp = (int16_t)((rx_buf[0] << 8) | rx_buf[1]);
+
+            *temperature = (float)tmp;
+            *temperature /= 132.48;
+            *temperature += 25;
+        }
+
+        accel_data->x = (int16_t)((rx_buf[2] << 8) | rx_buf[3]);
+        accel_data->y = (int16_t)((rx_buf[4] << 8) | rx_buf[5]);
+        accel_data->z = (int16_t)((rx_buf[6] << 8) | rx_buf[7]);
+
+        gyro_data->x = (int16_t)((rx_buf[8] << 8) | rx_buf[9]);
+        gyro_data->y = (int16_t)((rx_buf[10] << 8) | rx_buf[11]);
+        gyro_data->z = (int16_t)((rx_buf[12] << 8) | rx_buf[13]);
+    }
+
+    return result;
+}
+
 /*!
  *  @brief  Get IIM42652 temperature data.
  *  @param  temperature	:Pointer to temperature variable.
@@ -512,6 +553,23 @@ bool IIM42652::set_gyro_frequency(const IIM42652_GYRO_CONFIG0_ODR_t frequency)
     return result;
 }
 
+/*!
+ *  @brief  Set IIM42652 ACCEL and GYRO UI filter bandwidth.
+ *  @param  accel_bw	:Accel bandwidth value. Reference@ IIM42652_GYRO_ACCEL_CONFIG0_ACCEL_FILT_BW_t.
+ *  @param  gyro_bw	:Gyro bandwidth value. Reference@ IIM42652_GYRO_ACCEL_CONFIG0_GYRO_FILT_BW_t.
+ *  @return true if succeed, false otherwise.
+ */
+bool IIM42652::set_filter_bandwidth(IIM42652_GYRO_ACCEL_CONFIG0_ACCEL_FILT_BW_t accel_bw,
+                                    IIM42652_GYRO_ACCEL_CONFIG0_GYRO_FILT_BW_t gyro_bw)
+{
+    // Both bandwidths share one register, write them at once
+    uint8_t gyro_accel_cfg_0_reg = (uint8_t)accel_bw | (uint8_t)gyro_bw;
+
+    bool result = writeRegister(IIM42652_REG_GYRO_ACCEL_CONFIG0, &gyro_accel_cfg_0_reg, 1);
+
+    return result;
+}
+
 /*!
  *  @brief  Get WOM interrupt flag, clears on read.
  *  @param  data the value in register INT_STATUS2.
@@ -700,3 +758,236 @@ bool IIM42652::get_pedometer_data(uint16_t &data)
 
     return result;
 }
+
+/*!
+ *  @brief  Configure FIFO in stream mode with accel + gyro packets (packet 3).
+ *  @param  watermark	:FIFO watermark, packets. Should be greater than zero.
+ *  @return true if succeed, false otherwise.
+ */
+bool IIM42652::fifo_configuration(uint16_t watermark)
+{
+    uint8_t data[2];
+
+    // FIFO should be in bypass mode while configuring
+    bool result = fifo_disable();
+    if (result == true)
+    {
+        data[0] = BIT_FIFO_CONFIG1_ACCEL_EN | BIT_FIFO_CONFIG1_GYRO_EN | BIT_FIFO_CONFIG1_TEMP_EN |
+                  BIT_FIFO_CONFIG1_WM_GT_TH;
+
+        result = writeRegister(IIM42652_REG_FIFO_CONFIG1, data, 1);
+    }
+
+    if (result == true)
+    {
+        // Watermark is expressed in bytes since FIFO count is in bytes by default
+        uint16_t watermarkBytes = watermark * IIM42652_FIFO_PACKET_SIZE;
+
+        data[0] = (uint8_t)(watermarkBytes & 0xFF);
+        data[1] = (uint8_t)((watermarkBytes >> 8) & BIT_FIFO_CONFIG3_WM_MASK);
+
+        result = writeRegister(IIM42652_REG_FIFO_CONFIG2, data, 2);
+    }
+
+    if (result == true)
+    {
+        result = fifo_flush();
+    }
+
+    if (result == true)
+    {
+        data[0] = IIM42652_FIFO_CONFIG_MODE_STREAM;
+
+        result = writeRegister(IIM42652_REG_FIFO_CONFIG, data, 1);
+    }
+
+    LIB_LOG("fifo_configuration", "watermark = %d packets", watermark);
+
+    return result;
+}
+
+/*!
+ *  @brief  Disable FIFO (bypass mode).
+ *  @param  NULL.
+ *  @return true if succeed, false otherwise.
+ */
+bool IIM42652::fifo_disable(void)
+{
+    uint8_t tmp = IIM42652_FIFO_CONFIG_MODE_BYPASS;
+
+    bool result = writeRegister(IIM42652_REG_FIFO_CONFIG, &tmp, 1);
+
+    return result;
+}
+
+/*!
+ *  @brief  Flush FIFO content.
+ *  @param  NULL.
+ *  @return true if succeed, false otherwise.
+ */
+bool IIM42652::fifo_flush(void)
+{
+    uint8_t tmp = BIT_SIGNAL_PATH_RESET_FIFO_FLUSH;
+
+    bool result = writeRegister(IIM42652_REG_SIGNAL_PATH_RESET, &tmp, 1);
+
+    // Flush takes effect within 1.5us
+    delayMicroseconds(2);
+
+    return result;
+}
+
+/*!
+ *  @brief  Get number of bytes stored in FIFO.
+ *  @param  count	:Pointer to FIFO count variable, bytes.
+ *  @return true if succeed, false otherwise.
+ */
+bool IIM42652::get_fifo_count(uint16_t *count)
+{
+    uint8_t rx_buf[2];
+
+    // Both bytes are read in one transaction, count is latched on FIFO_COUNTH reading
+    bool result = readRegister(IIM42652_REG_FIFO_COUNTH, rx_buf, 2);
+    if (result == true)
+    {
+        *count = rx_buf[0];
+        *count <<= 8;
+        *count |= rx_buf[1];
+    }
+
+    return result;
+}
+
+/*!
+ *  @brief  Read FIFO content. Reading is split into chunks of IIM42652_FIFO_READ_CHUNK bytes.
+ *  @param  data	:Pointer to data buffer.
+ *  @param  size	:Number of bytes to read (whole packets).
+ *  @return true if succeed, false otherwise.
+ */
+bool IIM42652::read_fifo_data(uint8_t *data, uint16_t size)
+{
+    bool result = true;
+
+    while (size > 0 && result == true)
+    {
+        uint8_t chunk = (size > IIM42652_FIFO_READ_CHUNK) ? IIM42652_FIFO_READ_CHUNK : size;
+
+        // FIFO data register address isn't incremented, each read pops the next FIFO byte
+        result = readRegister(IIM42652_REG_FIFO_DATA, data, chunk);
+
+        data += chunk;
+        size -= chunk;
+    }
+
+    return result;
+}
+
+/*!
+ *  @brief  Parse FIFO packet 3.
+ *  @param  data	:Pointer to raw packet data (IIM42652_FIFO_PACKET_SIZE bytes).
+ *  @param  packet	:Pointer to data of type @ IIM42652_fifo_packet_t.
+ *  @return true if packet contains valid accel and gyro data, false otherwise.
+ */
+bool IIM42652::parse_fifo_packet(const uint8_t *data, IIM42652_fifo_packet_t *packet)
+{
+    uint8_t header = data[0];
+
+    // Empty FIFO or packet without accel/gyro data
+    if ((header & BIT_FIFO_HEADER_MSG) ||
+        (header & (BIT_FIFO_HEADER_ACCEL | BIT_FIFO_HEADER_GYRO)) != (BIT_FIFO_HEADER_ACCEL | BIT_FIFO_HEADER_GYRO))
+    {
+        return false;
+    }
+
+    packet->accel.x = (int16_t)((data[1] << 8) | data[2]);
+    packet->accel.y = (int16_t)((data[3] << 8) | data[4]);
+    packet->accel.z = (int16_t)((data[5] << 8) | data[6]);
+    packet->gyro.x = (int16_t)((data[7] << 8) | data[8]);
+    packet->gyro.y = (int16_t)((data[9] << 8) | data[10]);
+    packet->gyro.z = (int16_t)((data[11] << 8) | data[12]);
+    packet->temperature = (int8_t)data[13];
+    packet->timestamp = (uint16_t)((data[14] << 8) | data[15]);
+
+    // Sensor data isn't available yet
+    return (packet->accel.x != IIM42652_FIFO_INVALID_DATA && packet->gyro.x != IIM42652_FIFO_INVALID_DATA);
+}
+
+/*!
+ *  @brief  Configure INT1 pin as push-pull, active high output and route interrupt sources to it.
+ *  @param  sources	:INT_SOURCE0 sources mask (eg: BIT_INT_SOURCE0_UI_DRDY_INT1_EN).
+ *  @param  latched	:Latched output held until the status is read (eg: for wake up), pulsed otherwise.
+ *  @return true if succeed, false otherwise.
+ */
+bool IIM42652::int1_configuration(uint8_t sources, bool latched)
+{
+    uint8_t data;
+
+    bool result = readRegister(IIM42652_REG_INT_CONFIG, &data, 1);
+    if (result == true)
+    {
+        data &= ~BIT_INT_CONFIG_INT1_MASK;
+        data |= BIT_INT_CONFIG_INT1_DRIVE_PUSH_PULL | BIT_INT_CONFIG_INT1_POLARITY_HIGH;
+        if (latched == true)
+        {
+            data |= BIT_INT_CONFIG_INT1_MODE_LATCHED;
+        }
+
+        result = writeRegister(IIM42652_REG_INT_CONFIG, &data, 1);
+    }
+
+    if (result == true)
+    {
+        result = readRegister(IIM42652_REG_INT_CONFIG1, &data, 1);
+    }
+
+    if (result == true)
+    {
+        // Default asynchronous reset should be cleared for proper INT pin operation
+        data &= ~BIT_INT_CONFIG1_ASYNC_RESET;
+
+        result = writeRegister(IIM42652_REG_INT_CONFIG1, &data, 1);
+    }
+
+    if (result == true)
+    {
+        data = sources;
+
+        result = writeRegister(IIM42652_REG_INT_SOURCE0, &data, 1);
+    }
+
+    if (result == true)
+    {
+        // Clear pending interrupt status
+        result = get_int_status(&data);
+    }
+
+    LIB_LOG("int1_configuration", "sources = 0x%X, latched = %d", sources, latched);
+
+    return result;
+}
+
+/*!
+ *  @brief  Disable all INT_SOURCE0 interrupts on INT1 pin.
+ *  @param  NULL.
+ *  @return true if succeed, false otherwise.
+ */
+bool IIM42652::int1_disable(void)
+{
+    uint8_t tmp = 0;
+
+    bool result = writeRegister(IIM42652_REG_INT_SOURCE0, &tmp, 1);
+
+    return result;
+}
+
+/*!
+ *  @brief  Get interrupt status, reading clears the status bits.
+ *  @param  status	:Pointer to INT_STATUS variable (eg: BIT_INT_STATUS_DATA_RDY).
+ *  @return true if succeed, false otherwise.
+ */
+bool IIM42652::get_int_status(uint8_t *status)
+{
+    bool result = readRegister(IIM42652_REG_INT_STATUS, status, 1);
+
+    return result;
+}
@@ -641,6 +641,100 @@ typedef enum
   IIM42652_SMD_CONFIG_SMD_MODE_DISABLED = 0x00,
 } IIM42652_SMD_CONFIG_SMD_MODE_t;
 
+/*
+ * MPUREG_FIFO_CONFIG
+ * Register Name: FIFO_CONFIG
+ */
+
+/* FIFO_MODE */
+#define BIT_FIFO_CONFIG_MODE_POS 6
+#define BIT_FIFO_CONFIG_MODE_MASK (0x03 << BIT_FIFO_CONFIG_MODE_POS)
+
+typedef enum
+{
+  IIM42652_FIFO_CONFIG_MODE_STOP_ON_FULL = (0x02 << BIT_FIFO_CONFIG_MODE_POS),
+  IIM42652_FIFO_CONFIG_MODE_STREAM = (0x01 << BIT_FIFO_CONFIG_MODE_POS),
+  IIM42652_FIFO_CONFIG_MODE_BYPASS = (0x00 << BIT_FIFO_CONFIG_MODE_POS),
+} IIM42652_FIFO_CONFIG_MODE_t;
+
+/*
+ * MPUREG_FIFO_CONFIG1
+ * Register Name: FIFO_CONFIG1
+ */
+#define BIT_FIFO_CONFIG1_RESUME_PARTIAL_RD 0x40
+#define BIT_FIFO_CONFIG1_WM_GT_TH 0x20
+#define BIT_FIFO_CONFIG1_HIRES_EN 0x10
+#define BIT_FIFO_CONFIG1_TMST_FSYNC_EN 0x08
+#define BIT_FIFO_CONFIG1_TEMP_EN 0x04
+#define BIT_FIFO_CONFIG1_GYRO_EN 0x02
+#define BIT_FIFO_CONFIG1_ACCEL_EN 0x01
+
+/*
+ * MPUREG_FIFO_CONFIG3
+ * Register Name: FIFO_CONFIG3
+ */
+#define BIT_FIFO_CONFIG3_WM_MASK 0x0F
+
+/*
+ * MPUREG_SIGNAL_PATH_RESET
+ * Register Name: SIGNAL_PATH_RESET
+ */
+#define BIT_SIGNAL_PATH_RESET_FIFO_FLUSH 0x02
+
+/*
+ * MPUREG_INT_CONFIG
+ * Register Name: INT_CONFIG
+ */
+#define BIT_INT_CONFIG_INT1_MODE_LATCHED 0x04
+#define BIT_INT_CONFIG_INT1_DRIVE_PUSH_PULL 0x02
+#define BIT_INT_CONFIG_INT1_POLARITY_HIGH 0x01
+#define BIT_INT_CONFIG_INT1_MASK 0x07
+
+/*
+ * MPUREG_INT_CONFIG1
+ * Register Name: INT_CONFIG1
+ */
+#define BIT_INT_CONFIG1_TPULSE_DURATION 0x40
+#define BIT_INT_CONFIG1_TDEASSERT_DISABLE 0x20
+#define BIT_INT_CONFIG1_ASYNC_RESET 0x10
+
+/*
+ * MPUREG_INT_STATUS
+ * Register Name: INT_STATUS
+ */
+#define BIT_INT_STATUS_UI_FSYNC 0x40
+#define BIT_INT_STATUS_PLL_RDY 0x20
+#define BIT_INT_STATUS_RESET_DONE 0x10
+#define BIT_INT_STATUS_DATA_RDY 0x08
+#define BIT_INT_STATUS_FIFO_THS 0x04
+#define BIT_INT_STATUS_FIFO_FULL 0x02
+#define BIT_INT_STATUS_AGC_RDY 0x01
+
+/*
+ * FIFO packet header
+ */
+#define BIT_FIFO_HEADER_MSG 0x80
+#define BIT_FIFO_HEADER_ACCEL 0x40
+#define BIT_FIFO_HEADER_GYRO 0x20
+#define BIT_FIFO_HEADER_20 0x10
+
+/**
+ * @brief FIFO packet 3 (header + accel + gyro + temperature + timestamp) size, bytes
+ */
+#define IIM42652_FIFO_PACKET_SIZE 16
+/**
+ * @brief FIFO capacity, bytes
+ */
+#define IIM42652_FIFO_SIZE 2048
+/**
+ * @brief Maximum FIFO bytes fetched in one I2C transaction (fits Wire buffer, whole packets only)
+ */
+#define IIM42652_FIFO_READ_CHUNK (8 * IIM42652_FIFO_PACKET_SIZE)
+/**
+ * @brief Invalid sensor data value in FIFO packet (sensor isn't ready)
+ */
+#define IIM42652_FIFO_INVALID_DATA (-32768)
+
 /* Interrupt enum state for INT1, INT2, and IBI */
 typedef enum
 {
@@ -680,6 +774,19 @@ typedef struct
 
 } IIM42652_axis_t;
 
+/**
+ * @brief   6DOF IMU FIFO packet structure object.
+ * @details FIFO packet 3 content (accel + gyro + temperature + timestamp).
+ */
+typedef struct
+{
+  IIM42652_axis_t accel;
+  IIM42652_axis_t gyro;
+  int8_t temperature;
+  uint16_t timestamp;
+
+} IIM42652_fifo_packet_t;
+
 /**
  * @brief   6DOF IMU configuration structure object.
  * @details Gyro configuration structure object definition of 6DOF IMU driver.
@@ -727,17 +834,32 @@ public:
   bool soft_reset(void);
   bool get_accel_data(IIM42652_axis_t *accel_data);
   bool get_gyro_data(IIM42652_axis_t *gyro_data);
+  bool get_accel_gyro_data(IIM42652_axis_t *accel_data, IIM42652_axis_t *gyro_data, float *temperature = nullptr);
   bool get_temperature(float *temperature);
   bool set_accel_fsr(IIM42652_ACCEL_CONFIG0_FS_SEL_t accel_fsr_g);
   bool set_accel_frequency(const IIM42652_ACCEL_CONFIG0_ODR_t frequency);
   bool set_gyro_fsr(IIM42652_GYRO_CONFIG0_FS_SEL_t gyro_fsr_dps);
   bool set_gyro_frequency(const IIM42652_GYRO_CONFIG0_ODR_t frequency);
+  bool set_filter_bandwidth(IIM42652_GYRO_ACCEL_CONFIG0_ACCEL_FILT_BW_t accel_bw,
+                            IIM42652_GYRO_ACCEL_CONFIG0_GYRO_FILT_BW_t gyro_bw);
 
   void wake_on_motion_configuration(const uint8_t x_th, const uint8_t y_th, const uint8_t z_th);
   bool get_WOM_INT(uint8_t &data);
   void enable_accel_low_power_mode(void);
   void pedometer_configuration();
   bool get_pedometer_data(uint16_t &data);
+
+  bool fifo_configuration(uint16_t watermark);
+  bool fifo_disable(void);
+  bool fifo_flush(void);
+  bool get_fifo_count(uint16_t *count);
+  bool read_fifo_data(uint8_t *data, uint16_t size);
+  static bool parse_fifo_packet(const uint8_t *data, IIM42652_fifo_packet_t *packet);
+
+  bool int1_configuration(uint8_t sources, bool latched = false);
+  bool int1_disable(void);
+  bool get_int_status(uint8_t *status);
+
   bool writeRegister(uint8_t registerAddress, uint8_t *writeData, uint8_t size);
   bool readRegister(uint8_t registerAddress, uint8_t *readData, uint8_t size);
 
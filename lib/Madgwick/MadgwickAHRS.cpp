@@ -21,6 +21,8 @@
 
 #include "MadgwickAHRS.h"
 #include <math.h>
+#include <stdint.h>
+#include <string.h>
 
 //-------------------------------------------------------------------------------------------
 // Definitions
@@ -231,9 +233,10 @@ void Madgwick::updateIMU(float gx, float gy, float gz, float ax, float ay, float
 float Madgwick::invSqrt(float x) {
 	float halfx = 0.5f * x;
 	float y = x;
-	long i = *(long*)&y;
+	int32_t i;
+	memcpy(&i, &y, sizeof(i)); // Bit copy of the float, long is 64-bit on hosts
 	i = 0x5f3759df - (i>>1);
-	y = *(float*)&i;
+	memcpy(&y, &i, sizeof(y));
 	y = y * (1.5f - (halfx * y * y));
 	y = y * (1.5f - (halfx * y * y));
 	return y;
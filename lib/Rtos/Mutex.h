@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stddef.h>
+
+#include <assert.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+namespace RTOS
+{
+    /**
+     * @brief Mutex class to guard data shared between tasks
+     * @warning Mutex cannot be used from an interrupt
+     */
+    class Mutex
+    {
+    public:
+        /**
+         * @brief Construct a new Mutex object
+         */
+        Mutex()
+        {
+            _mutexHandle = xSemaphoreCreateMutexStatic(&_mutexBuffer);
+            assert(_mutexHandle);
+        }
+
+        /**
+         * @brief Lock mutex
+         *
+         * @param[in] timeout Waiting timeout, OS ticks
+         * @return true if locking succeed, false if timeout
+         */
+        bool lock(TickType_t timeout = portMAX_DELAY)
+        {
+            auto result = xSemaphoreTake(_mutexHandle, timeout);
+
+            return (result == pdTRUE);
+        }
+
+        /**
+         * @brief Unlock mutex
+         */
+        void unlock()
+        {
+            xSemaphoreGive(_mutexHandle);
+        }
+
+    private:
+        SemaphoreHandle_t _mutexHandle; // Mutex's handle
+        StaticSemaphore_t _mutexBuffer; // Mutex's static data structure
+    };
+} // namespace RTOS
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <assert.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+
+namespace RTOS
+{
+    /**
+     * @brief Queue class to send/receive items by copy
+     *
+     * @tparam Type Item type
+     * @tparam Length Maximum number of items in the queue
+     */
+    template <typename Type, size_t Length>
+    class Queue
+    {
+    public:
+        /**
+         * @brief Construct a new Queue object
+         */
+        Queue()
+        {
+            _queueHandle = xQueueCreateStatic(Length, sizeof(Type), _queueStorage, &_queueBuffer);
+            assert(_queueHandle);
+        }
+
+        /**
+         * @brief Send item to the back of the queue from task context
+         *
+         * @param[in] item Item to send
+         * @param[in] timeout Waiting for free space timeout, OS ticks
+         * @return true if sending succeed, false otherwise
+         */
+        bool send(const Type &item, TickType_t timeout = 0)
+        {
+            auto result = xQueueSend(_queueHandle, &item, timeout);
+
+            return (result == pdPASS);
+        }
+
+        /**
+         * @brief Receive item from the front of the queue
+         *
+         * @param[out] item Received item
+         * @param[in] timeout Waiting for item timeout, OS ticks
+         * @return true if receiving succeed, false if timeout
+         */
+        bool receive(Type &item, TickType_t timeout = portMAX_DELAY)
+        {
+            auto result = xQueueReceive(_queueHandle, &item, timeout);
+
+            return (result == pdPASS);
+        }
+
+        /**
+         * @brief Get number of items in the queue
+         *
+         * @return Number of items
+         */
+        size_t count() const
+        {
+            return uxQueueMessagesWaiting(_queueHandle);
+        }
+
+    private:
+        QueueHandle_t _queueHandle;                  // Queue's handle
+        StaticQueue_t _queueBuffer;                  // Queue's static data structure
+        uint8_t _queueStorage[Length * sizeof(Type)]; // Queue's items storage
+    };
+} // namespace RTOS
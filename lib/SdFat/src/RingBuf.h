@@ -183,7 +183,7 @@ class RingBuf : public Print {
    * \return Actual count of bytes read.
    */
   size_t read(void* buf, size_t count) {
-    size_t n = bytesFree();
+    size_t n = bytesUsed();
     if (count > n) {
       count = n;
     }
@@ -3,6 +3,8 @@
 #include <assert.h>
 
 #include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
 #include <TimeLib.h>
 
 #include <Debug.hpp>
@@ -15,8 +17,116 @@ namespace SystemTime
         constexpr uint32_t epochYear = 1970;
         constexpr uint8_t monthCount = 12;
 
+        // System timer microseconds per RTC second
+        constexpr int64_t microsPerSecond = 1000000;
+        // Uncertainty of the RTC second rollover time the search stops at, microseconds
+        constexpr int64_t rolloverResolutionUs = 1000;
+        // Minimum delay of the next RTC reading of the rollover search, microseconds
+        constexpr int64_t rolloverReadDelayMinUs = 1000;
+
+        /**
+         * @brief RTC second rollover search: the rollover to the second is after the low time and not after the high one,
+         * the next rollovers are whole seconds later (the timer drift over the search is far below the resolution)
+         */
+        struct RolloverSearch
+        {
+            time_t second;  // Epoch time the RTC rolls over to
+            int64_t lowUs;  // System timer time known before the rollover, microseconds
+            int64_t highUs; // System timer time known after the rollover, microseconds
+            time_t shift;   // Seconds the pending RTC reading is shifted from the searched rollover by
+        };
+
         TwoWire *pWire = nullptr; // Reference to I2C device
 
+        // RTC reading timer of the rollover search
+        esp_timer_handle_t rolloverTimer = nullptr;
+        // Current rollover search (valid if it is started)
+        RolloverSearch rolloverSearch = {0};
+        // Rollover search is started
+        bool isRolloverSearch = false;
+        // The first and the last found rollovers since the tracking start (zero time if none is found yet)
+        RolloverReference firstRollover = {0};
+        RolloverReference lastRollover = {0};
+        // Found rollovers lock
+        portMUX_TYPE rolloverLock = portMUX_INITIALIZER_UNLOCKED;
+
+        /**
+         * @brief Timer callback of the RTC second rollover tracking, reads RTC once and narrows down the rollover time
+         * Every reading halves the time range of the rollover, the reading is shifted by whole seconds to the future
+         *
+         * @param arg Callback argument
+         */
+        void readRollover(void *arg)
+        {
+            (void *)arg;
+
+            int64_t timeUs = esp_timer_get_time();
+            time_t time;
+            bool result = RTC::getRtcTime(*pWire, time);
+            if (result == true && isRolloverSearch == true)
+            {
+                RolloverSearch &search = rolloverSearch;
+                int64_t phaseUs = timeUs - search.shift * microsPerSecond;
+                time_t second = search.second + search.shift;
+                if (time == second)
+                {
+                    search.highUs = (phaseUs < search.highUs) ? phaseUs : search.highUs;
+                }
+                else if (time == second - 1)
+                {
+                    search.lowUs = (phaseUs > search.lowUs) ? phaseUs : search.lowUs;
+                }
+                else
+                {
+                    // RTC time is changed, the search is restarted
+                    isRolloverSearch = false;
+                }
+
+                if (isRolloverSearch == true && search.highUs - search.lowUs <= rolloverResolutionUs)
+                {
+                    RolloverReference rollover = {
+                        .timerUs = (search.lowUs + search.highUs) / 2 + search.shift * microsPerSecond,
+                        .time = second,
+                    };
+
+                    portENTER_CRITICAL(&rolloverLock);
+                    if (firstRollover.time == 0)
+                    {
+                        firstRollover = rollover;
+                    }
+                    lastRollover = rollover;
+                    portEXIT_CRITICAL(&rolloverLock);
+
+                    isRolloverSearch = false;
+                }
+            }
+
+            if (result == true && isRolloverSearch == false)
+            {
+                // The reading is within the RTC second, the next rollover is within a second after it
+                rolloverSearch = {
+                    .second = time + 1,
+                    .lowUs = timeUs,
+                    .highUs = timeUs + microsPerSecond,
+                    .shift = 0,
+                };
+                isRolloverSearch = true;
+            }
+
+            int64_t delayUs = microsPerSecond;
+            if (isRolloverSearch == true)
+            {
+                // The middle of the range at the nearest second in the future
+                RolloverSearch &search = rolloverSearch;
+                int64_t middleUs = (search.lowUs + search.highUs) / 2;
+                int64_t earliestUs = esp_timer_get_time() + rolloverReadDelayMinUs;
+                search.shift = (middleUs < earliestUs) ? (earliestUs - middleUs + microsPerSecond - 1) / microsPerSecond : 0;
+                delayUs = middleUs + search.shift * microsPerSecond - esp_timer_get_time();
+            }
+
+            esp_timer_start_once(rolloverTimer, delayUs);
+        }
+
         /**
          * @brief Provide time from RTC for synchronization
          *
@@ -136,6 +246,62 @@ namespace SystemTime
         return result;
     }
 
+    /**
+     * @brief Start tracking of the RTC second rollovers against the system timer in the background
+     * RTC is read about once per second, a rollover is found by about ten readings to @ref rolloverResolutionUs
+     *
+     * @return true if the tracking is started, false if there is no RTC
+     */
+    bool startRolloverTracking()
+    {
+        if (pWire == nullptr)
+        {
+            return false;
+        }
+
+        if (rolloverTimer != nullptr)
+        {
+            return true;
+        }
+
+        const esp_timer_create_args_t timerArgs = {
+            .callback = readRollover,
+            .arg = nullptr,
+            .dispatch_method = ESP_TIMER_TASK,
+            .name = "rtcRollover",
+            .skip_unhandled_events = true,
+        };
+        bool result = (esp_timer_create(&timerArgs, &rolloverTimer) == ESP_OK);
+        if (result == true)
+        {
+            result = (esp_timer_start_once(rolloverTimer, rolloverReadDelayMinUs) == ESP_OK);
+        }
+
+        if (result == false)
+        {
+            LOG_ERROR("RTC second rollover tracking isn't started");
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Get the RTC second rollovers found since the tracking start, doesn't wait
+     *
+     * @param[out] first The first found rollover
+     * @param[out] last The last found rollover
+     * @return true if a rollover is found, false otherwise
+     */
+    bool getRollovers(RolloverReference &first, RolloverReference &last)
+    {
+        portENTER_CRITICAL(&rolloverLock);
+        first = firstRollover;
+        last = lastRollover;
+        portEXIT_CRITICAL(&rolloverLock);
+
+        return (first.time != 0);
+    }
+
     /**
      * @brief Set new epoch time (number of seconds that have elapsed since January 1, 1970)
      *
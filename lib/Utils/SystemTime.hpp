@@ -35,6 +35,15 @@ namespace SystemTime
         uint8_t Year;
     };
 
+    /**
+     * @brief RTC second rollover referenced to the system timer
+     */
+    struct RolloverReference
+    {
+        int64_t timerUs; // System timer time of the rollover, microseconds
+        time_t time;     // Epoch time after the rollover
+    };
+
     /**
      * @brief Initialize system time interface
      *
@@ -50,6 +59,23 @@ namespace SystemTime
      */
     bool getEpochTime(time_t &time);
 
+    /**
+     * @brief Start tracking of the RTC second rollovers against the system timer in the background
+     * RTC is read about once per second, a rollover is found by about ten readings to 1 ms
+     *
+     * @return true if the tracking is started, false if there is no RTC
+     */
+    bool startRolloverTracking();
+
+    /**
+     * @brief Get the RTC second rollovers found since the tracking start, doesn't wait
+     *
+     * @param[out] first The first found rollover
+     * @param[out] last The last found rollover
+     * @return true if a rollover is found, false otherwise
+     */
+    bool getRollovers(RolloverReference &first, RolloverReference &last);
+
     /**
      * @brief Set new epoch time (number of seconds that have elapsed since January 1, 1970)
      *
@@ -181,6 +181,9 @@ void Board::setupLED()
  */
 void Board::powerUp()
 {
+    // Release power pin state held during the deep sleep with IMU wake up
+    gpio_hold_dis(static_cast<gpio_num_t>(Vext_CTRL));
+
     pinMode(Vext_CTRL, OUTPUT);
     // LOW - power up, HIGH - power down
     digitalWrite(Vext_CTRL, LOW);
@@ -199,18 +202,37 @@ void Board::powerDown()
  * @brief Goes into deep sleep mode and wait wake up events
  * @warning This function never returns
  *
- * @param sleepDuration Time to sleep, seconds
+ * @param sleepDuration Time to sleep, seconds (0 - no timer wake up)
+ * @param wakeOnImu Wake up on IMU INT1 pin too (IMU stays powered)
  */
-void Board::deepSleep(size_t sleepDuration)
+void Board::deepSleep(size_t sleepDuration, bool wakeOnImu)
 {
-    LOG_INFO("Entering into sleep mode, wake up in %u seconds", sleepDuration);
+    LOG_INFO("Entering into sleep mode, wake up in %u seconds, wake on IMU %d", sleepDuration, wakeOnImu);
+
+    uint64_t ext1WakeupMask = 1ULL << pinPhotoDiode;
+    if (wakeOnImu == true)
+    {
+        ext1WakeupMask |= 1ULL << ImuConfig::pinInt1;
+    }
 
-    esp_sleep_enable_ext1_wakeup(1 << pinPhotoDiode, ESP_EXT1_WAKEUP_ANY_HIGH);
+    esp_sleep_enable_ext1_wakeup(ext1WakeupMask, ESP_EXT1_WAKEUP_ANY_HIGH);
     esp_sleep_enable_ext0_wakeup(Serials::Max3221::pinRx, LOW);
-    esp_sleep_enable_timer_wakeup(secondsToMicros(sleepDuration));
+    if (sleepDuration > 0)
+    {
+        esp_sleep_enable_timer_wakeup(secondsToMicros(sleepDuration));
+    }
 
-    // Power down the board
-    powerDown();
+    if (wakeOnImu == true)
+    {
+        // Keep the board powered for IMU to watch the motion
+        gpio_hold_en(static_cast<gpio_num_t>(Vext_CTRL));
+        gpio_deep_sleep_hold_en();
+    }
+    else
+    {
+        // Power down the board
+        powerDown();
+    }
 
     // Hold gpio pins
     holdPinsDeepSleep();
@@ -218,3 +240,30 @@ void Board::deepSleep(size_t sleepDuration)
     esp_deep_sleep_start();
     // Never reachable
 }
+
+/**
+ * @brief Check if the board is woken up from the deep sleep by IMU INT1 pin
+ *
+ * @return true if woken up by IMU, false otherwise
+ */
+bool Board::isWokenByImu()
+{
+    bool result = false;
+
+    if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_EXT1)
+    {
+        result = (esp_sleep_get_ext1_wakeup_status() & (1ULL << ImuConfig::pinInt1)) != 0;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Check if the board is woken up from the deep sleep by timer
+ *
+ * @return true if woken up by timer, false otherwise
+ */
+bool Board::isWokenByTimer()
+{
+    return (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER);
+}
@@ -12,9 +12,14 @@
 #include "FileSD.hpp"
 
 #include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
 #include <string.h>
 
 #include <Debug.hpp>
+#include <FastCRC.h>
+#include <freertos/task.h>
+#include <Mutex.h>
 
 namespace
 {
@@ -23,29 +28,368 @@ namespace
 
     // Delimiter of directory and filename
     const char *directoryDelimiter = "/";
-    // Logs files extension
-    const char *fileExtension = "csv";
+    // Number of cached directory handles (result and raw directories of the current and previous days)
+    constexpr size_t directoryCacheSize = 4;
+    // Maximum length of the cached directory path
+    constexpr size_t directoryPathMaxLength = 40;
 
     // Bytes to megabytes ratio
     constexpr size_t sectorsToMbFactor = 2 * 1024;
     // SD card types
     const char *cardTypeNames[] = {"None", "MMC", "SD", "SDHC/SDXC", "Unknown"};
 
+    // Mount task priority (the lowest above idle, the card init waits for the card mostly)
+    constexpr UBaseType_t mountTaskPriority = 1;
+    // Mount task stack size, bytes
+    constexpr uint32_t mountTaskStackSize = 4096;
+    // Mount task core
+    constexpr BaseType_t mountTaskCore = 1;
+
     // SD file system class
     SdFs sd;
+    // SD card access mutex
+    RTOS::Mutex sdMutex;
+    // Maximum SCK frequency of the card
+    uint32_t sckFrequency = 0;
+    // File system is mounted (guarded by the SD card access mutex)
+    bool isMounted = false;
+    // Duration of the last mounting, milliseconds
+    uint32_t mountDurationMs = 0;
+    // Background mounting is finished (guarded by the SD card access mutex)
+    bool isMountDone = false;
+    // Handler called when the background mounting is finished (guarded by the SD card access mutex)
+    FileSD::MountHandler mountHandler = nullptr;
+
+    /**
+     * @brief Cached directory handle structure
+     */
+    struct DirectoryEntry
+    {
+        char path[directoryPathMaxLength + 1]; // Directory path
+        FsFile handle;                         // Opened directory handle
+        uint32_t lastUse;                      // Value of the use counter on the last access (0 if not opened)
+    };
+
+    // Directory handles cache
+    DirectoryEntry directoryCache[directoryCacheSize];
+    // Counter of the cache accesses (to find the least recently used entry)
+    uint32_t directoryUseCounter = 0;
+
+    // Journal file path
+    const char *journalPath = "/JOURNAL.BIN";
+    // Journal header magic number ("JRNL")
+    constexpr uint32_t journalMagic = 0x4C4E524A;
+    // Journal sector size, the header takes the first sector and the data starts from the second one
+    constexpr size_t journalSectorSize = 512;
+    // Journal data capacity, bytes (the largest result record with the container index fits)
+    constexpr size_t journalDataSize = 128 * 1024;
+    // Journal file size, bytes
+    constexpr size_t journalFileSize = journalSectorSize + journalDataSize;
+    // Maximum length of the journal target path
+    constexpr size_t journalTargetMaxLength = 100;
+
+    /**
+     * @brief Journal states
+     */
+    enum class JournalState : uint32_t
+    {
+        Done,    // Journal data is applied to the target (or there is no data)
+        Pending, // Journal data is complete, but it may be not applied to the target yet
+    };
+
+#pragma pack(push, 1)
+    /**
+     * @brief Journal header structure
+     */
+    struct JournalHeader
+    {
+        uint32_t magic;                              // Journal header magic number @ref journalMagic
+        uint32_t state;                              // Journal state @ref JournalState
+        uint32_t sequence;                           // Sequence number of the journal commit
+        uint32_t targetOffset;                       // Length of the target file the data is added at
+        uint32_t dataSize;                           // Size of the journal data, bytes
+        uint32_t dataCrc;                            // CRC32 (PKZIP) of the journal data
+        char targetPath[journalTargetMaxLength + 1]; // Path of the target file
+        uint32_t headerCrc;                          // CRC32 (PKZIP) of the preceding header fields
+    };
+#pragma pack(pop)
+
+    // Journal file (preallocated contiguous area, its writings never update FAT or directory)
+    FsFile journal;
+    // Sequence number of the last journal commit
+    uint32_t journalSequence = 0;
+    // Files are created in the journaled mode
+    bool isJournaling = false;
+    // Journal CRC calculator
+    FastCRC32 journalCrc32;
+    // Journal data copying buffer
+    uint8_t journalSector[journalSectorSize];
+
+    /**
+     * @brief Close all cached directory handles
+     */
+    void clearDirectoryCache()
+    {
+        for (auto &entry : directoryCache)
+        {
+            if (entry.handle.isOpen())
+            {
+                entry.handle.close();
+            }
+            entry.path[0] = '\0';
+        }
+    }
+
+    /**
+     * @brief Fill the journal with zeros from its end up to the journal file size
+     * exFAT preallocation sets the data length only, the valid length (file size) stays zero and seeking beyond it fails
+     *
+     * @return true if the journal is filled, false otherwise
+     */
+    bool fillJournal()
+    {
+        memset(journalSector, 0, sizeof(journalSector));
+
+        bool result = journal.seekEnd();
+        for (uint64_t size = journal.size(); size < journalFileSize && result == true; size = journal.size())
+        {
+            size_t chunkSize = (journalFileSize - size < journalSectorSize) ? journalFileSize - size : journalSectorSize;
+            result = (journal.write(journalSector, chunkSize) == chunkSize);
+        }
+
+        if (result == true)
+        {
+            result = journal.sync();
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Open the journal file, it is created, preallocated and filled at the first time
+     *
+     * @return true if the journal is opened, false otherwise
+     */
+    bool openJournal()
+    {
+        if (journal.isOpen())
+        {
+            return true;
+        }
+
+        bool result = journal.open(journalPath, O_RDWR | O_CREAT);
+        if (result == true && journal.dataLength() == 0)
+        {
+            LOG_INFO("Journal \"%s\" isn't exist - create", journalPath);
+
+            result = journal.preAllocate(journalFileSize);
+        }
+
+        // Filled once: after the exFAT preallocation, or if power failed while filling
+        if (result == true && journal.size() < journalFileSize)
+        {
+            LOG_INFO("Journal \"%s\" has %u of %u bytes - fill", journalPath, static_cast<uint32_t>(journal.size()), journalFileSize);
+
+            result = fillJournal();
+        }
+
+        if (result == false)
+        {
+            LOG_ERROR("Journal \"%s\" isn't opened", journalPath);
+            journal.close();
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Write the journal header, the data state is changed by this single sector writing
+     *
+     * @param[in,out] header Journal header (its CRC is updated)
+     * @return true if the header is written, false otherwise
+     */
+    bool writeJournalHeader(JournalHeader &header)
+    {
+        header.headerCrc = journalCrc32.crc32(reinterpret_cast<const uint8_t *>(&header), offsetof(JournalHeader, headerCrc));
+
+        bool result = journal.seekSet(0);
+        if (result == true)
+        {
+            result = (journal.write(&header, sizeof(header)) == sizeof(header));
+        }
+        if (result == true)
+        {
+            result = journal.sync();
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Read the journal header
+     *
+     * @param[out] header Journal header
+     * @return true if the header is valid, false if the journal is empty or the header is broken
+     */
+    bool readJournalHeader(JournalHeader &header)
+    {
+        bool result = journal.seekSet(0);
+        if (result == true)
+        {
+            result = (journal.read(&header, sizeof(header)) == sizeof(header));
+        }
+        if (result == true)
+        {
+            uint32_t crc = journalCrc32.crc32(reinterpret_cast<const uint8_t *>(&header), offsetof(JournalHeader, headerCrc));
+            result = (header.magic == journalMagic && header.headerCrc == crc && header.dataSize <= journalDataSize);
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Calculate CRC of the journal data
+     *
+     * @param[in] dataSize Size of the journal data, bytes
+     * @param[out] crc CRC value (0 for no data)
+     * @return true if the data is read, false otherwise
+     */
+    bool calculateJournalCrc(size_t dataSize, uint32_t &crc)
+    {
+        crc = 0;
+
+        bool result = journal.seekSet(journalSectorSize);
+        for (size_t offset = 0; offset < dataSize && result == true; offset += journalSectorSize)
+        {
+            size_t chunkSize = (dataSize - offset < journalSectorSize) ? dataSize - offset : journalSectorSize;
+            result = (journal.read(journalSector, chunkSize) == static_cast<int>(chunkSize));
+            if (result == true)
+            {
+                crc = (offset == 0) ? journalCrc32.crc32(journalSector, chunkSize) : journalCrc32.crc32_upd(journalSector, chunkSize);
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Apply the journal data to the target file
+     * Torn tail of the target (if any) is cut at the target offset, then the whole data is written again
+     *
+     * @param[in] header Journal header
+     * @param[in] target Opened target file
+     * @return true if the data is applied, false otherwise
+     */
+    bool applyJournal(const JournalHeader &header, FsFile &target)
+    {
+        bool result = target.truncate(header.targetOffset);
+        if (result == true)
+        {
+            result = journal.seekSet(journalSectorSize);
+        }
+
+        for (size_t offset = 0; offset < header.dataSize && result == true; offset += journalSectorSize)
+        {
+            size_t chunkSize = (header.dataSize - offset < journalSectorSize) ? header.dataSize - offset : journalSectorSize;
+            result = (journal.read(journalSector, chunkSize) == static_cast<int>(chunkSize));
+            if (result == true)
+            {
+                result = (target.write(journalSector, chunkSize) == chunkSize);
+            }
+        }
+
+        if (result == true)
+        {
+            // The only directory update of the target
+            result = target.sync();
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Mount task, mounts the file system while the measurement runs and exits
+     *
+     * @param pvParameters Task parameters
+     */
+    void mountTask(void *pvParameters)
+    {
+        (void *)pvParameters;
+
+        FileSD::lock();
+        bool result = FileSD::mount();
+        isMountDone = true;
+        FileSD::MountHandler handler = mountHandler;
+        FileSD::unlock();
+
+        if (result == true)
+        {
+            LOG_INFO("SD card is ready at %u ms after boot, %u ms of mounting are off the boot path", millis(), mountDurationMs);
+        }
+
+        // Failed mounting is retried by the first access of the handler
+        if (handler != nullptr)
+        {
+            handler();
+        }
+
+        vTaskDelete(NULL);
+    }
 } // namespace
 
 /**
  * @brief Start SD file system class
+ * The card is mounted by the background task (or by the first access), so the boot doesn't wait for the card init
  *
  * @param[in] frequency Maximum SCK frequency
- * @return true if SD file system was started successfully, false otherwise
  */
-bool FileSD::startFileSystem(uint32_t frequency)
+void FileSD::startFileSystem(uint32_t frequency)
 {
     LOG_INFO("Start SD file system...");
 
-    bool result = sd.begin(pinCS, frequency);
+    sckFrequency = frequency;
+
+    xTaskCreatePinnedToCore(mountTask, "sdMount", mountTaskStackSize, NULL, mountTaskPriority, NULL, mountTaskCore);
+}
+
+/**
+ * @brief Set the handler called when the background mounting is finished (successfully or not)
+ * The handler is called right away if the mounting is already finished, so the card access it starts doesn't block.
+ * Called from the mount task (or from the caller), it must not block for long
+ *
+ * @param[in] handler Handler function
+ */
+void FileSD::onMounted(MountHandler handler)
+{
+    lock();
+    mountHandler = handler;
+    bool isDone = isMountDone;
+    unlock();
+
+    if (isDone == true && handler != nullptr)
+    {
+        handler();
+    }
+}
+
+/**
+ * @brief Mount SD file system if it isn't mounted yet.
+ * Call it under @ref lock
+ *
+ * @return true if SD file system is mounted, false otherwise
+ */
+bool FileSD::mount()
+{
+    if (isMounted == true)
+    {
+        return true;
+    }
+
+    uint32_t startMs = millis();
+
+    clearDirectoryCache();
+
+    bool result = sd.begin(pinCS, sckFrequency);
     if (result == true)
     {
         result = isCardAttached();
@@ -54,6 +398,8 @@ bool FileSD::startFileSystem(uint32_t frequency)
             uint8_t cardType = sd.card()->type();
             uint32_t cardSizeMb = sd.card()->sectorCount() / sectorsToMbFactor;
             LOG_INFO("SD card initialized: type %s, size = %dMB", cardTypeNames[cardType], cardSizeMb);
+
+            recoverJournal();
         }
         else
         {
@@ -65,17 +411,32 @@ bool FileSD::startFileSystem(uint32_t frequency)
         LOG_ERROR("SD card initialization fail!");
     }
 
+    isMounted = result;
+    mountDurationMs = millis() - startMs;
+
+    LOG_DEBUG("SD file system %s mounted in %u ms", result ? "is" : "isn't", mountDurationMs);
+
     return result;
 }
 
 /**
- * @brief Start SD file system class
+ * @brief Stop SD file system class
  */
 void FileSD::stopFileSystem()
 {
     LOG_INFO("Stop SD file system");
 
-    sd.end();
+    lock();
+
+    clearDirectoryCache();
+    journal.close();
+    if (isMounted == true)
+    {
+        sd.end();
+        isMounted = false;
+    }
+
+    unlock();
 }
 
 /**
@@ -91,13 +452,188 @@ bool FileSD::isCardAttached()
 }
 
 /**
- * @brief Get SD file system
+ * @brief Enable or disable the journaled mode of the files created after that
+ * Journaled file data is written to the preallocated journal first and applied to the file by close,
+ * so power fail leaves the file either without the data or with the whole data (after the recovery)
+ *
+ * @param[in] enable true to enable journaled mode, false to write files directly
+ */
+void FileSD::setJournaling(bool enable)
+{
+    isJournaling = enable;
+}
+
+/**
+ * @brief Get the journaled mode state, it is disabled if the journal can't be used
  *
- * @return SD file system
+ * @return true if the files are created in the journaled mode, false otherwise
+ */
+bool FileSD::getJournaling()
+{
+    return isJournaling;
+}
+
+/**
+ * @brief Recover the journal: apply the pending data (if any) to its file
+ * Time is bounded by the journal size, not by the card size
+ *
+ * @return true if there is nothing to recover or the data is recovered, false otherwise
+ */
+bool FileSD::recoverJournal()
+{
+    if (sd.exists(journalPath) == false)
+    {
+        return true;
+    }
+
+    JournalHeader header;
+    bool result = openJournal();
+    if (result == true)
+    {
+        if (readJournalHeader(header) == false)
+        {
+            LOG_DEBUG("Journal is empty");
+            return true;
+        }
+
+        journalSequence = header.sequence;
+        if (header.state != static_cast<uint32_t>(JournalState::Pending))
+        {
+            return true;
+        }
+
+        LOG_WARNING("Journal has pending data of \"%s\" (%u bytes at %u) - recover",
+                    header.targetPath, header.dataSize, header.targetOffset);
+
+        // Header is written after the data, so the data is complete if the header is valid
+        uint32_t crc = 0;
+        result = calculateJournalCrc(header.dataSize, crc) && (crc == header.dataCrc);
+        if (result == true)
+        {
+            FsFile target;
+            result = target.open(header.targetPath, O_RDWR | O_CREAT);
+            if (result == true)
+            {
+                result = applyJournal(header, target);
+                target.close();
+            }
+        }
+
+        // Don't try the broken data again on the next boot
+        header.state = static_cast<uint32_t>(JournalState::Done);
+        writeJournalHeader(header);
+    }
+
+    if (result == true)
+    {
+        LOG_INFO("Journal data of \"%s\" is recovered", header.targetPath);
+    }
+    else
+    {
+        LOG_ERROR("Journal isn't recovered");
+    }
+
+    return result;
+}
+
+/**
+ * @brief Lock SD card access, files are written by several tasks
  */
-SdFs &FileSD::sdFs()
+void FileSD::lock()
 {
-    return sd;
+    sdMutex.lock();
+}
+
+/**
+ * @brief Unlock SD card access
+ */
+void FileSD::unlock()
+{
+    sdMutex.unlock();
+}
+
+/**
+ * @brief Get cached handle of the directory, the directory is created if it doesn't exist
+ * Handles stay opened until the file system is stopped, so the path is walked once only.
+ * File system is mounted by the first call. Call it under @ref lock
+ *
+ * @param[in] directory Directory path (nested directories are separated by "/")
+ * @return Pointer to the opened directory handle, nullptr if directory can't be opened
+ */
+FsFile *FileSD::directory(const char *directory)
+{
+    assert(directory);
+    assert(strlen(directory) <= directoryPathMaxLength);
+
+    // Lazy mounting, the card isn't touched until the first file is needed
+    if (mount() == false)
+    {
+        return nullptr;
+    }
+
+    directoryUseCounter++;
+
+    DirectoryEntry *leastUsed = &directoryCache[0];
+    for (auto &entry : directoryCache)
+    {
+        if (entry.handle.isOpen() && strcmp(entry.path, directory) == 0)
+        {
+            entry.lastUse = directoryUseCounter;
+            return &entry.handle;
+        }
+
+        if (entry.handle.isOpen() == false)
+        {
+            entry.lastUse = 0;
+        }
+
+        if (entry.lastUse < leastUsed->lastUse)
+        {
+            leastUsed = &entry;
+        }
+    }
+
+    if (leastUsed->handle.isOpen())
+    {
+        LOG_DEBUG("Directory \"%s\" is evicted from cache", leastUsed->path);
+        leastUsed->handle.close();
+    }
+
+    FsFile root;
+    bool result = root.open(directoryDelimiter);
+    if (result == true)
+    {
+        result = leastUsed->handle.open(&root, directory, O_RDONLY);
+        if (result == false)
+        {
+            LOG_INFO("Directory \"%s\" isn't exist - create", directory);
+
+            result = leastUsed->handle.mkdir(&root, directory, true);
+        }
+        root.close();
+    }
+
+    if (result == false)
+    {
+        LOG_ERROR("Directory \"%s\" isn't opened or file system isn't mounted", directory);
+        return nullptr;
+    }
+
+    snprintf(leastUsed->path, sizeof(leastUsed->path), "%s", directory);
+    leastUsed->lastUse = directoryUseCounter;
+
+    return &leastUsed->handle;
+}
+
+/**
+ * @brief Destroy the SD file object, buffered data is written to the file
+ */
+FileSD::~FileSD()
+{
+    if (_file)
+    {
+        close();
+    }
 }
 
 /**
@@ -105,12 +641,14 @@ SdFs &FileSD::sdFs()
  *
  * @param directory Directory name
  * @param fileName File name
+ * @param extension File extension
  * @return True if file has been created successfully, false otherwise
  */
-bool FileSD::create(const char *directory, const char *fileName)
+bool FileSD::create(const char *directory, const char *fileName, const char *extension)
 {
     assert(directory);
     assert(fileName);
+    assert(extension);
 
     if (_file)
     {
@@ -124,29 +662,22 @@ bool FileSD::create(const char *directory, const char *fileName)
         }
     }
 
-    // Check directory and create it if needs
-    bool isDirectory = sd.exists(directory);
-    if (isDirectory == false)
-    {
-        LOG_INFO("Directory \"%s\" isn't exist - create", directory);
-
-        isDirectory = sd.mkdir(directory);
-    }
+    // Create path to new file
+    int length = snprintf(_path, sizeof(_path), "%s%s", directory, directoryDelimiter);
+    _nameOffset = length;
+    snprintf(&_path[_nameOffset], sizeof(_path) - _nameOffset, "%s.%s", fileName, extension);
 
-    if (isDirectory)
+    // Open the file relative to the cached directory, only this directory is searched for the name
+    FsFile *directoryHandle = FileSD::directory(directory);
+    if (directoryHandle != nullptr)
     {
-        // Create path to new file
-        snprintf(_path, sizeof(_path), "%s%s%s.%s", directory, directoryDelimiter, fileName, fileExtension);
+        // Open the file with append access, it is created if doesn't exist
+        _file.open(directoryHandle, &_path[_nameOffset], O_RDWR | O_CREAT | O_APPEND);
 
-        // Try to open the file with append (if exists) or O_CREAT (if doesn't exist) access
-        oflag_t oFlags = O_WRONLY | (sd.exists(_path) ? O_APPEND : O_CREAT);
-        _file = sd.open(_path, oFlags);
+        LOG_INFO("File \"%s\" %s opened on SD", _path, _file ? "is" : "isn't");
 
-        LOG_INFO("File \"%s\" %s %s on SD", _path, _file ? "is" : "isn't", (oFlags & O_CREAT) ? "created" : "opened");
-    }
-    else
-    {
-        LOG_ERROR("Directory \"%s\" isn't created or file system isn't mounted", directory);
+        startJournal();
+        alignBuffer();
     }
 
     return _file;
@@ -159,18 +690,21 @@ bool FileSD::create(const char *directory, const char *fileName)
  */
 bool FileSD::open()
 {
-    if (_file == false)
+    if (_file == false && _nameOffset > 0)
     {
-        if (sd.exists(_path))
+        char directory[pathMaxLength + 1];
+        snprintf(directory, sizeof(directory), "%.*s", static_cast<int>(_nameOffset - 1), _path);
+
+        FsFile *directoryHandle = FileSD::directory(directory);
+        if (directoryHandle != nullptr)
         {
             // Try to open file with append access (add new data at the end of the file)
-            _file = sd.open(_path, O_WRONLY | O_APPEND);
+            _file.open(directoryHandle, &_path[_nameOffset], O_RDWR | O_APPEND);
 
             LOG_INFO("File \"%s\" %s opened", _path, _file ? "is" : "isn't");
-        }
-        else
-        {
-            LOG_ERROR("File \"%s\" isn't exist to open", _path);
+
+            startJournal();
+            alignBuffer();
         }
     }
 
@@ -184,6 +718,22 @@ bool FileSD::close()
 {
     if (_file)
     {
+        bool result = flush();
+        if (result == false)
+        {
+            LOG_ERROR("File \"%s\" buffered data isn't written", _path);
+        }
+
+        if (_isJournaled == true)
+        {
+            // File is left as it was before opening if the data isn't complete
+            if (result == false || commitJournal() == false)
+            {
+                LOG_ERROR("File \"%s\" journal isn't committed", _path);
+            }
+            _isJournaled = false;
+        }
+
         _file.close();
     }
 
@@ -202,15 +752,7 @@ bool FileSD::print(const char *string)
 {
     assert(string);
 
-    bool result = false;
-
-    if (_file)
-    {
-        // Print sample data to file
-        size_t printLen = _file.print(string);
-        // Print length should be equal to string length
-        result = (printLen == strlen(string));
-    }
+    bool result = append(string, strlen(string));
 
     LOG_TRACE("String \"%s\" %s printed to file \"%s\"", string, result ? "is" : "isn't", _path);
 
@@ -227,14 +769,10 @@ bool FileSD::println(const char *string)
 {
     assert(string);
 
-    bool result = false;
-
-    if (_file)
+    bool result = append(string, strlen(string));
+    if (result == true)
     {
-        // Print sample data to file
-        size_t printLen = _file.println(string);
-        // Print length should be equal to string length + "\r\n"
-        result = (printLen == (strlen(string) + 2));
+        result = append("\r\n", 2);
     }
 
     LOG_TRACE("String \"%s\" %s printed to file \"%s\"", string, result ? "is" : "isn't", _path);
@@ -242,6 +780,62 @@ bool FileSD::println(const char *string)
     return result;
 }
 
+/**
+ * @brief Print formatted data to the file
+ *
+ * @param format Format string (printf style)
+ * @param ... Format arguments
+ * @return True if data has been added to the file, false otherwise
+ */
+bool FileSD::printf(const char *format, ...)
+{
+    assert(format);
+
+    if (!_file)
+    {
+        return false;
+    }
+
+    va_list args;
+    va_start(args, format);
+
+    // Format directly into the buffer if the string fits to the current sector
+    size_t room = _bufferLimit - _bufferLength;
+    int length = vsnprintf(reinterpret_cast<char *>(&_buffer[_bufferLength]), room, format, args);
+
+    va_end(args);
+
+    bool result = (length >= 0);
+    if (result == true)
+    {
+        if (static_cast<size_t>(length) < room)
+        {
+            _bufferLength += length;
+        }
+        else
+        {
+            // String crosses the sector boundary, format it again to split between sectors
+            char string[printfMaxLength];
+
+            va_start(args, format);
+            length = vsnprintf(string, sizeof(string), format, args);
+            va_end(args);
+
+            result = (static_cast<size_t>(length) < sizeof(string));
+            if (result == true)
+            {
+                result = append(string, length);
+            }
+            else
+            {
+                LOG_ERROR("Formatted string is too long (%d) for file \"%s\"", length, _path);
+            }
+        }
+    }
+
+    return result;
+}
+
 /**
  * @brief Write buffer to the file
  *
@@ -254,15 +848,7 @@ bool FileSD::write(const void *buffer, size_t size)
     assert(buffer);
     assert(size > 0);
 
-    bool result = false;
-
-    if (_file)
-    {
-        // Print sample data to file
-        size_t writeSize = _file.write(buffer, size);
-
-        result = (writeSize == size);
-    }
+    bool result = append(buffer, size);
 
     LOG_TRACE("Buffer size %d %s written to file \"%s\"", size, result ? "is" : "isn't", _path);
 
@@ -280,8 +866,263 @@ size_t FileSD::size()
 
     if (_file)
     {
-        fileSize = _file.size();
+        fileSize = (_isJournaled ? _targetOffset + _journalLength : _file.size()) + _bufferLength;
     }
 
     return fileSize;
 }
+
+/**
+ * @brief Read data from the file, buffered data is written first
+ *
+ * @param position Position in the file to read from
+ * @param buffer Pointer to the buffer to read to
+ * @param size Number of bytes to read
+ * @return True if all the bytes have been read, false otherwise
+ */
+bool FileSD::read(size_t position, void *buffer, size_t size)
+{
+    assert(buffer);
+
+    bool result = flush();
+    if (result == true && _isJournaled == true)
+    {
+        // Journaled data gets to the file by close only
+        result = (position + size <= _targetOffset);
+    }
+    if (result == true)
+    {
+        result = _file.seekSet(position);
+    }
+    if (result == true)
+    {
+        int readSize = _file.read(buffer, size);
+        result = (readSize == static_cast<int>(size));
+    }
+
+    LOG_TRACE("%d bytes at %d %s read from file \"%s\"", size, position, result ? "are" : "aren't", _path);
+
+    return result;
+}
+
+/**
+ * @brief Cut the file, buffered data is written first. Data is still added at the end of the file
+ *
+ * @param length New length of the file
+ * @return True if the file has been cut, false otherwise
+ */
+bool FileSD::truncate(size_t length)
+{
+    bool result = flush();
+    if (result == true && _isJournaled == true)
+    {
+        // File itself is cut by close, the journaled data after the length is dropped
+        result = (length <= _targetOffset + _journalLength);
+        if (result == true && length >= _targetOffset)
+        {
+            _journalLength = length - _targetOffset;
+        }
+        else if (result == true)
+        {
+            _targetOffset = length;
+            _journalLength = 0;
+        }
+        alignBuffer();
+    }
+    else if (result == true)
+    {
+        result = _file.truncate(length);
+        alignBuffer();
+    }
+
+    LOG_DEBUG("File \"%s\" %s cut to %d bytes", _path, result ? "is" : "isn't", length);
+
+    return result;
+}
+
+/**
+ * @brief Write buffered data to the file
+ *
+ * @return True if buffered data has been written to the file, false otherwise
+ */
+bool FileSD::flush()
+{
+    bool result = false;
+
+    if (_file)
+    {
+        result = true;
+
+        if (_bufferLength > 0)
+        {
+            result = writeData(_buffer, _bufferLength);
+
+            LOG_TRACE("Buffered %d bytes %s written to file \"%s\"", _bufferLength, result ? "are" : "aren't", _path);
+        }
+
+        _bufferLength = 0;
+        alignBuffer();
+    }
+
+    return result;
+}
+
+/**
+ * @brief Add data to the write combining buffer, the buffer is flushed when the sector is full
+ *
+ * @param data Pointer to the data
+ * @param size Number of bytes to add
+ * @return True if data has been added, false otherwise
+ */
+bool FileSD::append(const void *data, size_t size)
+{
+    if (!_file)
+    {
+        return false;
+    }
+
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    bool result = true;
+
+    while (size > 0 && result == true)
+    {
+        if (_bufferLength == 0 && _bufferLimit == bufferSize && size >= bufferSize)
+        {
+            // Buffer is empty and aligned, write whole sectors directly
+            size_t directSize = size - size % bufferSize;
+            result = writeData(bytes, directSize);
+
+            bytes += directSize;
+            size -= directSize;
+            continue;
+        }
+
+        size_t chunkSize = _bufferLimit - _bufferLength;
+        if (chunkSize > size)
+        {
+            chunkSize = size;
+        }
+
+        memcpy(&_buffer[_bufferLength], bytes, chunkSize);
+        _bufferLength += chunkSize;
+        bytes += chunkSize;
+        size -= chunkSize;
+
+        if (_bufferLength == _bufferLimit)
+        {
+            // Sector is full
+            result = flush();
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Align the buffer limit to the end of the file sector
+ */
+void FileSD::alignBuffer()
+{
+    // Files are always written at the end (created or opened with append access),
+    // journaled data is written from the beginning of the journal data sector
+    size_t position = _isJournaled ? _journalLength : _file.size();
+    _bufferLimit = bufferSize - position % bufferSize;
+}
+
+/**
+ * @brief Start the journaled mode of the opened file if it is enabled
+ */
+void FileSD::startJournal()
+{
+    _isJournaled = (isJournaling == true && openJournal() == true);
+    _targetOffset = _file.size();
+    _journalLength = 0;
+
+    if (isJournaling == true && _isJournaled == false)
+    {
+        // Not retried by every file, enabling the journaled mode again retries it
+        isJournaling = false;
+        LOG_WARNING("Journaled mode is disabled, file \"%s\" and the next files are written directly", _path);
+    }
+}
+
+/**
+ * @brief Write data to the end of the file, or to the journal in the journaled mode
+ *
+ * @param data Pointer to the data
+ * @param size Number of bytes to write
+ * @return True if data has been written, false otherwise
+ */
+bool FileSD::writeData(const void *data, size_t size)
+{
+    if (_isJournaled == false)
+    {
+        return (_file.write(data, size) == size);
+    }
+
+    bool result = (_journalLength + size <= journalDataSize);
+    if (result == true)
+    {
+        result = journal.seekSet(journalSectorSize + _journalLength);
+    }
+    if (result == true)
+    {
+        result = (journal.write(data, size) == size);
+    }
+
+    if (result == true)
+    {
+        _journalLength += size;
+    }
+    else
+    {
+        LOG_ERROR("%d bytes aren't written to journal of file \"%s\" (%d of %d bytes used)",
+                  size, _path, _journalLength, journalDataSize);
+    }
+
+    return result;
+}
+
+/**
+ * @brief Commit the journaled data: mark the journal pending, apply it to the file, mark it done
+ * Power fail before the pending mark leaves the file untouched, after it the data is applied by the recovery
+ *
+ * @return True if the data has been applied to the file, false otherwise
+ */
+bool FileSD::commitJournal()
+{
+    JournalHeader header = {
+        .magic = journalMagic,
+        .state = static_cast<uint32_t>(JournalState::Pending),
+        .sequence = journalSequence + 1,
+        .targetOffset = static_cast<uint32_t>(_targetOffset),
+        .dataSize = static_cast<uint32_t>(_journalLength),
+        .dataCrc = 0,
+        .targetPath = {0},
+        .headerCrc = 0,
+    };
+    snprintf(header.targetPath, sizeof(header.targetPath), "/%s", _path);
+
+    // Data is read back, so the CRC covers what the card really holds
+    bool result = calculateJournalCrc(header.dataSize, header.dataCrc);
+    if (result == true)
+    {
+        // Commit point: the single header sector
+        result = writeJournalHeader(header);
+    }
+    if (result == true)
+    {
+        journalSequence = header.sequence;
+        result = applyJournal(header, _file);
+    }
+    if (result == true)
+    {
+        header.state = static_cast<uint32_t>(JournalState::Done);
+        result = writeJournalHeader(header);
+    }
+
+    LOG_DEBUG("Journal %u of file \"%s\" (%u bytes at %u) %s committed",
+              header.sequence, _path, header.dataSize, header.targetOffset, result ? "is" : "isn't");
+
+    return result;
+}
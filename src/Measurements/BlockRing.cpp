@@ -0,0 +1,141 @@
+/**
+ * @file BlockRing.cpp
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Lock-free single producer single consumer ring of data blocks implementation
+ * @version 0.1
+ * @date 2024-08-26
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include "Measurements/BlockRing.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+using namespace Measurements;
+
+/**
+ * @brief Reset the ring and its statistics
+ * @warning Both producer and consumer should be stopped
+ *
+ * @param[in] slotCount Number of block slots in the ring (should be greater than zero)
+ */
+void BlockRing::reset(size_t slotCount)
+{
+    assert(slotCount > 0);
+
+    _slotCount = slotCount;
+
+    _head.store(0, std::memory_order_relaxed);
+    _tail.store(0, std::memory_order_relaxed);
+    _depthMax.store(0, std::memory_order_relaxed);
+    _overruns.store(0, std::memory_order_relaxed);
+
+    // Publish the reset state to the tasks started afterwards
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+/**
+ * @brief Get number of block slots in the ring
+ *
+ * @return Number of block slots
+ */
+size_t BlockRing::slotCount() const
+{
+    return _slotCount;
+}
+
+/**
+ * @brief Producer: acquire the slot to fill the next block
+ * Acquiring again without commit returns the same slot
+ *
+ * @param[out] slot Slot index to fill
+ * @return true if the slot is free, false if the ring is full (overrun is counted)
+ */
+bool BlockRing::acquire(size_t &slot)
+{
+    size_t head = _head.load(std::memory_order_relaxed);
+    // Acquire pairs with consumer release, the slot data isn't read anymore
+    size_t tail = _tail.load(std::memory_order_acquire);
+
+    if (head - tail >= _slotCount)
+    {
+        _overruns.store(_overruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    slot = head % _slotCount;
+
+    return true;
+}
+
+/**
+ * @brief Producer: publish the filled block to consumer
+ */
+void BlockRing::commit()
+{
+    size_t head = _head.load(std::memory_order_relaxed) + 1;
+
+    // Release makes the block data visible before the new head
+    _head.store(head, std::memory_order_release);
+
+    size_t depth = head - _tail.load(std::memory_order_relaxed);
+    if (depth > _depthMax.load(std::memory_order_relaxed))
+    {
+        _depthMax.store(depth, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Consumer: get the oldest filled block
+ *
+ * @param[out] slot Slot index of the block
+ * @return true if there is a block to consume, false otherwise
+ */
+bool BlockRing::peek(size_t &slot) const
+{
+    size_t tail = _tail.load(std::memory_order_relaxed);
+    // Acquire pairs with producer commit, the block data is visible
+    size_t head = _head.load(std::memory_order_acquire);
+
+    if (head == tail)
+    {
+        return false;
+    }
+
+    slot = tail % _slotCount;
+
+    return true;
+}
+
+/**
+ * @brief Consumer: release the consumed block slot to producer
+ */
+void BlockRing::release()
+{
+    size_t tail = _tail.load(std::memory_order_relaxed);
+
+    assert(tail != _head.load(std::memory_order_relaxed));
+
+    // Release makes sure the block data is read before the slot is given back
+    _tail.store(tail + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Get ring backpressure statistics
+ *
+ * @return Statistics
+ */
+BlockRing::Stats BlockRing::stats() const
+{
+    Stats stats;
+
+    stats.committed = _head.load(std::memory_order_acquire);
+    stats.depth = stats.committed - _tail.load(std::memory_order_acquire);
+    stats.depthMax = _depthMax.load(std::memory_order_relaxed);
+    stats.overruns = _overruns.load(std::memory_order_relaxed);
+
+    return stats;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file ImuFifo.cpp
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief IMU FIFO batch draining implementation
+ * @version 0.1
+ * @date 2024-08-14
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include "Measurements/ImuFifo.h"
+
+#include <assert.h>
+
+#include <Debug.hpp>
+
+using namespace Measurements;
+
+/**
+ * @brief Drain whole packets of the IMU FIFO in one burst and pass valid packets to the handler
+ *
+ * @param[in] imu IMU driver
+ * @param[out] buffer FIFO raw data buffer (at least IIM42652_FIFO_SIZE bytes)
+ * @param[in] handler Handler of valid packets
+ * @param[out] batch Batch statistics
+ * @return true if FIFO has been read, false if I2C reading failed (no packets are handled then)
+ */
+bool ImuFifo::drain(IIM42652 &imu, uint8_t *buffer, PacketHandler handler, Batch &batch)
+{
+    assert(buffer);
+    assert(handler);
+
+    batch = {0};
+
+    uint16_t fifoCount = 0;
+    bool result = imu.get_fifo_count(&fifoCount);
+    if (result == false)
+    {
+        return false;
+    }
+
+    if (fifoCount >= IIM42652_FIFO_SIZE)
+    {
+        // Sensor drops samples while FIFO is full, the gap is reported by the caller
+        LOG_ERROR("IMU FIFO overflow");
+        batch.isOverflow = true;
+        fifoCount = IIM42652_FIFO_SIZE;
+    }
+
+    // Read whole packets only in one burst, the partial one stays in FIFO
+    size_t packetCount = fifoCount / IIM42652_FIFO_PACKET_SIZE;
+    if (packetCount > 0)
+    {
+        result = imu.read_fifo_data(buffer, packetCount * IIM42652_FIFO_PACKET_SIZE);
+        if (result == false)
+        {
+            return false;
+        }
+    }
+
+    batch.packets = packetCount;
+
+    for (size_t idx = 0; idx < packetCount; idx++)
+    {
+        IIM42652_fifo_packet_t packet;
+
+        bool isValid = IIM42652::parse_fifo_packet(&buffer[idx * IIM42652_FIFO_PACKET_SIZE], &packet);
+        if (isValid == true)
+        {
+            handler(packet);
+            batch.stored++;
+        }
+        else
+        {
+            LOG_DEBUG("IMU FIFO packet %d is invalid", idx);
+            batch.invalid++;
+        }
+    }
+
+    LOG_TRACE("IMU FIFO drained %d packets, %d invalid", packetCount, batch.invalid);
+
+    return true;
+}
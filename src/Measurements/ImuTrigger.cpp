@@ -0,0 +1,123 @@
+/**
+ * @file ImuTrigger.cpp
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief IMU data trigger implementation
+ * @version 0.1
+ * @date 2024-08-14
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include "Measurements/ImuTrigger.h"
+
+#include <Debug.hpp>
+#include <freertos/task.h>
+
+using namespace Measurements;
+
+namespace
+{
+    // Microseconds per OS tick
+    constexpr size_t microsPerTick = 1000 * portTICK_PERIOD_MS;
+} // namespace
+
+/**
+ * @brief Construct a new IMU trigger object
+ *
+ * @param[in] eventGroup Event group of the interrupt and stop events
+ * @param[in] dataReadyEvent Event set by the interrupt handler
+ * @param[in] stopEvent Event to stop waiting
+ */
+ImuTrigger::ImuTrigger(RTOS::EventGroup &eventGroup, EventBits_t dataReadyEvent, EventBits_t stopEvent)
+    : _eventGroup(eventGroup), _dataReadyEvent(dataReadyEvent), _stopEvent(stopEvent), _useInterrupt(false),
+      _lastWakeTime(0), _periodUs(0), _carryUs(0)
+{
+}
+
+/**
+ * @brief Start schedule from the current time
+ *
+ * @param[in] intervalUs Expected interval between IMU data, microseconds
+ * @param[in] useInterrupt Wait for the interrupt event (true) or poll on the schedule only (false)
+ */
+void ImuTrigger::start(size_t intervalUs, bool useInterrupt)
+{
+    _useInterrupt = useInterrupt;
+    _periodUs = intervalUs;
+    _carryUs = 0;
+    _lastWakeTime = xTaskGetTickCount();
+}
+
+/**
+ * @brief Wait for the next IMU data
+ *
+ * @param[out] isMissed Deadline is missed: the interrupt timeout or the late schedule wake up
+ * @return Occurred data ready and stop events, zero on the timer polling wake up
+ */
+EventBits_t ImuTrigger::wait(bool &isMissed)
+{
+    EventBits_t events = 0;
+
+    isMissed = false;
+
+    if (_useInterrupt == true)
+    {
+        const EventBits_t waitEvents = _dataReadyEvent | _stopEvent;
+
+        // Returned bit mask contains all raised events, only the awaited ones are relevant
+        events = _eventGroup.wait(waitEvents, periodTicks() * interruptTimeoutFactor) & waitEvents;
+        if (events == 0)
+        {
+            LOG_ERROR("IMU interrupt timeout, fall back to the timer polling");
+            isMissed = true;
+
+            start(_periodUs, false);
+        }
+    }
+    else
+    {
+        // Wait for the next cycle, the deadline is missed if the task wasn't delayed
+        BaseType_t xWasDelayed = waitSchedule();
+        if (xWasDelayed != pdTRUE)
+        {
+            isMissed = true;
+        }
+
+        // Check if stop event occurs
+        events = _eventGroup.wait(_stopEvent, 0) & _stopEvent;
+    }
+
+    return events;
+}
+
+/**
+ * @brief Get schedule period rounded up to the OS ticks
+ *
+ * @return Period, OS ticks
+ */
+TickType_t ImuTrigger::periodTicks() const
+{
+    return (_periodUs + microsPerTick - 1) / microsPerTick;
+}
+
+/**
+ * @brief Wait for the next wake up time
+ *
+ * @return pdTRUE if the task was delayed, pdFALSE if the wake up time was missed
+ */
+BaseType_t ImuTrigger::waitSchedule()
+{
+    _carryUs += _periodUs;
+
+    TickType_t ticks = _carryUs / microsPerTick;
+    if (ticks == 0)
+    {
+        // Period is shorter than the OS tick, keep running, nothing is missed
+        return pdTRUE;
+    }
+
+    _carryUs -= ticks * microsPerTick;
+
+    return xTaskDelayUntil(&_lastWakeTime, ticks);
+}
@@ -0,0 +1,639 @@
+/**
+ * @file Kernels.cpp
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Vector reduction kernels implementation
+ * @version 0.1
+ * @date 2024-08-20
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include "Measurements/Kernels.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if __has_include(<sdkconfig.h>)
+#include <sdkconfig.h>
+#endif
+
+// ESP32-S3 SIMD (PIE): int16 kernels use the PIE instructions by inline assembly,
+// float dot product goes through the esp-dsp assembly routine
+#if defined(CONFIG_IDF_TARGET_ESP32S3)
+#define KERNELS_USE_PIE
+#endif
+#if defined(CONFIG_IDF_TARGET_ESP32S3) && __has_include(<dsps_dotprod.h>)
+#include <dsps_dotprod.h>
+#define KERNELS_USE_ESP_DSP
+#endif
+
+using namespace Measurements;
+
+namespace
+{
+    // Number of independent accumulators (breaks dependency chains, lets compiler vectorise)
+    constexpr size_t lanes = 4;
+    // Maximum elements to sum into 32-bit lanes without overflow (32767 * 65536 < 2^31)
+    constexpr size_t sumBlockMax = 65536;
+
+    /**
+     * @brief Branchless minimum of two values
+     */
+    template <typename Type>
+    inline Type lesser(Type a, Type b)
+    {
+        return (b < a) ? b : a;
+    }
+
+    /**
+     * @brief Branchless maximum of two values
+     */
+    template <typename Type>
+    inline Type greater(Type a, Type b)
+    {
+        return (a < b) ? b : a;
+    }
+
+    /**
+     * @brief Reduce the data set with the specified selector (minimum or maximum)
+     *
+     * @param[in] data Data buffer
+     * @param[in] size Data size
+     * @param[in] select Selector of two values
+     * @return Selected value
+     */
+    template <typename Type, typename Select>
+    Type reduce(const Type *data, size_t size, Select select)
+    {
+        assert(data);
+        assert(size > 0);
+
+        Type acc[lanes] = {data[0], data[0], data[0], data[0]};
+
+        size_t idx = 0;
+        for (; idx + lanes <= size; idx += lanes)
+        {
+            for (size_t lane = 0; lane < lanes; lane++)
+            {
+                acc[lane] = select(acc[lane], data[idx + lane]);
+            }
+        }
+        for (; idx < size; idx++)
+        {
+            acc[0] = select(acc[0], data[idx]);
+        }
+
+        return select(select(acc[0], acc[1]), select(acc[2], acc[3]));
+    }
+
+    /**
+     * @brief Accumulate pairwise products of two data sets
+     *
+     * @param[in] data1 The first data buffer
+     * @param[in] data2 The second data buffer
+     * @param[in] size Size of each data buffer
+     * @return Sum of pairwise products
+     */
+    template <typename Acc, typename Type>
+    Acc accumulateProducts(const Type *data1, const Type *data2, size_t size)
+    {
+        assert(data1);
+        assert(data2);
+
+        Acc acc[lanes] = {0};
+
+        // Integer products fit 32 bits after promotion, only the accumulators are widened
+        size_t idx = 0;
+        for (; idx + lanes <= size; idx += lanes)
+        {
+            for (size_t lane = 0; lane < lanes; lane++)
+            {
+                acc[lane] += data1[idx + lane] * data2[idx + lane];
+            }
+        }
+        for (; idx < size; idx++)
+        {
+            acc[0] += data1[idx] * data2[idx];
+        }
+
+        return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+    }
+
+#ifndef KERNELS_USE_PIE
+    /**
+     * @brief Sum the int16 data set in blocks of 32-bit lanes
+     *
+     * @param[in] data Data buffer
+     * @param[in] size Data size
+     * @return Sum of values
+     */
+    int64_t sumBlocks(const int16_t *data, size_t size)
+    {
+        assert(data);
+
+        int64_t result = 0;
+
+        while (size > 0)
+        {
+            size_t blockSize = (size < sumBlockMax) ? size : sumBlockMax;
+            int32_t acc[lanes] = {0};
+
+            size_t idx = 0;
+            for (; idx + lanes <= blockSize; idx += lanes)
+            {
+                for (size_t lane = 0; lane < lanes; lane++)
+                {
+                    acc[lane] += data[idx + lane];
+                }
+            }
+            for (; idx < blockSize; idx++)
+            {
+                acc[0] += data[idx];
+            }
+
+            result += static_cast<int64_t>(acc[0]) + acc[1] + acc[2] + acc[3];
+
+            data += blockSize;
+            size -= blockSize;
+        }
+
+        return result;
+    }
+#else
+    // Number of int16 lanes of the PIE vector register
+    constexpr size_t vectorLanes = 8;
+    // Alignment of the PIE vector load/store, bytes (the lower address bits are ignored by the instructions)
+    constexpr uintptr_t vectorAlign = 16;
+    // Maximum vectors to accumulate in the signed 40-bit ACCX register without overflow (32 * 8 * 2^30 = 2^38)
+    constexpr size_t accxBlockVectors = 32;
+
+    // Vector of ones to sum the data by the multiply-accumulate
+    alignas(vectorAlign) const int16_t vectorOnes[vectorLanes] = {1, 1, 1, 1, 1, 1, 1, 1};
+
+    /**
+     * @brief Get number of elements before the vector aligned address
+     *
+     * @param[in] data Data buffer
+     * @param[in] size Data size
+     * @return Number of unaligned head elements (not more than the data size)
+     */
+    size_t alignedHead(const int16_t *data, size_t size)
+    {
+        size_t head = ((vectorAlign - reinterpret_cast<uintptr_t>(data) % vectorAlign) % vectorAlign) / sizeof(*data);
+
+        return (head < size) ? head : size;
+    }
+
+    /**
+     * @brief Read the 40-bit ACCX register after the multiply-accumulate sequence
+     *
+     * @param[in] low ACCX_0 register value (bits 0..31)
+     * @param[in] high ACCX_1 register value (bits 32..39)
+     * @return Signed accumulator value
+     */
+    inline int64_t accxValue(uint32_t low, uint32_t high)
+    {
+        return static_cast<int64_t>(static_cast<int8_t>(high)) * (static_cast<int64_t>(1) << 32) + low;
+    }
+
+    /**
+     * @brief Accumulate pairwise products of aligned vectors in the ACCX register
+     *
+     * @param[in] data1 The first data buffer (vector aligned)
+     * @param[in] data2 The second data buffer (vector aligned)
+     * @param[in] vectors Number of vectors (greater than zero, not more than @ref accxBlockVectors)
+     * @return Sum of pairwise products
+     */
+    int64_t vectorProducts(const int16_t *data1, const int16_t *data2, size_t vectors)
+    {
+        uint32_t low;
+        uint32_t high;
+
+        asm volatile(
+            "ee.zero.accx\n"
+            "1:\n"
+            "ee.vld.128.ip q0, %[data1], 16\n"
+            "ee.vld.128.ip q1, %[data2], 16\n"
+            "addi %[vectors], %[vectors], -1\n"
+            "ee.vmulas.s16.accx q0, q1\n"
+            "bnez %[vectors], 1b\n"
+            "rur.accx_0 %[low]\n"
+            "rur.accx_1 %[high]\n"
+            : [data1] "+r"(data1), [data2] "+r"(data2), [vectors] "+r"(vectors), [low] "=r"(low), [high] "=r"(high)
+            :
+            : "memory");
+
+        return accxValue(low, high);
+    }
+
+    /**
+     * @brief Accumulate aligned vectors in the ACCX register (multiplied by the vector of ones)
+     *
+     * @param[in] data Data buffer (vector aligned)
+     * @param[in] vectors Number of vectors (greater than zero, not more than @ref accxBlockVectors)
+     * @return Sum of values
+     */
+    int64_t vectorSum(const int16_t *data, size_t vectors)
+    {
+        const int16_t *ones = vectorOnes;
+        uint32_t low;
+        uint32_t high;
+
+        asm volatile(
+            "ee.zero.accx\n"
+            "ee.vld.128.ip q1, %[ones], 0\n"
+            "1:\n"
+            "ee.vld.128.ip q0, %[data], 16\n"
+            "addi %[vectors], %[vectors], -1\n"
+            "ee.vmulas.s16.accx q0, q1\n"
+            "bnez %[vectors], 1b\n"
+            "rur.accx_0 %[low]\n"
+            "rur.accx_1 %[high]\n"
+            : [data] "+r"(data), [ones] "+r"(ones), [vectors] "+r"(vectors), [low] "=r"(low), [high] "=r"(high)
+            :
+            : "memory");
+
+        return accxValue(low, high);
+    }
+
+    /**
+     * @brief Select lanes of aligned vectors by the vector minimum or maximum
+     *
+     * @param[in] data Data buffer (vector aligned)
+     * @param[in] vectors Number of vectors (greater than zero)
+     * @param[in] isMax true to select maximum, false to select minimum
+     * @param[out] lanesResult Selected value of each lane (vector aligned)
+     */
+    void vectorSelect(const int16_t *data, size_t vectors, bool isMax, int16_t *lanesResult)
+    {
+        vectors--;
+
+        if (isMax == true)
+        {
+            asm volatile(
+                "ee.vld.128.ip q0, %[data], 16\n"
+                "beqz %[vectors], 2f\n"
+                "1:\n"
+                "ee.vld.128.ip q1, %[data], 16\n"
+                "addi %[vectors], %[vectors], -1\n"
+                "ee.vmax.s16 q0, q0, q1\n"
+                "bnez %[vectors], 1b\n"
+                "2:\n"
+                "ee.vst.128.ip q0, %[result], 0\n"
+                : [data] "+r"(data), [vectors] "+r"(vectors), [result] "+r"(lanesResult)
+                :
+                : "memory");
+        }
+        else
+        {
+            asm volatile(
+                "ee.vld.128.ip q0, %[data], 16\n"
+                "beqz %[vectors], 2f\n"
+                "1:\n"
+                "ee.vld.128.ip q1, %[data], 16\n"
+                "addi %[vectors], %[vectors], -1\n"
+                "ee.vmin.s16 q0, q0, q1\n"
+                "bnez %[vectors], 1b\n"
+                "2:\n"
+                "ee.vst.128.ip q0, %[result], 0\n"
+                : [data] "+r"(data), [vectors] "+r"(vectors), [result] "+r"(lanesResult)
+                :
+                : "memory");
+        }
+    }
+
+    /**
+     * @brief Reduce the int16 data set with the specified selector, the aligned body is reduced by PIE vectors
+     *
+     * @param[in] data Data buffer
+     * @param[in] size Data size
+     * @param[in] select Selector of two values
+     * @param[in] isMax true if the selector is maximum, false if it is minimum
+     * @return Selected value
+     */
+    template <typename Select>
+    int16_t reduceVector(const int16_t *data, size_t size, Select select, bool isMax)
+    {
+        assert(data);
+        assert(size > 0);
+
+        size_t head = alignedHead(data, size);
+        size_t vectors = (size - head) / vectorLanes;
+        if (vectors == 0)
+        {
+            return reduce(data, size, select);
+        }
+
+        alignas(vectorAlign) int16_t lanesResult[vectorLanes];
+        vectorSelect(&data[head], vectors, isMax, lanesResult);
+
+        int16_t result = reduce(lanesResult, vectorLanes, select);
+        if (head > 0)
+        {
+            result = select(result, reduce(data, head, select));
+        }
+
+        size_t tail = head + vectors * vectorLanes;
+        if (tail < size)
+        {
+            result = select(result, reduce(&data[tail], size - tail, select));
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Accumulate pairwise products of two int16 data sets, the aligned body is accumulated by PIE vectors
+     * The second data set is the vector of ones for nullptr (sum of the first data set)
+     *
+     * @param[in] data1 The first data buffer
+     * @param[in] data2 The second data buffer or nullptr
+     * @param[in] size Size of each data buffer
+     * @return Sum of pairwise products
+     */
+    int64_t accumulateVector(const int16_t *data1, const int16_t *data2, size_t size)
+    {
+        assert(data1);
+
+        size_t head = alignedHead(data1, size);
+        if (data2 != nullptr && alignedHead(data2, size) != head)
+        {
+            // Vectors of the data sets can't be loaded together
+            return accumulateProducts<int64_t>(data1, data2, size);
+        }
+
+        int64_t result = 0;
+        for (size_t idx = 0; idx < head; idx++)
+        {
+            result += (data2 != nullptr) ? data1[idx] * data2[idx] : data1[idx];
+        }
+
+        size_t idx = head;
+        while (size - idx >= vectorLanes)
+        {
+            size_t vectors = (size - idx) / vectorLanes;
+            if (vectors > accxBlockVectors)
+            {
+                vectors = accxBlockVectors;
+            }
+
+            result += (data2 != nullptr) ? vectorProducts(&data1[idx], &data2[idx], vectors) : vectorSum(&data1[idx], vectors);
+            idx += vectors * vectorLanes;
+        }
+
+        for (; idx < size; idx++)
+        {
+            result += (data2 != nullptr) ? data1[idx] * data2[idx] : data1[idx];
+        }
+
+        return result;
+    }
+#endif // KERNELS_USE_PIE
+
+    /**
+     * @brief Accumulate squared deviations of the float data set from the centre in double lanes
+     * Deviations are small against the values, so they are taken in single precision
+     * and only the accumulation needs double precision
+     *
+     * @param[in] data Data buffer
+     * @param[in] size Data size
+     * @param[in] centre Centre of the deviations
+     * @return Sum of squared deviations
+     */
+    double accumulateDeviations(const float *data, size_t size, float centre)
+    {
+        assert(data);
+
+        double acc[lanes] = {0};
+
+        size_t idx = 0;
+        for (; idx + lanes <= size; idx += lanes)
+        {
+            for (size_t lane = 0; lane < lanes; lane++)
+            {
+                float diff = data[idx + lane] - centre;
+                acc[lane] += diff * diff;
+            }
+        }
+        for (; idx < size; idx++)
+        {
+            float diff = data[idx] - centre;
+            acc[0] += diff * diff;
+        }
+
+        return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+    }
+} // namespace
+
+/**
+ * @brief Get the minimum of the data set
+ *
+ * @param[in] data Data buffer
+ * @param[in] size Data size (should be greater than zero)
+ * @return Minimum value
+ */
+int16_t Kernels::min(const int16_t *data, size_t size)
+{
+#ifdef KERNELS_USE_PIE
+    return reduceVector(data, size, lesser<int16_t>, false);
+#else
+    return reduce(data, size, lesser<int16_t>);
+#endif // KERNELS_USE_PIE
+}
+
+/**
+ * @brief Get the minimum of the data set
+ *
+ * @param[in] data Data buffer
+ * @param[in] size Data size (should be greater than zero)
+ * @return Minimum value
+ */
+float Kernels::min(const float *data, size_t size)
+{
+    return reduce(data, size, lesser<float>);
+}
+
+/**
+ * @brief Get the maximum of the data set
+ *
+ * @param[in] data Data buffer
+ * @param[in] size Data size (should be greater than zero)
+ * @return Maximum value
+ */
+int16_t Kernels::max(const int16_t *data, size_t size)
+{
+#ifdef KERNELS_USE_PIE
+    return reduceVector(data, size, greater<int16_t>, true);
+#else
+    return reduce(data, size, greater<int16_t>);
+#endif // KERNELS_USE_PIE
+}
+
+/**
+ * @brief Get the maximum of the data set
+ *
+ * @param[in] data Data buffer
+ * @param[in] size Data size (should be greater than zero)
+ * @return Maximum value
+ */
+float Kernels::max(const float *data, size_t size)
+{
+    return reduce(data, size, greater<float>);
+}
+
+/**
+ * @brief Get the sum of the data set
+ *
+ * @param[in] data Data buffer
+ * @param[in] size Data size
+ * @return Sum of values
+ */
+int64_t Kernels::sum(const int16_t *data, size_t size)
+{
+#ifdef KERNELS_USE_PIE
+    return accumulateVector(data, nullptr, size);
+#else
+    return sumBlocks(data, size);
+#endif // KERNELS_USE_PIE
+}
+
+/**
+ * @brief Get the sum of the data set
+ *
+ * @param[in] data Data buffer
+ * @param[in] size Data size
+ * @return Sum of values
+ */
+double Kernels::sum(const float *data, size_t size)
+{
+    assert(data);
+
+    // Single precision sum of a long segment loses the digits of the deviations
+    double acc[lanes] = {0};
+
+    size_t idx = 0;
+    for (; idx + lanes <= size; idx += lanes)
+    {
+        for (size_t lane = 0; lane < lanes; lane++)
+        {
+            acc[lane] += data[idx + lane];
+        }
+    }
+    for (; idx < size; idx++)
+    {
+        acc[0] += data[idx];
+    }
+
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+/**
+ * @brief Get the sum of squares of the data set
+ *
+ * @param[in] data Data buffer
+ * @param[in] size Data size
+ * @return Sum of squared values
+ */
+int64_t Kernels::sumSquares(const int16_t *data, size_t size)
+{
+#ifdef KERNELS_USE_PIE
+    return accumulateVector(data, data, size);
+#else
+    return accumulateProducts<int64_t>(data, data, size);
+#endif // KERNELS_USE_PIE
+}
+
+/**
+ * @brief Get the sum of squares of the data set
+ *
+ * @param[in] data Data buffer
+ * @param[in] size Data size
+ * @return Sum of squared values
+ */
+double Kernels::sumSquares(const float *data, size_t size)
+{
+    return accumulateDeviations(data, size, 0);
+}
+
+/**
+ * @brief Get the sum of squared deviations of the data set from the centre
+ * Integer sums are exact, so the deviations are expanded from them without cancellation of the rounded terms
+ *
+ * @param[in] data Data buffer
+ * @param[in] size Data size
+ * @param[in] centre Centre of the deviations (usually the mean of the data set)
+ * @return Sum of squared deviations
+ */
+double Kernels::sumSquares(const int16_t *data, size_t size, double centre)
+{
+    int64_t sumValues = sum(data, size);
+    int64_t sumValueSquares = sumSquares(data, size);
+
+    // (x - c)^2 = x^2 - 2 * c * x + c^2, the exact integer part is taken first
+    int64_t centreInteger = static_cast<int64_t>(round(centre));
+    double centreFraction = centre - centreInteger;
+    int64_t sumIntegerDeviations = sumValueSquares - 2 * centreInteger * sumValues + static_cast<int64_t>(size) * centreInteger * centreInteger;
+    double sumIntegerDifferences = static_cast<double>(sumValues - static_cast<int64_t>(size) * centreInteger);
+
+    double result = static_cast<double>(sumIntegerDeviations) - 2 * centreFraction * sumIntegerDifferences +
+                    size * centreFraction * centreFraction;
+
+    return (result > 0) ? result : 0;
+}
+
+/**
+ * @brief Get the sum of squared deviations of the data set from the centre
+ * The deviations are taken by the second (centred) pass over the data, so nothing cancels
+ *
+ * @param[in] data Data buffer
+ * @param[in] size Data size
+ * @param[in] centre Centre of the deviations (usually the mean of the data set)
+ * @return Sum of squared deviations
+ */
+double Kernels::sumSquares(const float *data, size_t size, double centre)
+{
+    return accumulateDeviations(data, size, static_cast<float>(centre));
+}
+
+/**
+ * @brief Get the dot product of two data sets
+ *
+ * @param[in] data1 The first data buffer
+ * @param[in] data2 The second data buffer
+ * @param[in] size Size of each data buffer
+ * @return Sum of pairwise products
+ */
+int64_t Kernels::dot(const int16_t *data1, const int16_t *data2, size_t size)
+{
+#ifdef KERNELS_USE_PIE
+    assert(data2);
+    return accumulateVector(data1, data2, size);
+#else
+    return accumulateProducts<int64_t>(data1, data2, size);
+#endif // KERNELS_USE_PIE
+}
+
+/**
+ * @brief Get the dot product of two data sets
+ *
+ * @param[in] data1 The first data buffer
+ * @param[in] data2 The second data buffer
+ * @param[in] size Size of each data buffer
+ * @return Sum of pairwise products
+ */
+float Kernels::dot(const float *data1, const float *data2, size_t size)
+{
+#ifdef KERNELS_USE_ESP_DSP
+    float result = 0;
+    if (size > 0)
+    {
+        dsps_dotprod_f32(data1, data2, &result, size);
+    }
+    return result;
+#else
+    return accumulateProducts<float>(data1, data2, size);
+#endif // KERNELS_USE_ESP_DSP
+}
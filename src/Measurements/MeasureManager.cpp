@@ -12,15 +12,23 @@
 #include "Measurements/MeasureManager.h"
 
 #include <assert.h>
+#include <math.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 
+#include <atomic>
+
 #include <Debug.hpp>
+#include <esp_timer.h>
+#if __has_include(<esp_pm.h>)
+#include <esp_pm.h>
+#endif
 #include <Events.h>
 #include <IIM42652.h>
-#include <MadgwickAHRS.h>
+#include <Mutex.h>
+#include <Queue.h>
 #include <SdFat.h>
 #include <SystemTime.hpp>
 #include <Wire.h>
@@ -30,10 +38,24 @@
 #include "FileSD.hpp"
 #include "FwVersion.hpp"
 #include "InternalStorage.hpp"
+#include "Measurements/BlockRing.h"
+#include "Measurements/ImuFifo.h"
+#include "Measurements/ImuTrigger.h"
+#include "Measurements/Kernels.h"
+#include "Measurements/Orientation.h"
 #include "Measurements/Psd.h"
+#include "Measurements/PsdRecord.h"
+#include "Measurements/RawCapture.h"
+#include "Measurements/ResultContainer.h"
+#include "Measurements/ResultCsv.h"
 #include "Measurements/Statistic.h"
 #include "Serial/SerialManager.hpp"
 
+// Automatic light sleep requires power management and tickless idle enabled in the framework configuration
+#if defined(CONFIG_PM_ENABLE) && defined(CONFIG_FREERTOS_USE_TICKLESS_IDLE) && defined(CONFIG_IDF_TARGET_ESP32S3)
+#define MEASUREMENTS_USE_LIGHT_SLEEP
+#endif
+
 using namespace Measurements;
 
 namespace
@@ -46,11 +68,13 @@ namespace
     constexpr uint32_t measureIntervalJitter = 5;
 
     // Default sampling frequency, Hz
-    constexpr uint8_t sampleFrequencyDefault = 40;
+    constexpr uint16_t sampleFrequencyDefault = 40;
     // Minimum sampling frequency, Hz
-    constexpr uint8_t sampleFrequencyMin = 1;
+    constexpr uint16_t sampleFrequencyMin = 1;
     // Maximum sampling frequency, Hz
-    constexpr uint8_t sampleFrequencyMax = 100;
+    constexpr uint16_t sampleFrequencyMax = 1000;
+    // Maximum sampling frequency to read IMU data registers per sample, Hz (FIFO bulk reads above)
+    constexpr uint16_t sampleFrequencyRegistersMax = 100;
 
     // Default points to calculate PSD segment size, 2^x
     constexpr uint8_t pointsPsdDefault = 8;
@@ -69,6 +93,117 @@ namespace
     // State of statistic (1 enable, 0 disable)
     constexpr uint8_t statisticStateDefault = 1;
 
+    /**
+     * @brief IMU samples acquisition modes
+     */
+    enum class AcquisitionMode : uint8_t
+    {
+        Polling,       // Sensor data registers are polled on the task schedule
+        Fifo,          // Sensor FIFO is drained in batches, sampling is clocked by the IMU output data rate
+        DataReady,     // Sensor data registers are read on the INT1 data ready interrupt
+        FifoThreshold, // Sensor FIFO is drained on the INT1 FIFO threshold interrupt
+        Count          // Total number of acquisition modes
+    };
+
+    // Default IMU acquisition mode
+    constexpr uint8_t acquisitionModeDefault = static_cast<uint8_t>(AcquisitionMode::Polling);
+
+    /**
+     * @brief Measurement session modes, define what wakes the board up after the pause
+     */
+    enum class SessionMode : uint8_t
+    {
+        Timer,        // Sessions are started by the pause interval timer
+        WakeOnMotion, // Sessions are started by IMU wake on motion, optional short sessions by the timer
+        Count         // Total number of session modes
+    };
+
+    /**
+     * @brief Types of the current measurement session
+     */
+    enum class SessionType : uint8_t
+    {
+        Timer,  // Full session started by timer, power up or user
+        Motion, // Full session started by motion
+        Short,  // Short session started by timer without motion
+    };
+
+    // Default measurement session mode
+    constexpr uint8_t sessionModeDefault = static_cast<uint8_t>(SessionMode::Timer);
+
+    // Default wake on motion threshold, mg
+    constexpr uint16_t womThresholdDefault = 50;
+    // Minimum wake on motion threshold, mg (threshold resolution is 1g/256)
+    constexpr uint16_t womThresholdMin = 4;
+    // Maximum wake on motion threshold, mg
+    constexpr uint16_t womThresholdMax = 996;
+    // Accelerometer output data rate while waiting for motion in low power mode
+    constexpr auto womAccelOdr = IIM42652_ACCEL_CONFIG0_ODR_50_HZ;
+
+    // Default time to take short measurements without motion, seconds
+    constexpr uint32_t shortIntervalDefault = 60;
+
+    /**
+     * @brief Power modes of the active measurement
+     */
+    enum class PowerMode : uint8_t
+    {
+        Performance, // CPU is always awake, all acquisition modes are available
+        LightSleep,  // IMU FIFO is drained in the largest batches, CPU goes into light sleep between them
+        Count        // Total number of power modes
+    };
+
+    // Default power mode
+    constexpr uint8_t powerModeDefault = static_cast<uint8_t>(PowerMode::Performance);
+
+    /**
+     * @brief Formats of the measurements result file
+     */
+    enum class ResultFormat : uint8_t
+    {
+        Csv,            // Text file with comma separated values
+        BinaryFloat32,  // Binary record with float32 PSD bins @ref PsdRecord
+        BinaryLog16,    // Binary record with log-quantised uint16 PSD bins @ref PsdRecord
+        BinaryLogDelta, // Binary record with log-quantised, delta coded and varint packed PSD bins @ref PsdRecord
+        Count           // Total number of result formats
+    };
+
+    // Default result format
+    constexpr uint8_t resultFormatDefault = static_cast<uint8_t>(ResultFormat::Csv);
+
+    // Default resolution of the compressed PSD bins, 0.01 dB
+    constexpr uint8_t psdResolutionDefault = 10;
+    // Minimum resolution of the compressed PSD bins, 0.01 dB
+    constexpr uint8_t psdResolutionMin = 1;
+    // Decibels per unit of the compressed PSD bins resolution
+    constexpr float psdResolutionUnitDb = 0.01;
+
+    // Default state of raw samples capture (1 enable, 0 disable)
+    constexpr uint8_t rawCaptureDefault = 0;
+
+    // Default state of journaled result writing (1 enable, 0 disable)
+    constexpr uint8_t journalingDefault = 0;
+
+    /**
+     * @brief Layouts of the measurements result storage
+     */
+    enum class StorageLayout : uint8_t
+    {
+        Files,          // File per measurement in the day subdirectory
+        DailyContainer, // Records appended to the container of the day @ref ResultContainer
+        Count           // Total number of storage layouts
+    };
+
+    // Default storage layout
+    constexpr uint8_t storageLayoutDefault = static_cast<uint8_t>(StorageLayout::Files);
+
+    // Result files directory (files are grouped to the subdirectories per day, containers are named by the day)
+    const char *resultDirectory = "PSD";
+    // Raw files directory (files are grouped to the subdirectories per day)
+    const char *rawDirectory = "RAW";
+    // Maximum length of the day subdirectory path: root + "/" + 8 date symbols
+    constexpr size_t dayDirectoryMaxLength = 16;
+
     // Settings identifier in internal storage
     constexpr auto settingsId = SettingsModules::Measurements;
 
@@ -79,6 +214,10 @@ namespace
 
     // Milliseconds per second
     constexpr size_t millisPerSecond = 1000;
+    // Microseconds per millisecond
+    constexpr size_t microsPerMilli = 1000;
+    // Microseconds per second
+    constexpr size_t microsPerSecond = microsPerMilli * millisPerSecond;
 
     // IMU axis raw value after the reset
     constexpr int16_t imuResetValue = -32768;
@@ -87,18 +226,159 @@ namespace
     // Timeout of waiting for the valid IMU axis values, milliseconds
     constexpr uint32_t imuWaitValidTimeoutMs = 100;
 
+    // Time between IMU FIFO drains, milliseconds
+    constexpr size_t imuFifoDrainIntervalMs = 100;
+    // Maximum IMU FIFO watermark, packets (a half of FIFO leaves room for the drain latency)
+    constexpr size_t imuFifoWatermarkMax = IIM42652_FIFO_SIZE / IIM42652_FIFO_PACKET_SIZE / 2;
+
+    // IMU output data rate oversampling in the polling mode, times of the sampling frequency
+    constexpr size_t imuPollingOversampling = 4;
+    // Maximum IMU UI filter bandwidth, percents of the sampling frequency (80% of Nyquist frequency)
+    constexpr size_t imuFilterBandwidthMaxPercent = 40;
+    // Lower limit of the IMU UI filter base frequency, Hz (bandwidth = max(400Hz, ODR) / divider)
+    constexpr size_t imuFilterBaseMin = 400;
+
+    // Samples ring capacity, samples (at least 4 segments of the maximum size)
+    constexpr size_t ringSamplesMax = 4 * Measurements::samplesCountMax;
+    // Maximum number of segment slots in the samples ring
+    constexpr size_t ringSlotsMax = 16;
+
+    // Temperature channel decimation, samples per temperature reading
+    constexpr size_t temperatureDecimation = 32;
+    // Temperature channel capacity, readings (segments shorter than decimation take one reading per slot)
+    constexpr size_t temperatureReadingsMax = ringSamplesMax / temperatureDecimation + ringSlotsMax;
+    // Minimum RTC time to estimate the system timer drift, seconds (references at the RTC second rollover
+    // are taken within few milliseconds, so the error is a few ppm)
+    constexpr time_t timerDriftRtcTimeMin = 1000;
+    // Maximum plausible system timer drift, ppm (larger one means RTC time is changed)
+    constexpr double timerDriftMaxPpm = 1000;
+
+    // Reference temperature of the compensation table, Celsius
+    constexpr float compensationTemperature = 25;
+    // Temperature compensation table identifier in internal storage
+    constexpr auto compensationId = SettingsModules::TemperatureCompensation;
+
+    // IMU task priority (above the analysis tasks, sampling must not be delayed by calculations)
+    constexpr UBaseType_t imuTaskPriority = 2;
+    // Analysis tasks priority (same as the loop task, so serial handling keeps its time slices)
+    constexpr UBaseType_t analysisTaskPriority = 1;
+    // Analysis tasks stack size, bytes
+    constexpr uint32_t analysisTaskStackSize = 4096;
+    // Core of the analysis task (the one of the loop task, IMU task runs on the other core)
+    constexpr BaseType_t analysisTaskCore = 1;
+    // Core of the analysis worker task
+    constexpr BaseType_t analysisWorkerCore = 0;
+    // Storage task priority (same as the loop task, serial handling and SD writing share the core time)
+    constexpr UBaseType_t storageTaskPriority = 1;
+    // Storage task stack size, bytes
+    constexpr uint32_t storageTaskStackSize = 6144;
+    // Core of the storage task
+    constexpr BaseType_t storageTaskCore = 1;
+    // Number of result snapshots (results waiting for storing and the one being stored)
+    constexpr size_t storageQueueLength = 2;
+    // Period of checking if all results are stored, milliseconds
+    constexpr uint32_t storageWaitPeriodMs = 10;
+    // Number of result channels
+    constexpr size_t resultChannelCount = 10;
+    // Number of result channels with PSD bins
+    constexpr size_t resultPsdCount = 5;
+
     namespace EventBits
     {
         constexpr EventBits_t startImu = BIT0;
         constexpr EventBits_t stopImu = BIT1;
         constexpr EventBits_t imuIdle = BIT2;
         constexpr EventBits_t imuRunning = BIT3;
-        constexpr EventBits_t segment0Ready = BIT4;
-        constexpr EventBits_t segment1Ready = BIT5;
-
-        constexpr EventBits_t all = startImu | stopImu | imuIdle | imuRunning | segment0Ready | segment1Ready;
+        constexpr EventBits_t imuDataReady = BIT4;
+        constexpr EventBits_t segmentReady = BIT5;
+        constexpr EventBits_t analysisDone = BIT6;
+        constexpr EventBits_t measureReady = BIT7;
+        constexpr EventBits_t measureSaved = BIT8;
+        constexpr EventBits_t serialReceived = BIT9;
+        constexpr EventBits_t storageMounted = BIT10;
+
+        constexpr EventBits_t all = startImu | stopImu | imuIdle | imuRunning | imuDataReady |
+                                    segmentReady | analysisDone | measureReady | measureSaved | serialReceived |
+                                    storageMounted;
     } // namespace EventBits
 
+    /**
+     * @brief Segment analysis jobs, each one is the independent part of the segment calculations
+     * Jobs are ordered by the computational cost descending, so the heavy ones are started first on both cores
+     */
+    enum class AnalysisJob : uint8_t
+    {
+        AccelResult,    // Accelerometer resultant direction, its PSD and statistic
+        Angles,         // Sensor fusion angles and their statistics
+        PsdAccX,        // Accelerometer X axis PSD
+        PsdAccY,        // Accelerometer Y axis PSD
+        GyroX,          // Gyroscope X axis PSD and statistic
+        GyroY,          // Gyroscope Y axis PSD and statistic
+        StatisticAccZ,  // Accelerometer Z axis statistic
+        StatisticGyroZ, // Gyroscope Z axis statistic
+        Count           // Total number of analysis jobs
+    };
+
+    /**
+     * @brief Sampling health events
+     */
+    enum class HealthEvent
+    {
+        MissedDeadline,   // Sampling deadline is missed (task is late or interrupt didn't come)
+        DuplicatedSample, // Previous sample is duplicated instead of the failed one
+        ReadFailure,      // IMU I2C reading failed
+        FifoOverflow,     // IMU FIFO was full, samples are lost
+        InvalidPacket,    // IMU FIFO packet is skipped (no sensor data or data isn't ready)
+    };
+
+    /**
+     * @brief Sampling health counters structure
+     */
+    struct SamplingHealth
+    {
+        uint32_t samples;            // Number of acquired samples
+        uint32_t missedDeadlines;    // Number of missed sampling deadlines
+        uint32_t duplicatedSamples;  // Number of duplicated samples
+        uint32_t readFailures;       // Number of IMU I2C reading failures
+        uint32_t fifoOverflows;      // Number of IMU FIFO overflows
+        uint32_t invalidPackets;     // Number of skipped IMU FIFO packets
+        uint32_t batchIntervalMaxUs; // Maximum mean interval between the samples of one acquisition batch, microseconds
+        uint64_t intervalSumUs;      // Sum of intervals between samples, microseconds
+        uint32_t intervalCount;      // Number of intervals in the sum
+        int64_t firstBlockUs;        // Timestamp of the first acquired block, microseconds
+        uint32_t firstBlockSamples;  // Number of samples acquired up to the first block timestamp
+        int64_t lastBlockUs;         // Timestamp of the last acquired block, microseconds
+
+        /**
+         * @brief Get mean interval between samples
+         *
+         * @return Mean interval, microseconds
+         */
+        float intervalMeanUs() const
+        {
+            return (intervalCount > 0) ? static_cast<float>(intervalSumUs) / intervalCount : 0;
+        }
+
+        /**
+         * @brief Get sampling frequency measured between the first and the last block timestamps
+         * Block timestamps mark the latest sample of the block, so the gaps before the first block are excluded
+         *
+         * @param[in] nominal Nominal sampling frequency to use if there are not enough blocks, Hz
+         * @return Measured sampling frequency by the system timer, Hz
+         */
+        double measuredFrequency(double nominal) const
+        {
+            int64_t durationUs = lastBlockUs - firstBlockUs;
+            uint32_t sampleCount = samples - firstBlockSamples;
+            if (durationUs <= 0 || sampleCount == 0)
+            {
+                return nominal;
+            }
+
+            return static_cast<double>(sampleCount) * microsPerSecond / durationUs;
+        }
+    };
+
     /**
      * @brief IMU sample structure
      */
@@ -106,6 +386,110 @@ namespace
     {
         IIM42652_axis_t accel; // IMU accel axises
         IIM42652_axis_t gyro;  // IMU gyro axises
+        float temperature;     // IMU temperature, Celsius (valid on the temperature channel samples only)
+    };
+
+    /**
+     * @brief Measurements result header structure
+     */
+    struct ResultHeader
+    {
+        SamplingHealth health;              // Sampling health counters
+        BlockRing::Stats ringStats;         // Samples ring statistics
+        double measuredFrequency;           // Measured sampling frequency, Hz
+        double sampleClockPpm;              // Measured sampling frequency error, ppm
+        bool isDriftEstimated;              // System timer drift against RTC is estimated
+        double timerDriftPpm;               // System timer drift against RTC, ppm
+        size_t resultPoints;                // Number of PSD result points
+        time_t time;                        // Epoch time of the result
+        SystemTime::DateTime startDateTime; // Measurement start date and time
+        size_t sampleFrequency;             // Nominal sampling frequency, Hz
+        size_t segmentSize;                 // PSD segment size, samples
+        SessionType session;                // Measurement session type
+        uint8_t resultFormat;               // Format of the result file @ref ResultFormat
+        uint8_t storageLayout;              // Layout of the result storage @ref StorageLayout
+        uint8_t psdResolution;              // Resolution of the compressed PSD bins, 0.01 dB
+        bool isLightSleep;                  // Automatic light sleep was active during the measurement
+    };
+
+    /**
+     * @brief Measurements result channel structure
+     */
+    struct ResultChannel
+    {
+        const char *name;             // Channel name
+        const char *units;            // Channel units
+        double maximum;               // Maximum value
+        double minimum;               // Minimum value
+        double mean;                  // Mean value
+        double deviation;             // Standard deviation
+        const double *psd;            // PSD bins (nullptr if the channel has statistics only)
+        Measurements::PsdBin coreBin; // Core (maximum amplitude) PSD bin
+    };
+
+    /**
+     * @brief Measurements result snapshot structure, immutable copy of the result handed off to the storage task
+     */
+    struct ResultSnapshot
+    {
+        ResultHeader header;                                               // Result header
+        ResultChannel channels[resultChannelCount];                        // Result channels (PSD bins point to psd)
+        double psd[resultPsdCount][Measurements::samplesCountMax / 2 + 1]; // PSD bins of the channels
+    };
+
+    /**
+     * @brief Result storage statistics structure
+     */
+    struct StorageStats
+    {
+        uint32_t stored;      // Number of stored results
+        uint32_t depthMax;    // Maximum number of results waiting for storing
+        uint32_t writeLastMs; // Time of the last result storing, milliseconds
+        uint32_t writeMaxMs;  // Maximum time of the result storing, milliseconds
+        uint64_t writeSumMs;  // Total time of the results storing, milliseconds
+        uint32_t waitMaxMs;   // Maximum time of waiting for a free snapshot, milliseconds
+    };
+
+    /**
+     * @brief IMU output data rate option
+     */
+    struct ImuOdr
+    {
+        uint16_t frequency;                    // Output data rate, Hz
+        IIM42652_ACCEL_CONFIG0_ODR_t accelOdr; // Accelerometer output data rate selection
+        IIM42652_GYRO_CONFIG0_ODR_t gyroOdr;   // Gyroscope output data rate selection
+    };
+
+    // IMU output data rates available (integer frequencies only, ascending order)
+    constexpr ImuOdr imuOdrList[] = {
+        {.frequency = 25, .accelOdr = IIM42652_ACCEL_CONFIG0_ODR_25_HZ, .gyroOdr = IIM42652_GYRO_CONFIG0_ODR_25_HZ},
+        {.frequency = 50, .accelOdr = IIM42652_ACCEL_CONFIG0_ODR_50_HZ, .gyroOdr = IIM42652_GYRO_CONFIG0_ODR_50_HZ},
+        {.frequency = 100, .accelOdr = IIM42652_ACCEL_CONFIG0_ODR_100_HZ, .gyroOdr = IIM42652_GYRO_CONFIG0_ODR_100_HZ},
+        {.frequency = 200, .accelOdr = IIM42652_ACCEL_CONFIG0_ODR_200_HZ, .gyroOdr = IIM42652_GYRO_CONFIG0_ODR_200_HZ},
+        {.frequency = 500, .accelOdr = IIM42652_ACCEL_CONFIG0_ODR_500_HZ, .gyroOdr = IIM42652_GYRO_CONFIG0_ODR_500_HZ},
+        {.frequency = 1000, .accelOdr = IIM42652_ACCEL_CONFIG0_ODR_1_KHZ, .gyroOdr = IIM42652_GYRO_CONFIG0_ODR_1_KHZ},
+    };
+
+    /**
+     * @brief IMU UI (anti-alias) filter option
+     */
+    struct ImuFilter
+    {
+        uint8_t divider;                                     // Bandwidth divider of the filter base frequency
+        IIM42652_GYRO_ACCEL_CONFIG0_ACCEL_FILT_BW_t accelBw; // Accelerometer filter bandwidth selection
+        IIM42652_GYRO_ACCEL_CONFIG0_GYRO_FILT_BW_t gyroBw;   // Gyroscope filter bandwidth selection
+    };
+
+    // IMU UI filter options (widest bandwidth first)
+    constexpr ImuFilter imuFilterList[] = {
+        {.divider = 2, .accelBw = IIM42652_GYRO_ACCEL_CONFIG0_ACCEL_FILT_BW_2, .gyroBw = IIM42652_GYRO_ACCEL_CONFIG0_GYRO_FILT_BW_2},
+        {.divider = 4, .accelBw = IIM42652_GYRO_ACCEL_CONFIG0_ACCEL_FILT_BW_4, .gyroBw = IIM42652_GYRO_ACCEL_CONFIG0_GYRO_FILT_BW_4},
+        {.divider = 5, .accelBw = IIM42652_GYRO_ACCEL_CONFIG0_ACCEL_FILT_BW_5, .gyroBw = IIM42652_GYRO_ACCEL_CONFIG0_GYRO_FILT_BW_5},
+        {.divider = 8, .accelBw = IIM42652_GYRO_ACCEL_CONFIG0_ACCEL_FILT_BW_8, .gyroBw = IIM42652_GYRO_ACCEL_CONFIG0_GYRO_FILT_BW_8},
+        {.divider = 10, .accelBw = IIM42652_GYRO_ACCEL_CONFIG0_ACCEL_FILT_BW_10, .gyroBw = IIM42652_GYRO_ACCEL_CONFIG0_GYRO_FILT_BW_10},
+        {.divider = 16, .accelBw = IIM42652_GYRO_ACCEL_CONFIG0_ACCEL_FILT_BW_16, .gyroBw = IIM42652_GYRO_ACCEL_CONFIG0_GYRO_FILT_BW_16},
+        {.divider = 20, .accelBw = IIM42652_GYRO_ACCEL_CONFIG0_ACCEL_FILT_BW_20, .gyroBw = IIM42652_GYRO_ACCEL_CONFIG0_GYRO_FILT_BW_20},
+        {.divider = 40, .accelBw = IIM42652_GYRO_ACCEL_CONFIG0_ACCEL_FILT_BW_40, .gyroBw = IIM42652_GYRO_ACCEL_CONFIG0_GYRO_FILT_BW_40},
     };
 
 #pragma pack(push, 1)
@@ -117,27 +501,59 @@ namespace
         uint32_t measureInterval; // Time for measuring, seconds
         uint32_t pauseInterval;   // Time between measurements, seconds
         uint16_t pointsCutoff;    // Points to store the PSD results
-        uint8_t frequency;        // Sampling frequency, Hz
+        uint16_t frequency;       // Sampling frequency, Hz
         uint8_t pointsPsd;        // Points to calculate PSD segment size, 2^x
         uint8_t statisticState;   // State of statistic (1 enable, 0 disable)
+        uint8_t acquisitionMode;  // IMU acquisition mode @ref AcquisitionMode
+        uint8_t sessionMode;      // Measurement session mode @ref SessionMode
+        uint16_t womThreshold;    // Wake on motion threshold, mg
+        uint32_t shortInterval;   // Time for short measuring without motion, seconds (0 - no short sessions)
+        uint8_t powerMode;        // Power mode of the active measurement @ref PowerMode
+        uint8_t resultFormat;     // Format of the result file @ref ResultFormat
+        uint8_t rawCapture;       // State of raw samples capture (1 enable, 0 disable)
+        uint8_t storageLayout;    // Layout of the result storage @ref StorageLayout
+        uint8_t psdResolution;    // Resolution of the compressed PSD bins, 0.01 dB
+        uint8_t journaling;       // State of journaled result writing (1 enable, 0 disable)
+    };
+
+    /**
+     * @brief Non volatile accelerometer temperature compensation table
+     * Bias of each axis is linear: offset + slope * (temperature - compensationTemperature)
+     */
+    struct Compensation
+    {
+        float slope[3];  // Bias slope of axises X/Y/Z, LSB per Celsius
+        float offset[3]; // Bias at the reference temperature of axises X/Y/Z, LSB
     };
 #pragma pack(pop)
 
+    // Settings with CRC8 must fit the reserved storage, the compensation table follows them
+    static_assert(sizeof(Settings) < settingsSizeList[static_cast<size_t>(settingsId)], "Settings don't fit internal storage!");
+    static_assert(sizeof(Compensation) < settingsSizeList[static_cast<size_t>(compensationId)], "Compensation doesn't fit internal storage!");
+
     /**
-     * Samples buffer structure
+     * Samples buffer structure, segments are stored in the samples ring slots
      */
     struct Buffer
     {
-        int16_t accX[2 * Measurements::samplesCountMax];
-        int16_t accY[2 * Measurements::samplesCountMax];
-        int16_t accZ[2 * Measurements::samplesCountMax];
+        int16_t accX[ringSamplesMax];
+        int16_t accY[ringSamplesMax];
+        int16_t accZ[ringSamplesMax];
+
+        int16_t gyrX[ringSamplesMax];
+        int16_t gyrY[ringSamplesMax];
+        int16_t gyrZ[ringSamplesMax];
 
-        int16_t gyrX[2 * Measurements::samplesCountMax];
-        int16_t gyrY[2 * Measurements::samplesCountMax];
-        int16_t gyrZ[2 * Measurements::samplesCountMax];
+        float temperature[temperatureReadingsMax];
+    };
 
-        float roll[2 * Measurements::samplesCountMax];
-        float pitch[2 * Measurements::samplesCountMax];
+    /**
+     * @brief System timer drift accumulation over the runs, kept in RTC memory over deep sleeps
+     */
+    struct TimerDrift
+    {
+        int64_t timerUs; // System timer time of the accumulated intervals, microseconds
+        time_t rtcTime;  // RTC time of the accumulated intervals, seconds
     };
 
     /**
@@ -151,8 +567,18 @@ namespace
         size_t segmentSize;
         // Time of segment accumulating, milliseconds
         size_t segmentTimeMs;
-        // Interval between IMU samples, milliseconds
-        size_t imuIntervalMs;
+        // Actual sampling frequency, Hz
+        size_t sampleFrequency;
+        // Interval between IMU samples, microseconds
+        size_t imuIntervalUs;
+        // IMU FIFO watermark, samples
+        size_t fifoWatermark;
+        // Temperature readings per segment
+        size_t temperatureCount;
+        // Actual IMU acquisition mode
+        AcquisitionMode acquisitionMode;
+        // Automatic light sleep is active (requested and enabled in the framework)
+        bool isLightSleep;
         // Start measurements date and time
         SystemTime::DateTime startDateTime;
 
@@ -160,9 +586,11 @@ namespace
          * @brief Setup new context
          *
          * @param[in] pointsPsd Points to calculate PSD segment size, 2^x
-         * @param[in] sampleFrequency Sampling frequency, Hz
+         * @param[in] frequency Sampling frequency, Hz
+         * @param[in] mode IMU acquisition mode
+         * @param[in] isBatched Drain IMU FIFO in the largest batches
          */
-        void setup(uint8_t pointsPsd, uint8_t sampleFrequency)
+        void setup(uint8_t pointsPsd, size_t frequency, AcquisitionMode mode, bool isBatched)
         {
             static const size_t pow2[] = {1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192};
 
@@ -172,10 +600,33 @@ namespace
             segmentCount = 0;
             // Determine segment size
             segmentSize = pow2[pointsPsd];
+            // Save actual sampling frequency
+            sampleFrequency = frequency;
+            // Save actual acquisition mode
+            acquisitionMode = mode;
             // Calculate interval between IMU samples
-            imuIntervalMs = millisPerSecond / sampleFrequency;
+            imuIntervalUs = microsPerSecond / sampleFrequency;
             // Calculate time of segment accumulating
-            segmentTimeMs = segmentSize * imuIntervalMs;
+            segmentTimeMs = segmentSize * imuIntervalUs / microsPerMilli;
+            // Calculate temperature readings per segment
+            temperatureCount = (segmentSize + temperatureDecimation - 1) / temperatureDecimation;
+
+            // Determine IMU FIFO watermark to drain FIFO every imuFifoDrainIntervalMs
+            fifoWatermark = imuFifoDrainIntervalMs * microsPerMilli / imuIntervalUs;
+            if (fifoWatermark < 1)
+            {
+                fifoWatermark = 1;
+            }
+            else if (fifoWatermark > imuFifoWatermarkMax)
+            {
+                fifoWatermark = imuFifoWatermarkMax;
+            }
+
+            if (isBatched == true)
+            {
+                // Drain FIFO as rarely as it allows, so CPU sleeps longer between batches
+                fifoWatermark = imuFifoWatermarkMax;
+            }
 
             // Obtain measurements start date and time
             SystemTime::getDateTime(startDateTime);
@@ -186,8 +637,8 @@ namespace
     IIM42652 imu;
     // SD file system class
     SdFs sd;
-    // Madgwick's IMU and AHRS filter
-    Madgwick madgwickFilter;
+    // Orientation filter of the roll/pitch angles (selected at compile time)
+    Orientation::Filter orientationFilter;
 
     // RTOS event group object
     RTOS::EventGroup eventGroup;
@@ -196,10 +647,70 @@ namespace
     Buffer buffer = {0};
     // Accelerometer resultant direction buffer
     float accelResult[Measurements::samplesCountMax];
+    // Roll angle buffer of the segment being processed
+    float angleRoll[Measurements::samplesCountMax];
+    // Pitch angle buffer of the segment being processed
+    float anglePitch[Measurements::samplesCountMax];
 
     // Current measurements context
     Context context;
 
+    // PSD bins of the binary result record being written
+    float binsFloat32[Measurements::samplesCountMax / 2 + 1];
+    uint16_t binsLog16[Measurements::samplesCountMax / 2 + 1];
+    uint8_t binsLogDelta[(Measurements::samplesCountMax / 2 + 1) * PsdRecord::logDeltaBytesMax];
+
+    // Result snapshots, owned by the loop task while free and by the storage task while queued
+    ResultSnapshot resultSnapshots[storageQueueLength];
+    // Indexes of the snapshots waiting for storing
+    RTOS::Queue<size_t, storageQueueLength> storageQueue;
+    // Indexes of the free snapshots
+    RTOS::Queue<size_t, storageQueueLength> storageFreeQueue;
+    // Result storage statistics, updated by the loop and the storage tasks
+    StorageStats storageStats = {0};
+    // Result storage statistics lock
+    portMUX_TYPE storageStatsLock = portMUX_INITIALIZER_UNLOCKED;
+
+    // Sampling health counters, updated by IMU task
+    SamplingHealth samplingHealth = {0};
+    // Sampling health counters lock
+    portMUX_TYPE samplingHealthLock = portMUX_INITIALIZER_UNLOCKED;
+
+    // Active time of the measurement tasks, microseconds
+    uint64_t activeTimeUs = 0;
+    // Time of the active time counting start, microseconds
+    int64_t activeStartUs = 0;
+    // Active time lock
+    portMUX_TYPE activeTimeLock = portMUX_INITIALIZER_UNLOCKED;
+    // Time of the last IMU data acquisition, microseconds
+    int64_t lastAcquisitionUs = 0;
+    // RTC time of the system timer drift reference, seconds (zero until the first RTC second rollover is found)
+    time_t timerReferenceRtc = 0;
+    // System timer time of the drift reference, microseconds
+    int64_t timerReferenceUs = 0;
+    // System timer drift intervals accumulated since power on (deep sleep resets the system timer only)
+    RTC_DATA_ATTR TimerDrift timerDrift = {0};
+
+    // Samples ring of segments, IMU task is producer and measurements processing is consumer
+    BlockRing sampleRing;
+    // Samples ring slot being filled by IMU task
+    size_t fillSlot = 0;
+    // Samples ring slot is acquired by IMU task, the segment is dropped otherwise
+    bool isFillAcquired = false;
+    // Index of the next sample in the segment being filled by IMU task
+    size_t fillSampleIndex = 0;
+    // IMU FIFO raw data buffer
+    uint8_t fifoBuffer[IIM42652_FIFO_SIZE];
+
+    // Analysis jobs queue of the segment being processed, served by both analysis tasks
+    RTOS::Queue<AnalysisJob, static_cast<size_t>(AnalysisJob::Count)> analysisQueue;
+    // Number of analysis jobs of the segment not finished yet
+    std::atomic<size_t> analysisJobsPending(0);
+    // Data offset of the segment being processed in the samples buffer
+    size_t analysisOffset = 0;
+    // Analysis lock, guards measurements results and setup against the loop task
+    RTOS::Mutex analysisMutex;
+
     // PSD measurements for accelerometer and gyroscope axises X/Y
     Measurements::PSD<int16_t> psdAccX;
     Measurements::PSD<int16_t> psdAccY;
@@ -220,6 +731,11 @@ namespace
     Measurements::Statistic<float> statisticPitch;
     // Statistic for accelerometer resultant direction
     Measurements::Statistic<float> statisticAccelResult;
+    // Statistic for temperature
+    Measurements::Statistic<float> statisticTemperature;
+
+    // Accelerometer temperature compensation table
+    Compensation compensation = {0};
 
     // Measurements settings
     Settings settings = {
@@ -229,20 +745,83 @@ namespace
         .frequency = sampleFrequencyDefault,
         .pointsPsd = pointsPsdDefault,
         .statisticState = statisticStateDefault,
+        .acquisitionMode = acquisitionModeDefault,
+        .sessionMode = sessionModeDefault,
+        .womThreshold = womThresholdDefault,
+        .shortInterval = shortIntervalDefault,
+        .powerMode = powerModeDefault,
+        .resultFormat = resultFormatDefault,
+        .rawCapture = rawCaptureDefault,
+        .storageLayout = storageLayoutDefault,
+        .psdResolution = psdResolutionDefault,
+        .journaling = journalingDefault,
     };
 
+    // Type of the current measurement session
+    SessionType sessionType = SessionType::Timer;
+
     // Functions prototypes
     bool setupImu();
-    bool readImu(ImuSample &imuSample);
+    const ImuOdr &selectImuOdr(size_t frequency);
+    const ImuOdr &selectImuPollingOdr(size_t frequency);
+    float getImuFilterBandwidth(const ImuOdr &imuOdr, const ImuFilter &imuFilter);
+    const ImuFilter &selectImuFilter(const ImuOdr &imuOdr, size_t frequency);
+    bool setupImuOdr(const ImuOdr &imuOdr, const ImuFilter &imuFilter);
+    bool readImu(ImuSample &imuSample, bool withTemperature);
     void startImuTask();
     void stopImuTask();
-    void setupMeasurements(uint8_t sampleCount, uint8_t sampleFrequency);
-    void performCalculations(size_t index);
+    void setupMeasurements(uint8_t sampleCount, uint16_t sampleFrequency);
+    void performCalculations(size_t slot);
+    bool isCompensationEnabled();
+    void compensateTemperature(size_t slot);
+    void runAnalysisJob(AnalysisJob job);
+    void executeAnalysisJob(AnalysisJob job);
+    void finishAnalysisJob();
+    bool processSegment(size_t slot);
+    template <typename Filter>
+    void calculateAngles(Filter &filter, size_t offset, size_t length);
     void calculateAccelResult(const int16_t *pAccX, double meanAccX, const int16_t *pAccY, double meanAccY, size_t length);
+    void getDayDirectory(const char *root, const char *timestamp, char *directory);
+    void writeCsvResult(FileSD &file, const ResultHeader &header, const Battery::Status &battery,
+                        const ResultChannel *channels, size_t channelCount);
+    void writeBinaryResult(FileSD &file, const ResultHeader &header, const Battery::Status &battery,
+                           const ResultChannel *channels, size_t channelCount, PsdRecord::BinEncoding encoding);
+    bool openResultFile(FileSD &file, const ResultHeader &header, const char *timestamp);
+    void closeResultFile(FileSD &file, const ResultHeader &header);
     void saveMeasurements();
+    void storeResult(const ResultSnapshot &snapshot);
+    StorageStats getStorageStats();
+    void storageTask(void *pvParameters);
+    void waitStorage();
+    void startRawCapture();
+    uint32_t getMeasureInterval();
+    const char *getSessionTypeString(SessionType type);
+    bool armWakeOnMotion();
     void fillBuffer(size_t offset, const ImuSample &imuSample);
+    void storeSample(const ImuSample &imuSample);
+    bool isTemperatureDue();
     void resetStatistics();
+    void countHealthEvent(HealthEvent event, uint32_t count = 1);
+    void countAcquiredSamples(size_t sampleCount);
+    SamplingHealth getSamplingHealth();
+    void startTimerDrift();
+    bool estimateTimerDrift(double &driftPpm);
+    void resetSamplingHealth();
+    void countActiveTime(int64_t startUs);
+    float getActivePercents();
+    void resetActiveTime();
+    bool setupPowerManagement(PowerMode powerMode);
+    bool isFifoMode();
+    bool isInterruptMode();
+    void imuInterruptHandler();
+    bool startImu(ImuSample &imuSample);
+    void stopImu();
+    EventBits_t waitImuData(ImuTrigger &trigger);
+    void pollImuSamples(ImuSample prevSample);
+    void drainImuFifo();
     void imuTask(void *pvParameters);
+    void analysisWorkerTask(void *pvParameters);
+    void analysisTask(void *pvParameters);
     void registerSerialReadHandlers();
     void registerSerialWriteHandlers();
 
@@ -301,6 +880,17 @@ namespace
         return (float)raw * gyroRangeDps / 32768;
     }
 
+    /**
+     * @brief Convert raw FIFO temperature value to Celsius
+     *
+     * @param raw Raw value
+     * @return Value in Celsius
+     */
+    constexpr float rawFifoTemperatureToC(int8_t raw)
+    {
+        return (float)raw / 2.07 + 25;
+    }
+
     /**
      * @brief Setup IMU sensor
      *
@@ -378,22 +968,151 @@ namespace
     }
 
     /**
-     * @brief Read IMU data
+     * @brief Select IMU output data rate nearest to the specified sampling frequency
      *
-     * @param imuSample IMU sample data to read
-     * @return true if reading succeed, false otherwise
+     * @param[in] frequency Sampling frequency, Hz
+     * @return IMU output data rate option
+     */
+    const ImuOdr &selectImuOdr(size_t frequency)
+    {
+        const ImuOdr *pSelected = &imuOdrList[0];
+
+        for (const auto &imuOdr : imuOdrList)
+        {
+            size_t difference = (imuOdr.frequency > frequency) ? imuOdr.frequency - frequency : frequency - imuOdr.frequency;
+            size_t selectedDifference = (pSelected->frequency > frequency) ? pSelected->frequency - frequency
+                                                                           : frequency - pSelected->frequency;
+            if (difference < selectedDifference)
+            {
+                pSelected = &imuOdr;
+            }
+        }
+
+        return *pSelected;
+    }
+
+    /**
+     * @brief Select the lowest IMU output data rate oversampling the polling frequency enough
+     * to keep sensor data fresh at the polling time
+     *
+     * @param[in] frequency Polling frequency, Hz
+     * @return IMU output data rate option
+     */
+    const ImuOdr &selectImuPollingOdr(size_t frequency)
+    {
+        for (const auto &imuOdr : imuOdrList)
+        {
+            if (imuOdr.frequency >= frequency * imuPollingOversampling)
+            {
+                return imuOdr;
+            }
+        }
+
+        // The highest output data rate
+        return imuOdrList[sizeof(imuOdrList) / sizeof(*imuOdrList) - 1];
+    }
+
+    /**
+     * @brief Get IMU UI filter bandwidth
+     *
+     * @param[in] imuOdr IMU output data rate option
+     * @param[in] imuFilter IMU UI filter option
+     * @return Filter bandwidth, Hz
+     */
+    float getImuFilterBandwidth(const ImuOdr &imuOdr, const ImuFilter &imuFilter)
+    {
+        size_t base = imuOdr.frequency;
+        if (imuFilter.divider != imuFilterList[0].divider && base < imuFilterBaseMin)
+        {
+            // Only ODR/2 bandwidth follows the output data rate, the others are limited from below
+            base = imuFilterBaseMin;
+        }
+
+        return static_cast<float>(base) / imuFilter.divider;
+    }
+
+    /**
+     * @brief Select the widest IMU UI filter bandwidth that suppresses aliasing at the sampling frequency
+     *
+     * @param[in] imuOdr IMU output data rate option
+     * @param[in] frequency Sampling frequency, Hz
+     * @return IMU UI filter option
+     */
+    const ImuFilter &selectImuFilter(const ImuOdr &imuOdr, size_t frequency)
+    {
+        const float bandwidthMax = static_cast<float>(frequency) * imuFilterBandwidthMaxPercent / 100;
+
+        const ImuFilter *pSelected = nullptr;
+
+        for (const auto &imuFilter : imuFilterList)
+        {
+            float bandwidth = getImuFilterBandwidth(imuOdr, imuFilter);
+            if (bandwidth <= bandwidthMax &&
+                (pSelected == nullptr || bandwidth > getImuFilterBandwidth(imuOdr, *pSelected)))
+            {
+                pSelected = &imuFilter;
+            }
+        }
+
+        if (pSelected == nullptr)
+        {
+            LOG_INFO("IMU filter can't suppress aliasing at %u Hz, use the narrowest bandwidth", frequency);
+
+            pSelected = &imuFilterList[sizeof(imuFilterList) / sizeof(*imuFilterList) - 1];
+        }
+
+        return *pSelected;
+    }
+
+    /**
+     * @brief Setup IMU accelerometer and gyroscope output data rate and UI filter bandwidth
+     *
+     * @param[in] imuOdr IMU output data rate option
+     * @param[in] imuFilter IMU UI filter option
+     * @return true if operations succeed, false otherwise
      */
-    bool readImu(ImuSample &imuSample)
+    bool setupImuOdr(const ImuOdr &imuOdr, const ImuFilter &imuFilter)
     {
-        bool result = imu.get_accel_data(&imuSample.accel);
+        bool result = imu.set_accel_frequency(imuOdr.accelOdr);
+        if (result == true)
+        {
+            result = imu.set_gyro_frequency(imuOdr.gyroOdr);
+        }
+
+        if (result == true)
+        {
+            result = imu.set_filter_bandwidth(imuFilter.accelBw, imuFilter.gyroBw);
+        }
+
         if (result == true)
         {
-            result = imu.get_gyro_data(&imuSample.gyro);
+            LOG_INFO("IMU output data rate %u Hz, UI filter bandwidth %.1f Hz",
+                     imuOdr.frequency, getImuFilterBandwidth(imuOdr, imuFilter));
+        }
+        else
+        {
+            LOG_ERROR("IMU output data rate setup failed");
         }
 
         return result;
     }
 
+    /**
+     * @brief Read IMU data
+     *
+     * @param imuSample IMU sample data to read
+     * @param withTemperature Read temperature along with the sample
+     * @return true if reading succeed, false otherwise
+     */
+    bool readImu(ImuSample &imuSample, bool withTemperature)
+    {
+        // Read accel, gyro (and temperature) data of the same sample in one transaction
+        bool result = imu.get_accel_gyro_data(&imuSample.accel, &imuSample.gyro,
+                                              (withTemperature == true) ? &imuSample.temperature : nullptr);
+
+        return result;
+    }
+
     /**
      * @brief Start IMU sampling
      */
@@ -436,101 +1155,369 @@ namespace
      * @param[in] pointsPsd Points to calculate PSD segment size, 2^x
      * @param[in] sampleFrequency Sampling frequency, Hz
      */
-    void setupMeasurements(uint8_t pointsPsd, uint8_t sampleFrequency)
+    void setupMeasurements(uint8_t pointsPsd, uint16_t sampleFrequency)
     {
         assert(pointsPsd >= pointsPsdMin && pointsPsd <= pointsPsdMax);
         assert(sampleFrequency >= sampleFrequencyMin && sampleFrequency <= sampleFrequencyMax);
 
-        context.setup(pointsPsd, sampleFrequency);
+        // Don't change the setup in the middle of the segment processing
+        analysisMutex.lock();
+
+        PowerMode powerMode = static_cast<PowerMode>(settings.powerMode);
+        bool isPowerManaged = setupPowerManagement(powerMode);
+
+        AcquisitionMode mode = static_cast<AcquisitionMode>(settings.acquisitionMode);
+        if (powerMode == PowerMode::LightSleep)
+        {
+            // Per sample wake ups and INT1 pulses don't fit the light sleep, FIFO is drained on the timer
+            mode = AcquisitionMode::Fifo;
+
+            LOG_INFO("Power managed sampling, IMU acquisition mode %u, light sleep %d",
+                     static_cast<uint8_t>(mode), isPowerManaged);
+        }
+        else if (sampleFrequency > sampleFrequencyRegistersMax)
+        {
+            // Reading data registers per sample can't keep up with high rates, use FIFO bulk reads
+            if (mode == AcquisitionMode::Polling)
+            {
+                mode = AcquisitionMode::Fifo;
+            }
+            else if (mode == AcquisitionMode::DataReady)
+            {
+                mode = AcquisitionMode::FifoThreshold;
+            }
+
+            LOG_INFO("High rate sampling, IMU acquisition mode %u", static_cast<uint8_t>(mode));
+        }
+
+        size_t frequency = sampleFrequency;
+        if (mode != AcquisitionMode::Polling)
+        {
+            // Sampling in the FIFO and interrupt modes is clocked by the IMU output data rate
+            const ImuOdr &imuOdr = selectImuOdr(sampleFrequency);
+            frequency = imuOdr.frequency;
+
+            setupImuOdr(imuOdr, selectImuFilter(imuOdr, frequency));
+        }
+        else
+        {
+            // Polling decimates the IMU output, the sensor filter has to limit bandwidth to the polling rate
+            const ImuOdr &imuOdr = selectImuPollingOdr(sampleFrequency);
+
+            setupImuOdr(imuOdr, selectImuFilter(imuOdr, frequency));
+        }
+
+        context.setup(pointsPsd, frequency, mode, powerMode == PowerMode::LightSleep);
+        context.isLightSleep = isPowerManaged;
+
+        // Split samples ring into segment slots
+        size_t slotCount = ringSamplesMax / context.segmentSize;
+        if (slotCount > ringSlotsMax)
+        {
+            slotCount = ringSlotsMax;
+        }
+        // IMU task is stopped, analysis task is excluded by the mutex
+        sampleRing.reset(slotCount);
 
-        LOG_INFO("PSD setup: segment size %d samples, sample time %d ms, segment time %d ms",
-                 context.segmentSize, context.imuIntervalMs, context.segmentTimeMs);
+        LOG_INFO("PSD setup: segment size %d samples, sample frequency %d Hz, sample time %d us, segment time %d ms",
+                 context.segmentSize, context.sampleFrequency, context.imuIntervalUs, context.segmentTimeMs);
 
-        // Setup madgwick's IMU and AHRS filter
-        madgwickFilter.begin(sampleFrequency);
+        // Setup orientation filter, the filter state is kept from the previous setup
+        orientationFilter.begin(context.sampleFrequency);
 
         // Setup PSD measurements
-        psdAccX.setup(context.segmentSize, sampleFrequency);
-        psdAccY.setup(context.segmentSize, sampleFrequency);
-        psdGyroX.setup(context.segmentSize, sampleFrequency);
-        psdGyroY.setup(context.segmentSize, sampleFrequency);
-        psdAccResult.setup(context.segmentSize, sampleFrequency);
+        psdAccX.setup(context.segmentSize, context.sampleFrequency);
+        psdAccY.setup(context.segmentSize, context.sampleFrequency);
+        psdGyroX.setup(context.segmentSize, context.sampleFrequency);
+        psdGyroY.setup(context.segmentSize, context.sampleFrequency);
+        psdAccResult.setup(context.segmentSize, context.sampleFrequency);
 
         // Reset measurements statistic
         resetStatistics();
+        resetSamplingHealth();
+        resetActiveTime();
+
+        analysisMutex.unlock();
+
+        if (RawCapture::isRunning() == true)
+        {
+            // Sampling setup is changed, continue capture in the new file
+            RawCapture::stop();
+            startRawCapture();
+        }
     }
 
     /**
      * @brief Perform required calculations on raw data
+     * Calculations are split into jobs, the calling task and the analysis worker execute them in parallel
      *
-     * @param[in] index Buffer index with new data
+     * @param[in] slot Samples ring slot with new data
      */
-    void performCalculations(size_t index)
+    void performCalculations(size_t slot)
     {
         // Data offset in buffer
-        const size_t offset = index * context.segmentSize;
-
-        const int16_t *pSamplesAccX = &buffer.accX[offset];
-        psdAccX.computeSegment(pSamplesAccX);
-        statisticAccX.calculate(pSamplesAccX, context.segmentSize);
-
-        const int16_t *pSamplesAccY = &buffer.accY[offset];
-        psdAccY.computeSegment(pSamplesAccY);
-        statisticAccY.calculate(pSamplesAccY, context.segmentSize);
-
-        const int16_t *pSamplesAccZ = &buffer.accZ[offset];
-        statisticAccZ.calculate(pSamplesAccZ, context.segmentSize);
+        analysisOffset = slot * context.segmentSize;
 
-        const int16_t *pSamplesGyroX = &buffer.gyrX[offset];
-        psdGyroX.computeSegment(pSamplesGyroX);
-        statisticGyroX.calculate(pSamplesGyroX, context.segmentSize);
+        int64_t startUs = esp_timer_get_time();
 
-        const int16_t *pSamplesGyroY = &buffer.gyrY[offset];
-        psdGyroY.computeSegment(pSamplesGyroY);
-        statisticGyroY.calculate(pSamplesGyroY, context.segmentSize);
+        // Compensate temperature drift in place before any calculations
+        statisticTemperature.calculate(&buffer.temperature[slot * context.temperatureCount], context.temperatureCount);
+        if (isCompensationEnabled() == true)
+        {
+            compensateTemperature(slot);
+        }
 
-        const int16_t *pSamplesGyroZ = &buffer.gyrZ[offset];
-        statisticGyroZ.calculate(pSamplesGyroZ, context.segmentSize);
+        // Accelerometer X/Y means are required by the resultant direction job, calculate them first
+        statisticAccX.calculate(&buffer.accX[analysisOffset], context.segmentSize);
+        statisticAccY.calculate(&buffer.accY[analysisOffset], context.segmentSize);
+        countActiveTime(startUs);
 
-        const float *pSamplesRoll = &buffer.roll[offset];
-        statisticRoll.calculate(pSamplesRoll, context.segmentSize);
+        // Publish all segment jobs
+        eventGroup.clear(EventBits::analysisDone);
+        analysisJobsPending = static_cast<size_t>(AnalysisJob::Count);
+        for (size_t idx = 0; idx < static_cast<size_t>(AnalysisJob::Count); idx++)
+        {
+            analysisQueue.send(static_cast<AnalysisJob>(idx));
+        }
 
-        const float *pSamplesPitch = &buffer.pitch[offset];
-        statisticPitch.calculate(pSamplesPitch, context.segmentSize);
+        // Execute jobs along with the worker until the queue is empty
+        AnalysisJob job;
+        while (analysisQueue.receive(job, 0) == true)
+        {
+            executeAnalysisJob(job);
+        }
 
-        calculateAccelResult(pSamplesAccX, statisticAccX.mean(),
-                             pSamplesAccY, statisticAccY.mean(), context.segmentSize);
-        psdAccResult.computeSegment(accelResult);
-        statisticAccelResult.calculate(accelResult, context.segmentSize);
+        // Wait the worker finishes its last job
+        eventGroup.wait(EventBits::analysisDone);
     }
 
     /**
-     * @brief Calculate accelerometer resultant direction using Linear Least Square
+     * @brief Check if the temperature compensation table has any non-zero terms
      *
-     * @param pAccX Pointer to accelerometer X axis data
-     * @param pAccY Pointer to accelerometer Y axis data
-     * @param length Number of data points
+     * @return true if compensation is required, false otherwise
      */
-    void calculateAccelResult(const int16_t *pAccX, double meanAccX, const int16_t *pAccY, double meanAccY, size_t length)
+    bool isCompensationEnabled()
     {
-        double sumX = 0;
-        double sumY = 0;
-        double sumX2 = 0;
-        double sumXY = 0;
-
+        for (size_t axis = 0; axis < 3; axis++)
+        {
+            if (compensation.slope[axis] != 0 || compensation.offset[axis] != 0)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Compensate accelerometer bias temperature drift of the segment in place
+     * Bias is evaluated once per temperature reading and subtracted from its block of samples
+     *
+     * @param[in] slot Samples ring slot with new data
+     */
+    void compensateTemperature(size_t slot)
+    {
+        const size_t offset = slot * context.segmentSize;
+        const float *pTemperature = &buffer.temperature[slot * context.temperatureCount];
+        int16_t *pAxises[] = {&buffer.accX[offset], &buffer.accY[offset], &buffer.accZ[offset]};
+
+        for (size_t block = 0; block < context.temperatureCount; block++)
+        {
+            float deltaTemperature = pTemperature[block] - compensationTemperature;
+
+            size_t start = block * temperatureDecimation;
+            size_t end = start + temperatureDecimation;
+            if (end > context.segmentSize)
+            {
+                end = context.segmentSize;
+            }
+
+            for (size_t axis = 0; axis < 3; axis++)
+            {
+                int32_t bias = lroundf(compensation.offset[axis] + compensation.slope[axis] * deltaTemperature);
+
+                int16_t *pSamples = pAxises[axis];
+                for (size_t idx = start; idx < end; idx++)
+                {
+                    int32_t value = pSamples[idx] - bias;
+                    if (value > INT16_MAX)
+                    {
+                        value = INT16_MAX;
+                    }
+                    else if (value < INT16_MIN)
+                    {
+                        value = INT16_MIN;
+                    }
+
+                    pSamples[idx] = value;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Run segment analysis job
+     *
+     * @param[in] job Analysis job
+     */
+    void runAnalysisJob(AnalysisJob job)
+    {
+        const size_t offset = analysisOffset;
+        const size_t length = context.segmentSize;
+
+        switch (job)
+        {
+        case AnalysisJob::AccelResult:
+            calculateAccelResult(&buffer.accX[offset], statisticAccX.mean(),
+                                 &buffer.accY[offset], statisticAccY.mean(), length);
+            psdAccResult.computeSegment(accelResult);
+            statisticAccelResult.calculate(accelResult, length);
+            break;
+
+        case AnalysisJob::Angles:
+            calculateAngles(orientationFilter, offset, length);
+            statisticRoll.calculate(angleRoll, length);
+            statisticPitch.calculate(anglePitch, length);
+            break;
+
+        case AnalysisJob::PsdAccX:
+            psdAccX.computeSegment(&buffer.accX[offset]);
+            break;
+
+        case AnalysisJob::PsdAccY:
+            psdAccY.computeSegment(&buffer.accY[offset]);
+            break;
+
+        case AnalysisJob::GyroX:
+            psdGyroX.computeSegment(&buffer.gyrX[offset]);
+            statisticGyroX.calculate(&buffer.gyrX[offset], length);
+            break;
+
+        case AnalysisJob::GyroY:
+            psdGyroY.computeSegment(&buffer.gyrY[offset]);
+            statisticGyroY.calculate(&buffer.gyrY[offset], length);
+            break;
+
+        case AnalysisJob::StatisticAccZ:
+            statisticAccZ.calculate(&buffer.accZ[offset], length);
+            break;
+
+        case AnalysisJob::StatisticGyroZ:
+            statisticGyroZ.calculate(&buffer.gyrZ[offset], length);
+            break;
+
+        default:
+            LOG_ERROR("Unknown analysis job %u", static_cast<uint8_t>(job));
+            break;
+        }
+    }
+
+    /**
+     * @brief Execute segment analysis job and mark it as finished
+     *
+     * @param[in] job Analysis job
+     */
+    void executeAnalysisJob(AnalysisJob job)
+    {
+        int64_t startUs = esp_timer_get_time();
+        runAnalysisJob(job);
+        countActiveTime(startUs);
+
+        finishAnalysisJob();
+    }
+
+    /**
+     * @brief Mark analysis job as finished, notify when the last segment job is done
+     */
+    void finishAnalysisJob()
+    {
+        if (analysisJobsPending.fetch_sub(1) == 1)
+        {
+            eventGroup.set(EventBits::analysisDone);
+        }
+    }
+
+    /**
+     * @brief Process the filled segment and check if the measurement is complete
+     *
+     * @param[in] slot Samples ring slot with new data
+     * @return true if the measurement is complete, false otherwise
+     */
+    bool processSegment(size_t slot)
+    {
+        // Increment count of ready segments
+        context.segmentCount++;
+        size_t measureTimeMs = context.segmentCount * context.segmentTimeMs;
+
+        uint32_t measureInterval = getMeasureInterval();
+        float readyPercents = static_cast<float>(measureTimeMs) / secondsToMillis(measureInterval) * 100;
+        LOG_INFO("PSD segment %d is ready, %.1f%%", context.segmentCount, readyPercents);
+
+        int64_t startUs = esp_timer_get_time();
+        performCalculations(slot);
+        LOG_DEBUG("PSD segment %d processed in %u us", context.segmentCount,
+                  static_cast<uint32_t>(esp_timer_get_time() - startUs));
+
+        // Check if there is enough time to take the next segment
+        bool isComplete = (measureTimeMs + context.segmentTimeMs > secondsToMillis(measureInterval + measureIntervalJitter));
+        if (isComplete == true)
+        {
+            LOG_DEBUG("Measure time %d ms + segment time %d ms > measure interval %u sec + interval jitter %d sec",
+                      measureTimeMs, context.segmentTimeMs, measureInterval, measureIntervalJitter);
+
+            context.segmentCount = 0;
+        }
+
+        return isComplete;
+    }
+
+    /**
+     * @brief Calculate roll and pitch angles of the segment by the sensor fusion
+     * Fusion runs over the whole segment in order, the filter state carries over to the next segment
+     *
+     * @param filter Orientation filter
+     * @param offset Segment data offset in the buffer
+     * @param length Number of data points
+     */
+    template <typename Filter>
+    void calculateAngles(Filter &filter, size_t offset, size_t length)
+    {
+        const int16_t *pAccX = &buffer.accX[offset];
+        const int16_t *pAccY = &buffer.accY[offset];
+        const int16_t *pAccZ = &buffer.accZ[offset];
+        const int16_t *pGyroX = &buffer.gyrX[offset];
+        const int16_t *pGyroY = &buffer.gyrY[offset];
+        const int16_t *pGyroZ = &buffer.gyrZ[offset];
+
         for (size_t idx = 0; idx < length; idx++)
         {
-            // Remove mean
-            double x = rawAccelToMs2(pAccX[idx] - meanAccX);
-            double y = rawAccelToMs2(pAccY[idx] - meanAccY);
+            // Filter expects accel in G and gyro in DPS
+            filter.update(rawGyroToDegs(pGyroX[idx]), rawGyroToDegs(pGyroY[idx]), rawGyroToDegs(pGyroZ[idx]),
+                          rawAccelToG(pAccX[idx]), rawAccelToG(pAccY[idx]), rawAccelToG(pAccZ[idx]));
 
-            // Calculate sums
-            sumX += x;
-            sumY += y;
-            sumX2 += x * x;
-            sumXY += x * y;
+            angleRoll[idx] = filter.roll();
+            anglePitch[idx] = filter.pitch();
         }
 
+        LOG_TRACE("Angle Roll %.1f, Pitch %.1f", angleRoll[length - 1], anglePitch[length - 1]);
+    }
+
+    /**
+     * @brief Calculate accelerometer resultant direction using Linear Least Square
+     *
+     * @param pAccX Pointer to accelerometer X axis data
+     * @param pAccY Pointer to accelerometer Y axis data
+     * @param length Number of data points
+     */
+    void calculateAccelResult(const int16_t *pAccX, double meanAccX, const int16_t *pAccY, double meanAccY, size_t length)
+    {
+        // Slope of the linear fit doesn't depend on the mean removal and units conversion,
+        // so the raw segment sums are enough to calculate it
+        double sumX = static_cast<double>(Kernels::sum(pAccX, length));
+        double sumY = static_cast<double>(Kernels::sum(pAccY, length));
+        double sumX2 = static_cast<double>(Kernels::sumSquares(pAccX, length));
+        double sumXY = static_cast<double>(Kernels::dot(pAccX, pAccY, length));
+
         double numerator = length * sumXY - sumX * sumY;
         double denominator = length * sumX2 - sumX * sumX;
         if (denominator != 0.0)
@@ -540,13 +1527,15 @@ namespace
 
             // Calculate theta angle
             double theta = atan(slope);
+            double cosTheta = cos(theta);
+            double sinTheta = sin(theta);
 
             for (size_t idx = 0; idx < length; idx++)
             {
                 double x = rawAccelToMs2(pAccX[idx] - meanAccX);
                 double y = rawAccelToMs2(pAccY[idx] - meanAccY);
 
-                accelResult[idx] = x * cos(theta) + y * sin(theta);
+                accelResult[idx] = x * cosTheta + y * sinTheta;
             }
         }
         else
@@ -559,7 +1548,238 @@ namespace
     }
 
     /**
-     * @brief Save measurements to the SD file
+     * @brief Get subdirectory of the day the timestamp belongs to
+     * Every directory keeps the files of one day only, so searching a name in it doesn't slow down as the card fills
+     *
+     * @param[in] root Root directory
+     * @param[in] timestamp Timestamp string @ref SystemTime::TimestampString
+     * @param[out] directory Day subdirectory path (at least @ref dayDirectoryMaxLength + 1 symbols)
+     */
+    void getDayDirectory(const char *root, const char *timestamp, char *directory)
+    {
+        snprintf(directory, dayDirectoryMaxLength + 1, "%s/%.*s", root, static_cast<int>(sizeof(SystemTime::DateString) - 1), timestamp);
+    }
+
+    /**
+     * @brief Write measurements result header and channels to the SD file as text (CSV)
+     *
+     * @param[in] file Opened result file
+     * @param[in] header Result header
+     * @param[in] battery Battery status at the result storing
+     * @param[in] channels Result channels
+     * @param[in] channelCount Number of result channels
+     */
+    void writeCsvResult(FileSD &file, const ResultHeader &header, const Battery::Status &battery,
+                        const ResultChannel *channels, size_t channelCount)
+    {
+        assert(channelCount <= resultChannelCount);
+
+        ResultCsv::Header csvHeader = {
+            .firmware = FwVersion::getVersionString(),
+            .batteryVoltage = battery.voltage,
+            .batteryLevel = battery.level,
+            .startTime = {header.startDateTime.Second, header.startDateTime.Minute, header.startDateTime.Hour,
+                          header.startDateTime.Day, header.startDateTime.Month, header.startDateTime.Year},
+            .loggingRate = static_cast<uint16_t>(header.sampleFrequency),
+            .measuredRate = header.measuredFrequency,
+            .sampleClockPpm = header.sampleClockPpm,
+            .timerDriftPpm = (header.isDriftEstimated == true) ? header.timerDriftPpm : NAN,
+            .session = static_cast<uint8_t>(header.session),
+            .isLightSleep = header.isLightSleep,
+            .samples = header.health.samples,
+            .missedDeadlines = header.health.missedDeadlines,
+            .duplicatedSamples = header.health.duplicatedSamples,
+            .readFailures = header.health.readFailures,
+            .fifoOverflows = header.health.fifoOverflows,
+            .invalidPackets = header.health.invalidPackets,
+            .droppedSegments = static_cast<uint32_t>(header.ringStats.overruns),
+            .batchIntervalMaxUs = header.health.batchIntervalMaxUs,
+            .intervalMeanUs = header.health.intervalMeanUs(),
+            .segmentSize = static_cast<uint16_t>(header.segmentSize),
+            .binCount = static_cast<uint16_t>(header.resultPoints),
+        };
+
+        ResultCsv::Channel csvChannels[resultChannelCount];
+        for (size_t channel = 0; channel < channelCount; channel++)
+        {
+            const ResultChannel &result = channels[channel];
+
+            csvChannels[channel] = {
+                .name = result.name,
+                .units = result.units,
+                .maximum = result.maximum,
+                .minimum = result.minimum,
+                .mean = result.mean,
+                .deviation = result.deviation,
+                .psd = result.psd,
+                .coreFrequency = result.coreBin.frequency,
+                .coreAmplitude = result.coreBin.amplitude,
+            };
+        }
+
+        // Host record converter writes the same text from the binary records
+        ResultCsv::write(file, csvHeader, csvChannels, channelCount);
+    }
+
+    /**
+     * @brief Write measurements result header and channels to the SD file as binary record
+     *
+     * @param[in] file Opened result file
+     * @param[in] header Result header
+     * @param[in] battery Battery status at the result storing
+     * @param[in] channels Result channels
+     * @param[in] channelCount Number of result channels
+     * @param[in] encoding PSD bins encoding
+     */
+    void writeBinaryResult(FileSD &file, const ResultHeader &header, const Battery::Status &battery,
+                           const ResultChannel *channels, size_t channelCount, PsdRecord::BinEncoding encoding)
+    {
+        PsdRecord::Header recordHeader = {
+            .magic = PsdRecord::magic,
+            .version = PsdRecord::version,
+            .headerSize = sizeof(PsdRecord::Header),
+            .binEncoding = static_cast<uint8_t>(encoding),
+            .channelCount = static_cast<uint8_t>(channelCount),
+            .segmentSize = static_cast<uint16_t>(header.segmentSize),
+            .binCount = static_cast<uint16_t>(header.resultPoints),
+            .loggingRate = static_cast<uint16_t>(header.sampleFrequency),
+            .measuredRate = static_cast<float>(header.measuredFrequency),
+            .sampleClockPpm = static_cast<float>(header.sampleClockPpm),
+            .timerDriftPpm = (header.isDriftEstimated == true) ? static_cast<float>(header.timerDriftPpm) : NAN,
+            .startTime = {header.startDateTime.Second, header.startDateTime.Minute, header.startDateTime.Hour,
+                          header.startDateTime.Day, header.startDateTime.Month, header.startDateTime.Year},
+            .session = static_cast<uint8_t>(header.session),
+            .batteryLevel = battery.level,
+            .batteryVoltage = battery.voltage,
+            .firmware = {0},
+            .samples = header.health.samples,
+            .missedDeadlines = header.health.missedDeadlines,
+            .duplicatedSamples = header.health.duplicatedSamples,
+            .readFailures = header.health.readFailures,
+            .droppedSegments = static_cast<uint32_t>(header.ringStats.overruns),
+            .batchIntervalMaxUs = header.health.batchIntervalMaxUs,
+            .intervalMeanUs = header.health.intervalMeanUs(),
+            .fifoOverflows = header.health.fifoOverflows,
+            .invalidPackets = header.health.invalidPackets,
+            .lightSleep = header.isLightSleep,
+        };
+        strncpy(recordHeader.firmware, FwVersion::getVersionString(), sizeof(recordHeader.firmware) - 1);
+
+        PsdRecord::Writer writer(file);
+        writer.write(&recordHeader, sizeof(recordHeader));
+
+        for (size_t channel = 0; channel < channelCount; channel++)
+        {
+            const ResultChannel &result = channels[channel];
+
+            PsdRecord::ChannelDescriptor descriptor = {
+                .name = {0},
+                .units = {0},
+                .hasPsd = (result.psd != nullptr),
+                .reserved = {0},
+                .maximum = static_cast<float>(result.maximum),
+                .minimum = static_cast<float>(result.minimum),
+                .mean = static_cast<float>(result.mean),
+                .deviation = static_cast<float>(result.deviation),
+                .coreFrequency = static_cast<float>(result.coreBin.frequency),
+                .coreAmplitude = static_cast<float>(result.coreBin.amplitude),
+                .logMin = 0,
+                .logStep = 0,
+            };
+            strncpy(descriptor.name, result.name, sizeof(descriptor.name) - 1);
+            strncpy(descriptor.units, result.units, sizeof(descriptor.units) - 1);
+
+            if (result.psd == nullptr)
+            {
+                writer.write(&descriptor, sizeof(descriptor));
+            }
+            else if (encoding == PsdRecord::BinEncoding::Log16)
+            {
+                PsdRecord::quantizeLog(result.psd, header.resultPoints, binsLog16, descriptor.logMin, descriptor.logStep);
+
+                writer.write(&descriptor, sizeof(descriptor));
+                writer.write(binsLog16, header.resultPoints * sizeof(*binsLog16));
+            }
+            else if (encoding == PsdRecord::BinEncoding::LogDelta)
+            {
+                float resolutionDb = header.psdResolution * psdResolutionUnitDb;
+                size_t size = PsdRecord::compressLog(result.psd, header.resultPoints, resolutionDb, binsLogDelta,
+                                                     descriptor.logMin, descriptor.logStep);
+
+                writer.write(&descriptor, sizeof(descriptor));
+                writer.write(binsLogDelta, size);
+            }
+            else
+            {
+                for (size_t idx = 0; idx < header.resultPoints; idx++)
+                {
+                    binsFloat32[idx] = result.psd[idx];
+                }
+
+                writer.write(&descriptor, sizeof(descriptor));
+                writer.write(binsFloat32, header.resultPoints * sizeof(*binsFloat32));
+            }
+        }
+
+        bool result = writer.finish();
+        if (result == false)
+        {
+            LOG_ERROR("PSD record writing failed");
+        }
+    }
+
+    /**
+     * @brief Open the file to write the measurements result to, according to the storage layout
+     *
+     * @param[out] file Result file
+     * @param[in] header Result header
+     * @param[in] timestamp Timestamp of the result @ref SystemTime::TimestampString
+     * @return true if the file is opened, false otherwise
+     */
+    bool openResultFile(FileSD &file, const ResultHeader &header, const char *timestamp)
+    {
+        bool result = false;
+
+        if (static_cast<StorageLayout>(header.storageLayout) == StorageLayout::DailyContainer)
+        {
+            SystemTime::DateString date;
+            snprintf(date, sizeof(date), "%s", timestamp);
+
+            result = ResultContainer::open(file, resultDirectory, date);
+        }
+        else
+        {
+            char directory[dayDirectoryMaxLength + 1];
+            getDayDirectory(resultDirectory, timestamp, directory);
+
+            bool isCsv = (static_cast<ResultFormat>(header.resultFormat) == ResultFormat::Csv);
+            result = file.create(directory, timestamp, isCsv ? "csv" : "psd");
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Close the result file, according to the storage layout
+     *
+     * @param[in] file Result file
+     * @param[in] header Result header
+     */
+    void closeResultFile(FileSD &file, const ResultHeader &header)
+    {
+        if (static_cast<StorageLayout>(header.storageLayout) == StorageLayout::DailyContainer)
+        {
+            ResultContainer::close(file, header.time);
+        }
+        else
+        {
+            file.close();
+        }
+    }
+
+    /**
+     * @brief Save measurements: take the result snapshot and hand it off to the storage task
+     * Blocks only if all the snapshots are still waiting for storing
      */
     void saveMeasurements()
     {
@@ -573,207 +1793,195 @@ namespace
             resultPoints = settings.pointsCutoff;
         }
 
+        // Take a free snapshot, the storage task returns it after storing
+        size_t slot = 0;
+        int64_t waitStartUs = esp_timer_get_time();
+        storageFreeQueue.receive(slot);
+        uint32_t waitMs = (esp_timer_get_time() - waitStartUs) / microsPerMilli;
+
+        portENTER_CRITICAL(&storageStatsLock);
+        bool isSlow = (waitMs > storageStats.waitMaxMs);
+        if (isSlow == true)
+        {
+            storageStats.waitMaxMs = waitMs;
+        }
+        portEXIT_CRITICAL(&storageStatsLock);
+
+        if (isSlow == true)
+        {
+            LOG_WARNING("Result storing is slow, waited for free snapshot %u ms", waitMs);
+        }
+
+        ResultSnapshot &snapshot = resultSnapshots[slot];
+        ResultHeader &header = snapshot.header;
+        header = {
+            .health = getSamplingHealth(),
+            .ringStats = sampleRing.stats(),
+            .measuredFrequency = 0,
+            .sampleClockPpm = 0,
+            .isDriftEstimated = false,
+            .timerDriftPpm = 0,
+            .resultPoints = resultPoints,
+            .time = 0,
+            .startDateTime = context.startDateTime,
+            .sampleFrequency = context.sampleFrequency,
+            .segmentSize = context.segmentSize,
+            .session = sessionType,
+            .resultFormat = settings.resultFormat,
+            .storageLayout = settings.storageLayout,
+            .psdResolution = settings.psdResolution,
+            .isLightSleep = context.isLightSleep,
+        };
+        SystemTime::getEpochTime(header.time);
+
+        // Measure sampling frequency by the system timer and correct it by the timer drift against RTC
+        header.isDriftEstimated = estimateTimerDrift(header.timerDriftPpm);
+        header.measuredFrequency = header.health.measuredFrequency(context.sampleFrequency) * (1 + header.timerDriftPpm / 1000000);
+        header.sampleClockPpm = (header.measuredFrequency - context.sampleFrequency) / context.sampleFrequency * 1000000;
+        LOG_INFO("Sampling frequency measured %.4f Hz (%.0f ppm), timer drift %.1f ppm",
+                 header.measuredFrequency, header.sampleClockPpm, header.timerDriftPpm);
+
+        // PSD frequency axis is scaled by the measured sampling frequency
+        psdAccX.setSampleFrequency(header.measuredFrequency);
+        psdAccY.setSampleFrequency(header.measuredFrequency);
+        psdGyroX.setSampleFrequency(header.measuredFrequency);
+        psdGyroY.setSampleFrequency(header.measuredFrequency);
+        psdAccResult.setSampleFrequency(header.measuredFrequency);
+
         Measurements::PsdBin coreBinAccX;
         Measurements::PsdBin coreBinAccY;
         Measurements::PsdBin coreBinGyroX;
         Measurements::PsdBin coreBinGyroY;
         Measurements::PsdBin coreBinAccResult;
 
-        const double *resultPsdAccX = psdAccX.getResult(&coreBinAccX);
-        const double *resultPsdAccY = psdAccY.getResult(&coreBinAccY);
-        const double *resultPsdGyroX = psdGyroX.getResult(&coreBinGyroX);
-        const double *resultPsdGyroY = psdGyroY.getResult(&coreBinGyroY);
-        const double *resultPsdAccResult = psdAccResult.getResult(&coreBinAccResult);
-
-        Battery::Status batteryStatus = Battery::readStatus();
-
-        SystemTime::TimestampString timestamp;
-        SystemTime::getTimestamp(timestamp);
-
-        FileSD _file;
-        _file.create("PSD", timestamp);
-        bool isOpen = _file.open();
-        if (isOpen == true)
-        {
-            char string[100];
-
-            snprintf(string, sizeof(string), "FW %s", FwVersion::getVersionString());
-            _file.println(string);
-
-            // File header
-            float batteryVoltage = static_cast<float>(batteryStatus.voltage) / 1000;
-            snprintf(string, sizeof(string), "BATT %.1fV", batteryVoltage);
-            _file.println(string);
-            snprintf(string, sizeof(string), "BATT %u%%", batteryStatus.level);
-            _file.println(string);
-            snprintf(string, sizeof(string), "START_TIME %u/%u/%u %u:%u:%u",
-                     context.startDateTime.Day, context.startDateTime.Month, context.startDateTime.Year,
-                     context.startDateTime.Hour, context.startDateTime.Minute, context.startDateTime.Second);
-            _file.println(string);
-            snprintf(string, sizeof(string), "Logging Rate,%u", settings.frequency);
-            _file.println(string);
-            _file.println(""); // End of header
-
-            _file.println("Channel Name,ACC_X");
-            _file.println("Channel Units,m/s^2");
-            snprintf(string, sizeof(string), "Maximum,%G", rawAccelToMs2(statisticAccX.max()));
-            _file.println(string);
-            snprintf(string, sizeof(string), "Minimum,%G", rawAccelToMs2(statisticAccX.min()));
-            _file.println(string);
-            snprintf(string, sizeof(string), "Mean,%G", rawAccelToMs2(statisticAccX.mean()));
-            _file.println(string);
-            snprintf(string, sizeof(string), "Standard Deviation,%G", rawAccelToMs2(statisticAccX.deviation()));
-            _file.println(string);
-            snprintf(string, sizeof(string), "Core Frequency (%dpt PSD),%G,%G", context.segmentSize, coreBinAccX.frequency, coreBinAccX.amplitude);
-            _file.println(string);
-            snprintf(string, sizeof(string), "PSD_%d_%d", resultPoints, context.segmentSize);
-            _file.print(string);
-            for (size_t idx = 0; idx < resultPoints; idx++)
+        // PSD bins are copied to the snapshot, PSD calculators are reset for the next measurement
+        const double *resultPsdAccX = snapshot.psd[0];
+        const double *resultPsdAccY = snapshot.psd[1];
+        const double *resultPsdGyroX = snapshot.psd[2];
+        const double *resultPsdGyroY = snapshot.psd[3];
+        const double *resultPsdAccResult = snapshot.psd[4];
+        memcpy(snapshot.psd[0], psdAccX.getResult(&coreBinAccX), resultPoints * sizeof(double));
+        memcpy(snapshot.psd[1], psdAccY.getResult(&coreBinAccY), resultPoints * sizeof(double));
+        memcpy(snapshot.psd[2], psdGyroX.getResult(&coreBinGyroX), resultPoints * sizeof(double));
+        memcpy(snapshot.psd[3], psdGyroY.getResult(&coreBinGyroY), resultPoints * sizeof(double));
+        memcpy(snapshot.psd[4], psdAccResult.getResult(&coreBinAccResult), resultPoints * sizeof(double));
+
+        const ResultChannel channels[] = {
             {
-                snprintf(string, sizeof(string), ",%G", resultPsdAccX[idx]);
-                _file.print(string);
-            }
-            _file.println(""); // End of PSD
-            _file.println(""); // End of channel
-
-            _file.println("Channel Name,ACC_Y");
-            _file.println("Channel Units,m/s^2");
-            snprintf(string, sizeof(string), "Maximum,%G", rawAccelToMs2(statisticAccY.max()));
-            _file.println(string);
-            snprintf(string, sizeof(string), "Minimum,%G", rawAccelToMs2(statisticAccY.min()));
-            _file.println(string);
-            snprintf(string, sizeof(string), "Mean,%G", rawAccelToMs2(statisticAccY.mean()));
-            _file.println(string);
-            snprintf(string, sizeof(string), "Standard Deviation,%G", rawAccelToMs2(statisticAccY.deviation()));
-            _file.println(string);
-            snprintf(string, sizeof(string), "Core Frequency (%dpt PSD),%G,%G", context.segmentSize, coreBinAccY.frequency, coreBinAccY.amplitude);
-            _file.println(string);
-            snprintf(string, sizeof(string), "PSD_%d_%d", resultPoints, context.segmentSize);
-            _file.print(string);
-            for (size_t idx = 0; idx < resultPoints; idx++)
+                .name = "ACC_X",
+                .units = "m/s^2",
+                .maximum = rawAccelToMs2(statisticAccX.max()),
+                .minimum = rawAccelToMs2(statisticAccX.min()),
+                .mean = rawAccelToMs2(statisticAccX.mean()),
+                .deviation = rawAccelToMs2(statisticAccX.deviation()),
+                .psd = resultPsdAccX,
+                .coreBin = coreBinAccX,
+            },
             {
-                snprintf(string, sizeof(string), ",%G", resultPsdAccY[idx]);
-                _file.print(string);
-            }
-            _file.println(""); // End of PSD
-            _file.println(""); // End of channel
-
-            _file.println("Channel Name,ACC_Z");
-            _file.println("Channel Units,m/s^2");
-            snprintf(string, sizeof(string), "Maximum,%G", rawAccelToMs2(statisticAccZ.max()));
-            _file.println(string);
-            snprintf(string, sizeof(string), "Minimum,%G", rawAccelToMs2(statisticAccZ.min()));
-            _file.println(string);
-            snprintf(string, sizeof(string), "Mean,%G", rawAccelToMs2(statisticAccZ.mean()));
-            _file.println(string);
-            snprintf(string, sizeof(string), "Standard Deviation,%G", rawAccelToMs2(statisticAccZ.deviation()));
-            _file.println(string);
-            _file.println(""); // End of channel
-
-            _file.println("Channel Name,GYRO_X");
-            _file.println("Channel Units,rad/s");
-            snprintf(string, sizeof(string), "Maximum,%G", rawGyroToRads(statisticGyroX.max()));
-            _file.println(string);
-            snprintf(string, sizeof(string), "Minimum,%G", rawGyroToRads(statisticGyroX.min()));
-            _file.println(string);
-            snprintf(string, sizeof(string), "Mean,%G", rawGyroToRads(statisticGyroX.mean()));
-            _file.println(string);
-            snprintf(string, sizeof(string), "Standard Deviation,%G", rawGyroToRads(statisticGyroX.deviation()));
-            _file.println(string);
-            snprintf(string, sizeof(string), "Core Frequency (%dpt PSD),%G,%G", context.segmentSize, coreBinGyroX.frequency, coreBinGyroX.amplitude);
-            _file.println(string);
-            snprintf(string, sizeof(string), "PSD_%d_%d", resultPoints, context.segmentSize);
-            _file.print(string);
-            for (size_t idx = 0; idx < resultPoints; idx++)
+                .name = "ACC_Y",
+                .units = "m/s^2",
+                .maximum = rawAccelToMs2(statisticAccY.max()),
+                .minimum = rawAccelToMs2(statisticAccY.min()),
+                .mean = rawAccelToMs2(statisticAccY.mean()),
+                .deviation = rawAccelToMs2(statisticAccY.deviation()),
+                .psd = resultPsdAccY,
+                .coreBin = coreBinAccY,
+            },
             {
-                snprintf(string, sizeof(string), ",%G", resultPsdGyroX[idx]);
-                _file.print(string);
-            }
-            _file.println(""); // End of PSD
-            _file.println(""); // End of channel
-
-            _file.println("Channel Name,GYRO_Y");
-            _file.println("Channel Units,rad/s");
-            snprintf(string, sizeof(string), "Maximum,%G", rawGyroToRads(statisticGyroY.max()));
-            _file.println(string);
-            snprintf(string, sizeof(string), "Minimum,%G", rawGyroToRads(statisticGyroY.min()));
-            _file.println(string);
-            snprintf(string, sizeof(string), "Mean,%G", rawGyroToRads(statisticGyroY.mean()));
-            _file.println(string);
-            snprintf(string, sizeof(string), "Standard Deviation,%G", rawGyroToRads(statisticGyroY.deviation()));
-            _file.println(string);
-            snprintf(string, sizeof(string), "Core Frequency (%dpt PSD),%G,%G", context.segmentSize, coreBinGyroY.frequency, coreBinGyroY.amplitude);
-            _file.println(string);
-            snprintf(string, sizeof(string), "PSD_%d_%d", resultPoints, context.segmentSize);
-            _file.print(string);
-            for (size_t idx = 0; idx < resultPoints; idx++)
+                .name = "ACC_Z",
+                .units = "m/s^2",
+                .maximum = rawAccelToMs2(statisticAccZ.max()),
+                .minimum = rawAccelToMs2(statisticAccZ.min()),
+                .mean = rawAccelToMs2(statisticAccZ.mean()),
+                .deviation = rawAccelToMs2(statisticAccZ.deviation()),
+                .psd = nullptr,
+                .coreBin = {0},
+            },
             {
-                snprintf(string, sizeof(string), ",%G", resultPsdGyroY[idx]);
-                _file.print(string);
-            }
-            _file.println(""); // End of PSD
-            _file.println(""); // End of channel
-
-            _file.println("Channel Name,GYRO_Z");
-            _file.println("Channel Units,rad/s");
-            snprintf(string, sizeof(string), "Maximum,%G", rawGyroToRads(statisticGyroZ.max()));
-            _file.println(string);
-            snprintf(string, sizeof(string), "Minimum,%G", rawGyroToRads(statisticGyroZ.min()));
-            _file.println(string);
-            snprintf(string, sizeof(string), "Mean,%G", rawGyroToRads(statisticGyroZ.mean()));
-            _file.println(string);
-            snprintf(string, sizeof(string), "Standard Deviation,%G", rawGyroToRads(statisticGyroZ.deviation()));
-            _file.println(string);
-            _file.println(""); // End of channel
-
-            _file.println("Channel Name,ROLL");
-            _file.println("Channel Units,deg");
-            snprintf(string, sizeof(string), "Maximum,%G", statisticRoll.max());
-            _file.println(string);
-            snprintf(string, sizeof(string), "Minimum,%G", statisticRoll.min());
-            _file.println(string);
-            snprintf(string, sizeof(string), "Mean,%G", statisticRoll.mean());
-            _file.println(string);
-            snprintf(string, sizeof(string), "Standard Deviation,%G", statisticRoll.deviation());
-            _file.println(string);
-            _file.println(""); // End of channel
-
-            _file.println("Channel Name,PITCH");
-            _file.println("Channel Units,deg");
-            snprintf(string, sizeof(string), "Maximum,%G", statisticPitch.max());
-            _file.println(string);
-            snprintf(string, sizeof(string), "Minimum,%G", statisticPitch.min());
-            _file.println(string);
-            snprintf(string, sizeof(string), "Mean,%G", statisticPitch.mean());
-            _file.println(string);
-            snprintf(string, sizeof(string), "Standard Deviation,%G", statisticPitch.deviation());
-            _file.println(string);
-            _file.println(""); // End of channel
-
-            _file.println("Channel Name,E_ACC_RES");
-            _file.println("Channel Units,m/s^2");
-            snprintf(string, sizeof(string), "Maximum,%G", statisticAccelResult.max());
-            _file.println(string);
-            snprintf(string, sizeof(string), "Minimum,%G", statisticAccelResult.min());
-            _file.println(string);
-            snprintf(string, sizeof(string), "Mean,%G", statisticAccelResult.mean());
-            _file.println(string);
-            snprintf(string, sizeof(string), "Standard Deviation,%G", statisticAccelResult.deviation());
-            _file.println(string);
-            snprintf(string, sizeof(string), "Core Frequency (%dpt PSD),%G,%G", context.segmentSize, coreBinAccResult.frequency, coreBinAccResult.amplitude);
-            _file.println(string);
-            snprintf(string, sizeof(string), "PSD_%d_%d", resultPoints, context.segmentSize);
-            _file.print(string);
-            for (size_t idx = 0; idx < resultPoints; idx++)
+                .name = "GYRO_X",
+                .units = "rad/s",
+                .maximum = rawGyroToRads(statisticGyroX.max()),
+                .minimum = rawGyroToRads(statisticGyroX.min()),
+                .mean = rawGyroToRads(statisticGyroX.mean()),
+                .deviation = rawGyroToRads(statisticGyroX.deviation()),
+                .psd = resultPsdGyroX,
+                .coreBin = coreBinGyroX,
+            },
             {
-                snprintf(string, sizeof(string), ",%G", resultPsdAccResult[idx]);
-                _file.print(string);
-            }
-            _file.println(""); // End of PSD
-            _file.println(""); // End of channel
-
-            _file.close();
+                .name = "GYRO_Y",
+                .units = "rad/s",
+                .maximum = rawGyroToRads(statisticGyroY.max()),
+                .minimum = rawGyroToRads(statisticGyroY.min()),
+                .mean = rawGyroToRads(statisticGyroY.mean()),
+                .deviation = rawGyroToRads(statisticGyroY.deviation()),
+                .psd = resultPsdGyroY,
+                .coreBin = coreBinGyroY,
+            },
+            {
+                .name = "GYRO_Z",
+                .units = "rad/s",
+                .maximum = rawGyroToRads(statisticGyroZ.max()),
+                .minimum = rawGyroToRads(statisticGyroZ.min()),
+                .mean = rawGyroToRads(statisticGyroZ.mean()),
+                .deviation = rawGyroToRads(statisticGyroZ.deviation()),
+                .psd = nullptr,
+                .coreBin = {0},
+            },
+            {
+                .name = "ROLL",
+                .units = "deg",
+                .maximum = statisticRoll.max(),
+                .minimum = statisticRoll.min(),
+                .mean = statisticRoll.mean(),
+                .deviation = statisticRoll.deviation(),
+                .psd = nullptr,
+                .coreBin = {0},
+            },
+            {
+                .name = "PITCH",
+                .units = "deg",
+                .maximum = statisticPitch.max(),
+                .minimum = statisticPitch.min(),
+                .mean = statisticPitch.mean(),
+                .deviation = statisticPitch.deviation(),
+                .psd = nullptr,
+                .coreBin = {0},
+            },
+            {
+                .name = "E_ACC_RES",
+                .units = "m/s^2",
+                .maximum = statisticAccelResult.max(),
+                .minimum = statisticAccelResult.min(),
+                .mean = statisticAccelResult.mean(),
+                .deviation = statisticAccelResult.deviation(),
+                .psd = resultPsdAccResult,
+                .coreBin = coreBinAccResult,
+            },
+            // Added after the channels of the earlier results, so the readers taking the channels by position keep working
+            {
+                .name = "TEMP",
+                .units = "degC",
+                .maximum = statisticTemperature.max(),
+                .minimum = statisticTemperature.min(),
+                .mean = statisticTemperature.mean(),
+                .deviation = statisticTemperature.deviation(),
+                .psd = nullptr,
+                .coreBin = {0},
+            },
+        };
+        static_assert(sizeof(channels) == sizeof(snapshot.channels), "Result channels don't match the snapshot");
+        memcpy(snapshot.channels, channels, sizeof(channels));
+
+        storageQueue.send(slot);
+
+        size_t depth = storageQueue.count();
+
+        portENTER_CRITICAL(&storageStatsLock);
+        if (depth > storageStats.depthMax)
+        {
+            storageStats.depthMax = depth;
         }
+        portEXIT_CRITICAL(&storageStatsLock);
 
         LOG_DEBUG("ACC_X: Max %d, Min %d, Mean %f, Standard Deviation %f, Core Frequency %lfHz - %lf",
                   statisticAccX.max(), statisticAccX.min(), statisticAccX.mean(), statisticAccX.deviation(),
@@ -804,120 +2012,816 @@ namespace
     }
 
     /**
-     * @brief Fill buffer data with IMU sample
+     * @brief Store the result snapshot to the SD card
      *
-     * @param[in] offset Data offset in the buffer
-     * @param[in] imuSample IMU sample
+     * @param[in] snapshot Result snapshot
      */
-    void fillBuffer(size_t offset, const ImuSample &imuSample)
+    void storeResult(const ResultSnapshot &snapshot)
     {
-        // Fill Accel/Gyro buffer data
-        buffer.accX[offset] = imuSample.accel.x;
-        buffer.accY[offset] = imuSample.accel.y;
-        buffer.accZ[offset] = imuSample.accel.z;
-        buffer.gyrX[offset] = imuSample.gyro.x;
-        buffer.gyrY[offset] = imuSample.gyro.y;
-        buffer.gyrZ[offset] = imuSample.gyro.z;
+        const ResultHeader &header = snapshot.header;
+
+        SystemTime::TimestampString timestamp;
+        SystemTime::epochToTimestamp(header.time, timestamp);
+
+        int64_t startUs = esp_timer_get_time();
+
+        // Raw capture writes to the card concurrently, battery measurement detaches SPI pins of the card
+        FileSD::lock();
+
+        // Read by the storage task, the snapshot keeps what the loop task has taken only
+        Battery::Status battery = Battery::readStatus();
+
+        FileSD file;
+        bool isOpen = openResultFile(file, header, timestamp);
+        if (isOpen == true)
+        {
+            switch (static_cast<ResultFormat>(header.resultFormat))
+            {
+            case ResultFormat::BinaryFloat32:
+                writeBinaryResult(file, header, battery, snapshot.channels, resultChannelCount, PsdRecord::BinEncoding::Float32);
+                break;
+            case ResultFormat::BinaryLog16:
+                writeBinaryResult(file, header, battery, snapshot.channels, resultChannelCount, PsdRecord::BinEncoding::Log16);
+                break;
+            case ResultFormat::BinaryLogDelta:
+                writeBinaryResult(file, header, battery, snapshot.channels, resultChannelCount, PsdRecord::BinEncoding::LogDelta);
+                break;
+            default:
+                writeCsvResult(file, header, battery, snapshot.channels, resultChannelCount);
+                break;
+            }
+
+            closeResultFile(file, header);
+        }
+
+        FileSD::unlock();
 
-        // Convert to accel to G and gyro to DPS
-        float accelGX = rawAccelToG(imuSample.accel.x);
-        float accelGY = rawAccelToG(imuSample.accel.y);
-        float accelGZ = rawAccelToG(imuSample.accel.z);
-        float gyroDpsX = rawGyroToDegs(imuSample.gyro.x);
-        float gyroDpsY = rawGyroToDegs(imuSample.gyro.y);
-        float gyroDpsZ = rawGyroToDegs(imuSample.gyro.z);
-        LOG_TRACE("Acc G X %.1f, Y %.1f, Z %.1f, Gyro DPS X %.1f, Y %.1f, Z %.1f",
-                  accelGX, accelGY, accelGZ, gyroDpsX, gyroDpsY, gyroDpsZ);
+        uint32_t writeMs = (esp_timer_get_time() - startUs) / microsPerMilli;
 
-        // Calculate/fill angle buffer data
-        madgwickFilter.updateIMU(gyroDpsX, gyroDpsY, gyroDpsZ, accelGX, accelGY, accelGZ);
-        buffer.roll[offset] = madgwickFilter.getRoll();
-        buffer.pitch[offset] = madgwickFilter.getPitch();
-        LOG_TRACE("Angle Roll %.1f, Pitch %.1f", buffer.roll[offset], buffer.pitch[offset]);
+        portENTER_CRITICAL(&storageStatsLock);
+        storageStats.stored++;
+        storageStats.writeLastMs = writeMs;
+        storageStats.writeSumMs += writeMs;
+        if (writeMs > storageStats.writeMaxMs)
+        {
+            storageStats.writeMaxMs = writeMs;
+        }
+        portEXIT_CRITICAL(&storageStatsLock);
+
+        LOG_INFO("Result %s stored in %u ms, %u more waiting", timestamp, writeMs, storageQueue.count());
     }
 
     /**
-     * @brief Reset measurements statistic
+     * @brief Get consistent copy of result storage statistics
+     *
+     * @return Result storage statistics
      */
-    void resetStatistics()
+    StorageStats getStorageStats()
     {
-        statisticAccX.reset();
-        statisticAccY.reset();
-        statisticAccZ.reset();
-        statisticGyroX.reset();
-        statisticGyroY.reset();
-        statisticGyroZ.reset();
-        statisticRoll.reset();
-        statisticPitch.reset();
-        statisticAccelResult.reset();
+        portENTER_CRITICAL(&storageStatsLock);
+        StorageStats stats = storageStats;
+        portEXIT_CRITICAL(&storageStatsLock);
+
+        return stats;
     }
 
     /**
-     * @brief IMU samples reading task function
+     * @brief Storage task, stores result snapshots handed off by the loop task
      *
      * @param pvParameters Task parameters
      */
-    void imuTask(void *pvParameters)
+    void storageTask(void *pvParameters)
     {
-        TickType_t xLastWakeTime;
-        BaseType_t xWasDelayed;
+        (void *)pvParameters;
 
-        ImuSample imuSample = {0};
-        ImuSample prevSample = imuSample;
+        while (1)
+        {
+            size_t slot = 0;
+            storageQueue.receive(slot);
 
-        size_t segmentIndex = 0;
-        size_t sampleIndex = 0;
+            storeResult(resultSnapshots[slot]);
 
-        (void *)pvParameters; // unused
+            storageFreeQueue.send(slot);
+        }
+    }
 
-        while (1)
+    /**
+     * @brief Wait until all the results handed off to the storage task are stored
+     */
+    void waitStorage()
+    {
+        while (storageFreeQueue.count() < storageQueueLength)
         {
-            LOG_INFO("IMU task idle");
+            vTaskDelay(pdMS_TO_TICKS(storageWaitPeriodMs));
+        }
+    }
 
-            // Report IMU is in IDLE state
-            eventGroup.set(EventBits::imuIdle);
+    /**
+     * @brief Start raw samples capture of the measurement (if enabled)
+     */
+    void startRawCapture()
+    {
+        if (settings.rawCapture == 0)
+        {
+            return;
+        }
 
-            // Wait for start event
-            EventBits_t events = eventGroup.wait(EventBits::startImu);
+        SystemTime::TimestampString timestamp;
+        SystemTime::getTimestamp(timestamp);
+        char directory[dayDirectoryMaxLength + 1];
+        getDayDirectory(rawDirectory, timestamp, directory);
+
+        RawCapture::Setup setup = {
+            .directory = directory,
+            .fileName = timestamp,
+            .sampleFrequency = context.sampleFrequency,
+            .duration = getMeasureInterval(),
+            .accelScale = rawAccelToMs2(1),
+            .gyroScale = rawGyroToRads(1),
+        };
+        RawCapture::start(setup);
+    }
 
-            // Enable sensors when task is started
-            bool status = imu.accelerometer_enable();
-            if (status == true)
-            {
-                status = imu.gyroscope_enable();
-                if (status == true)
-                {
-                    status = readImu(prevSample);
-                }
-            }
+    /**
+     * @brief Get measure interval of the current session
+     *
+     * @return Measure interval, seconds
+     */
+    uint32_t getMeasureInterval()
+    {
+        return (sessionType == SessionType::Short) ? settings.shortInterval : settings.measureInterval;
+    }
 
-            // Workaround to skip the first initial invalid samples
-            uint32_t timeout = 0;
-            while (status == true)
+    /**
+     * @brief Get string of the session type
+     *
+     * @param[in] type Session type
+     * @return Session type string
+     */
+    const char *getSessionTypeString(SessionType type)
+    {
+        return ResultCsv::getSessionName(static_cast<uint8_t>(type));
+    }
+
+    /**
+     * @brief Arm IMU wake on motion for the deep sleep
+     * Accelerometer runs alone in low power mode and raises latched INT1 when the threshold is exceeded
+     *
+     * @return true if operations succeed, false otherwise
+     */
+    bool armWakeOnMotion()
+    {
+        // Threshold resolution is 1g/256
+        uint32_t threshold = (static_cast<uint32_t>(settings.womThreshold) * 256 + 500) / 1000;
+        if (threshold < 1)
+        {
+            threshold = 1;
+        }
+        else if (threshold > UINT8_MAX)
+        {
+            threshold = UINT8_MAX;
+        }
+
+        bool result = imu.set_accel_frequency(womAccelOdr);
+        if (result == true)
+        {
+            imu.enable_accel_low_power_mode();
+
+            result = imu.int1_configuration(0, true);
+        }
+
+        if (result == true)
+        {
+            imu.wake_on_motion_configuration(threshold, threshold, threshold);
+
+            LOG_INFO("Wake on motion armed, threshold %u mg (%u)", settings.womThreshold, threshold);
+        }
+        else
+        {
+            LOG_ERROR("Wake on motion arming failed");
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Fill buffer data with IMU sample
+     * Only raw values are copied, all conversions are done by the segment processing
+     *
+     * @param[in] offset Data offset in the buffer
+     * @param[in] imuSample IMU sample
+     */
+    void fillBuffer(size_t offset, const ImuSample &imuSample)
+    {
+        // Fill Accel/Gyro buffer data
+        buffer.accX[offset] = imuSample.accel.x;
+        buffer.accY[offset] = imuSample.accel.y;
+        buffer.accZ[offset] = imuSample.accel.z;
+        buffer.gyrX[offset] = imuSample.gyro.x;
+        buffer.gyrY[offset] = imuSample.gyro.y;
+        buffer.gyrZ[offset] = imuSample.gyro.z;
+    }
+
+    /**
+     * @brief Reset measurements statistic
+     */
+    void resetStatistics()
+    {
+        statisticAccX.reset();
+        statisticAccY.reset();
+        statisticAccZ.reset();
+        statisticGyroX.reset();
+        statisticGyroY.reset();
+        statisticGyroZ.reset();
+        statisticRoll.reset();
+        statisticPitch.reset();
+        statisticAccelResult.reset();
+        statisticTemperature.reset();
+    }
+
+    /**
+     * @brief Count sampling health event
+     *
+     * @param[in] event Sampling health event
+     * @param[in] count Number of the events
+     */
+    void countHealthEvent(HealthEvent event, uint32_t count)
+    {
+        portENTER_CRITICAL(&samplingHealthLock);
+
+        switch (event)
+        {
+        case HealthEvent::MissedDeadline:
+            samplingHealth.missedDeadlines += count;
+            break;
+        case HealthEvent::DuplicatedSample:
+            samplingHealth.duplicatedSamples += count;
+            break;
+        case HealthEvent::ReadFailure:
+            samplingHealth.readFailures += count;
+            break;
+        case HealthEvent::FifoOverflow:
+            samplingHealth.fifoOverflows += count;
+            break;
+        case HealthEvent::InvalidPacket:
+            samplingHealth.invalidPackets += count;
+            break;
+        }
+
+        portEXIT_CRITICAL(&samplingHealthLock);
+    }
+
+    /**
+     * @brief Count acquired samples and measure interval between them
+     * Samples acquired in one batch (FIFO drain) are considered evenly spaced since the last acquisition,
+     * so the maximum interval is the maximum batch mean interval (per sample interval in the polling mode)
+     *
+     * @param[in] sampleCount Number of acquired samples
+     */
+    void countAcquiredSamples(size_t sampleCount)
+    {
+        int64_t timeUs = esp_timer_get_time();
+        uint32_t elapsedUs = static_cast<uint32_t>(timeUs - lastAcquisitionUs);
+        lastAcquisitionUs = timeUs;
+
+        if (sampleCount == 0)
+        {
+            return;
+        }
+
+        // Raw file gets the block timestamp right after the block samples
+        RawCapture::mark(timeUs);
+
+        uint32_t intervalUs = elapsedUs / sampleCount;
+
+        portENTER_CRITICAL(&samplingHealthLock);
+
+        if (samplingHealth.samples == 0)
+        {
+            // The first block is the frequency measurement start
+            samplingHealth.firstBlockUs = timeUs;
+            samplingHealth.firstBlockSamples = sampleCount;
+        }
+        samplingHealth.lastBlockUs = timeUs;
+        samplingHealth.samples += sampleCount;
+        samplingHealth.intervalSumUs += elapsedUs;
+        samplingHealth.intervalCount += sampleCount;
+        if (intervalUs > samplingHealth.batchIntervalMaxUs)
+        {
+            samplingHealth.batchIntervalMaxUs = intervalUs;
+        }
+
+        portEXIT_CRITICAL(&samplingHealthLock);
+    }
+
+    /**
+     * @brief Get consistent copy of sampling health counters
+     *
+     * @return Sampling health counters
+     */
+    SamplingHealth getSamplingHealth()
+    {
+        portENTER_CRITICAL(&samplingHealthLock);
+        SamplingHealth health = samplingHealth;
+        portEXIT_CRITICAL(&samplingHealthLock);
+
+        return health;
+    }
+
+    /**
+     * @brief Start system timer drift estimation against RTC
+     * References are taken at the RTC second rollovers in the background, so they aren't limited by the RTC seconds
+     * resolution and nothing waits for the RTC second
+     */
+    void startTimerDrift()
+    {
+        bool result = SystemTime::startRolloverTracking();
+        if (result == false)
+        {
+            LOG_WARNING("Timer drift can't be estimated without RTC");
+        }
+    }
+
+    /**
+     * @brief Estimate system timer drift against RTC, doesn't wait
+     * Interval since the drift reference (the first found RTC second rollover of the run) to the last found rollover
+     * is added to the intervals of the previous runs and the reference moves to the last rollover,
+     * so the drift is estimated over deep sleeps as well
+     *
+     * @param[out] driftPpm System timer drift (positive if timer runs faster than RTC), ppm
+     * @return true if the drift is estimated, false if there is no RTC or too little time accumulated
+     */
+    bool estimateTimerDrift(double &driftPpm)
+    {
+        SystemTime::RolloverReference first;
+        SystemTime::RolloverReference last;
+        bool result = SystemTime::getRollovers(first, last);
+        if (result == false)
+        {
+            return false;
+        }
+
+        if (timerReferenceRtc == 0)
+        {
+            timerReferenceUs = first.timerUs;
+            timerReferenceRtc = first.time;
+        }
+
+        // No new rollover is found since the previous estimation, the accumulated intervals are used
+        time_t rtcElapsed = last.time - timerReferenceRtc;
+        if (rtcElapsed != 0)
+        {
+            int64_t intervalUs = last.timerUs - timerReferenceUs;
+            timerReferenceUs = last.timerUs;
+            timerReferenceRtc = last.time;
+
+            double rtcUs = static_cast<double>(rtcElapsed) * microsPerSecond;
+            bool isPlausible = (rtcElapsed > 0 && fabs(intervalUs - rtcUs) <= rtcUs * timerDriftMaxPpm / 1000000);
+            if (isPlausible == true)
+            {
+                timerDrift.timerUs += intervalUs;
+                timerDrift.rtcTime += rtcElapsed;
+            }
+            else
+            {
+                LOG_WARNING("RTC time is changed, timer drift estimation is restarted");
+                timerDrift = {0};
+            }
+        }
+
+        result = (timerDrift.rtcTime >= timerDriftRtcTimeMin);
+        if (result == true)
+        {
+            double sumRtcUs = static_cast<double>(timerDrift.rtcTime) * microsPerSecond;
+            driftPpm = (timerDrift.timerUs - sumRtcUs) / sumRtcUs * 1000000;
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Reset sampling health counters
+     */
+    void resetSamplingHealth()
+    {
+        portENTER_CRITICAL(&samplingHealthLock);
+        samplingHealth = {0};
+        portEXIT_CRITICAL(&samplingHealthLock);
+    }
+
+    /**
+     * @brief Count active (not waiting) time of the measurement task
+     *
+     * @param[in] startUs Time when the task became active, microseconds
+     */
+    void countActiveTime(int64_t startUs)
+    {
+        int64_t durationUs = esp_timer_get_time() - startUs;
+
+        portENTER_CRITICAL(&activeTimeLock);
+        activeTimeUs += durationUs;
+        portEXIT_CRITICAL(&activeTimeLock);
+    }
+
+    /**
+     * @brief Get active time of the measurement tasks since the measurement start
+     *
+     * @return Active time, percents of both cores time
+     */
+    float getActivePercents()
+    {
+        portENTER_CRITICAL(&activeTimeLock);
+        uint64_t activeUs = activeTimeUs;
+        int64_t startUs = activeStartUs;
+        portEXIT_CRITICAL(&activeTimeLock);
+
+        int64_t elapsedUs = esp_timer_get_time() - startUs;
+        if (elapsedUs <= 0)
+        {
+            return 0;
+        }
+
+        return static_cast<float>(activeUs) * 100 / (static_cast<float>(elapsedUs) * portNUM_PROCESSORS);
+    }
+
+    /**
+     * @brief Reset active time counting
+     */
+    void resetActiveTime()
+    {
+        portENTER_CRITICAL(&activeTimeLock);
+        activeTimeUs = 0;
+        activeStartUs = esp_timer_get_time();
+        portEXIT_CRITICAL(&activeTimeLock);
+    }
+
+    /**
+     * @brief Setup framework power management for the power mode
+     * Light sleep lets CPU sleep automatically when all tasks are waiting
+     *
+     * @param[in] powerMode Power mode
+     * @return true if light sleep is enabled, false otherwise
+     */
+    bool setupPowerManagement(PowerMode powerMode)
+    {
+        bool isLightSleep = (powerMode == PowerMode::LightSleep);
+
+#ifdef MEASUREMENTS_USE_LIGHT_SLEEP
+        esp_pm_config_esp32s3_t config = {
+            .max_freq_mhz = static_cast<int>(getCpuFrequencyMhz()),
+            .min_freq_mhz = static_cast<int>(isLightSleep ? getXtalFrequencyMhz() : getCpuFrequencyMhz()),
+            .light_sleep_enable = isLightSleep,
+        };
+
+        esp_err_t error = esp_pm_configure(&config);
+        if (error != ESP_OK)
+        {
+            LOG_ERROR("Power management setup failed, error %d", error);
+            isLightSleep = false;
+        }
+#else
+        if (isLightSleep == true)
+        {
+            LOG_WARNING("Light sleep isn't enabled in the framework, CPU only idles between FIFO batches");
+            isLightSleep = false;
+        }
+#endif // MEASUREMENTS_USE_LIGHT_SLEEP
+
+        return isLightSleep;
+    }
+
+    /**
+     * @brief Store IMU sample to the samples ring, publish the segment when it is filled
+     * The whole segment is dropped if there is no free slot at the segment start
+     *
+     * @param[in] imuSample IMU sample
+     */
+    void storeSample(const ImuSample &imuSample)
+    {
+        // Raw capture takes every sample, independently of the segments ring
+        RawCapture::Sample rawSample = {
+            .accX = imuSample.accel.x,
+            .accY = imuSample.accel.y,
+            .accZ = imuSample.accel.z,
+            .gyrX = imuSample.gyro.x,
+            .gyrY = imuSample.gyro.y,
+            .gyrZ = imuSample.gyro.z,
+        };
+        RawCapture::write(rawSample);
+
+        if (fillSampleIndex == 0)
+        {
+            // Acquire the slot for the new segment
+            isFillAcquired = sampleRing.acquire(fillSlot);
+            if (isFillAcquired != true)
             {
-                status = readImu(prevSample);
-                if (status == true &&
-                    prevSample.accel.x != imuResetValue &&
-                    prevSample.accel.y != imuResetValue &&
-                    prevSample.accel.z != imuResetValue &&
-                    prevSample.gyro.x != imuResetValue &&
-                    prevSample.gyro.y != imuResetValue &&
-                    prevSample.gyro.z != imuResetValue)
+                LOG_ERROR("Samples ring is full, segment dropped");
+            }
+        }
+
+        if (isFillAcquired == true)
+        {
+            // Fill buffer data with IMU sample
+            fillBuffer(fillSlot * context.segmentSize + fillSampleIndex, imuSample);
+
+            if (isTemperatureDue() == true)
+            {
+                buffer.temperature[fillSlot * context.temperatureCount + fillSampleIndex / temperatureDecimation] = imuSample.temperature;
+            }
+        }
+
+        fillSampleIndex++;
+        if (fillSampleIndex >= context.segmentSize)
+        {
+            if (isFillAcquired == true)
+            {
+                // Publish the filled segment
+                sampleRing.commit();
+                eventGroup.set(EventBits::segmentReady);
+            }
+
+            // Start filling the next segment
+            fillSampleIndex = 0;
+        }
+    }
+
+    /**
+     * @brief Check if the next stored sample belongs to the temperature channel
+     *
+     * @return true if temperature should be read along with the sample, false otherwise
+     */
+    bool isTemperatureDue()
+    {
+        return (fillSampleIndex % temperatureDecimation) == 0;
+    }
+
+    /**
+     * @brief Check if the current acquisition mode reads IMU samples from the sensor FIFO
+     *
+     * @return true if FIFO is used, false otherwise
+     */
+    bool isFifoMode()
+    {
+        return context.acquisitionMode == AcquisitionMode::Fifo ||
+               context.acquisitionMode == AcquisitionMode::FifoThreshold;
+    }
+
+    /**
+     * @brief Check if the current acquisition mode is driven by the IMU INT1 interrupt
+     *
+     * @return true if interrupt is used, false otherwise
+     */
+    bool isInterruptMode()
+    {
+        return context.acquisitionMode == AcquisitionMode::DataReady ||
+               context.acquisitionMode == AcquisitionMode::FifoThreshold;
+    }
+
+    /**
+     * @brief IMU INT1 interrupt handler, wakes up IMU task
+     */
+    void IRAM_ATTR imuInterruptHandler()
+    {
+        eventGroup.setIsr(EventBits::imuDataReady);
+    }
+
+    /**
+     * @brief Enable IMU sensors and wait for the first valid sample
+     *
+     * @param[out] imuSample The first valid IMU sample
+     * @return true if operations succeed, false otherwise
+     */
+    bool startImu(ImuSample &imuSample)
+    {
+        // Enable sensors when task is started
+        bool status = imu.accelerometer_enable();
+        if (status == true)
+        {
+            status = imu.gyroscope_enable();
+            if (status == true)
+            {
+                status = readImu(imuSample, true);
+            }
+        }
+
+        // Workaround to skip the first initial invalid samples
+        uint32_t timeout = 0;
+        while (status == true)
+        {
+            status = readImu(imuSample, true);
+            if (status == true &&
+                imuSample.accel.x != imuResetValue &&
+                imuSample.accel.y != imuResetValue &&
+                imuSample.accel.z != imuResetValue &&
+                imuSample.gyro.x != imuResetValue &&
+                imuSample.gyro.y != imuResetValue &&
+                imuSample.gyro.z != imuResetValue)
+            {
+                break;
+            }
+
+            if (timeout > imuWaitValidTimeoutMs)
+            {
+                // IMU data is still invalid
+                status = false;
+                break;
+            }
+
+            delay(imuWaitValidDelayMs);
+            timeout += imuWaitValidDelayMs;
+        }
+
+        if (status == true && isFifoMode() == true)
+        {
+            // Start FIFO streaming from the valid data only
+            status = imu.fifo_configuration(context.fifoWatermark);
+        }
+
+        if (status == true && isInterruptMode() == true)
+        {
+            uint8_t sources = (isFifoMode() == true) ? BIT_INT_SOURCE0_FIFO_THS_INT1_EN : BIT_INT_SOURCE0_UI_DRDY_INT1_EN;
+
+            status = imu.int1_configuration(sources);
+            if (status == true)
+            {
+                // Drop the interrupt left from the previous run
+                eventGroup.clear(EventBits::imuDataReady);
+
+                pinMode(Board::ImuConfig::pinInt1, INPUT);
+                attachInterrupt(Board::ImuConfig::pinInt1, imuInterruptHandler, RISING);
+            }
+        }
+
+        return status;
+    }
+
+    /**
+     * @brief Disable IMU interrupt, FIFO and sensors
+     */
+    void stopImu()
+    {
+        if (isInterruptMode() == true)
+        {
+            detachInterrupt(Board::ImuConfig::pinInt1);
+            imu.int1_disable();
+        }
+
+        if (isFifoMode() == true)
+        {
+            imu.fifo_disable();
+        }
+
+        imu.accelerometer_disable();
+        imu.gyroscope_disable();
+    }
+
+    /**
+     * @brief Wait for the next IMU data, either on the INT1 interrupt or on the task schedule
+     * Timer polling is used as the fallback when the interrupt doesn't come in time
+     *
+     * @param[in,out] trigger IMU data trigger
+     * @return Occurred events
+     */
+    EventBits_t waitImuData(ImuTrigger &trigger)
+    {
+        bool isMissed = false;
+
+        EventBits_t events = trigger.wait(isMissed);
+        if (isMissed == true)
+        {
+            countHealthEvent(HealthEvent::MissedDeadline);
+        }
+
+        return events;
+    }
+
+    /**
+     * @brief Acquire IMU samples by reading sensor data registers until stop event
+     * Reading is triggered by the data ready interrupt or by the task schedule
+     *
+     * @param[in] prevSample The last valid IMU sample
+     */
+    void pollImuSamples(ImuSample prevSample)
+    {
+        ImuTrigger trigger(eventGroup, EventBits::imuDataReady, EventBits::stopImu);
+
+        ImuSample imuSample = prevSample;
+
+        // Start schedule from the current time
+        trigger.start(context.imuIntervalUs, isInterruptMode());
+
+        while (1)
+        {
+            // Wait for the next sample
+            EventBits_t events = waitImuData(trigger);
+            if (events & EventBits::stopImu)
+            {
+                break;
+            }
+
+            int64_t startUs = esp_timer_get_time();
+
+            // Read new IMU sample, temperature is read on the temperature channel samples only
+            bool status = readImu(imuSample, isTemperatureDue());
+            if (status == true)
+            {
+                LOG_TRACE("Acc: X %d, Y %d, Z %d, Gyro: X %d, Y %d, Z %d",
+                          imuSample.accel.x, imuSample.accel.y, imuSample.accel.z, imuSample.gyro.x, imuSample.gyro.y, imuSample.gyro.z);
+                prevSample = imuSample;
+            }
+            else
+            {
+                LOG_ERROR("IMU reading failed");
+                countHealthEvent(HealthEvent::ReadFailure);
+                countHealthEvent(HealthEvent::DuplicatedSample);
+                // Duplicate previous sample
+                imuSample = prevSample;
+            }
+
+            countAcquiredSamples(1);
+            storeSample(imuSample);
+
+            countActiveTime(startUs);
+        }
+    }
+
+    /**
+     * @brief Acquire IMU samples by draining sensor FIFO in batches until stop event
+     * Samples timing is driven by the IMU output data rate, the FIFO threshold interrupt
+     * or the task schedule only sets the batch period
+     */
+    void drainImuFifo()
+    {
+        ImuTrigger trigger(eventGroup, EventBits::imuDataReady, EventBits::stopImu);
+
+        // Start schedule from the current time, drain FIFO every watermark samples
+        trigger.start(context.fifoWatermark * context.imuIntervalUs, isInterruptMode());
+
+        while (1)
+        {
+            // Wait for the next batch
+            EventBits_t events = waitImuData(trigger);
+            if (events & EventBits::stopImu)
+            {
+                break;
+            }
+
+            int64_t startUs = esp_timer_get_time();
+
+            ImuFifo::Batch batch;
+            bool status = ImuFifo::drain(imu, fifoBuffer, [](const IIM42652_fifo_packet_t &packet)
+                                         {
+                                             ImuSample imuSample = {.accel = packet.accel,
+                                                                    .gyro = packet.gyro,
+                                                                    .temperature = rawFifoTemperatureToC(packet.temperature)};
+                                             storeSample(imuSample);
+                                         },
+                                         batch);
+            if (status == true)
+            {
+                // Only the stored samples are in the time series, skipped and lost ones are gaps
+                countAcquiredSamples(batch.stored);
+                if (batch.invalid > 0)
                 {
-                    break;
+                    countHealthEvent(HealthEvent::InvalidPacket, batch.invalid);
                 }
-
-                if (timeout > imuWaitValidTimeoutMs)
+                if (batch.isOverflow == true)
                 {
-                    // IMU data is still invalid
-                    status = false;
-                    break;
+                    countHealthEvent(HealthEvent::FifoOverflow);
                 }
-
-                delay(imuWaitValidDelayMs);
-                timeout += imuWaitValidDelayMs;
             }
+            else
+            {
+                LOG_ERROR("IMU FIFO reading failed");
+                countHealthEvent(HealthEvent::ReadFailure);
+            }
+
+            countActiveTime(startUs);
+        }
+    }
+
+    /**
+     * @brief IMU samples reading task function
+     *
+     * @param pvParameters Task parameters
+     */
+    void imuTask(void *pvParameters)
+    {
+        ImuSample imuSample = {0};
+
+        (void *)pvParameters; // unused
 
+        while (1)
+        {
+            LOG_INFO("IMU task idle");
+
+            // Report IMU is in IDLE state
+            eventGroup.set(EventBits::imuIdle);
+
+            // Wait for start event
+            eventGroup.wait(EventBits::startImu);
+
+            bool status = startImu(imuSample);
             if (status != true)
             {
                 LOG_ERROR("IMU start failed");
@@ -929,58 +2833,92 @@ namespace
             // Report IMU is in IDLE state
             eventGroup.set(EventBits::imuRunning);
 
-            // Reset segment and sample index
-            segmentIndex = 0;
-            sampleIndex = 0;
-            // Initialise the xLastWakeTime variable with the current time.
-            xLastWakeTime = xTaskGetTickCount();
+            // Start filling from the segment beginning, incomplete segment of the previous run is refilled
+            fillSampleIndex = 0;
+            // Start measuring intervals between samples
+            lastAcquisitionUs = esp_timer_get_time();
 
-            while ((events & EventBits::stopImu) == 0)
+            if (isFifoMode() == true)
+            {
+                drainImuFifo();
+            }
+            else
             {
-                // Wait for the next cycle
-                xWasDelayed = xTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(context.imuIntervalMs));
+                pollImuSamples(imuSample);
+            }
 
-                // Perform action here. xWasDelayed value can be used to determine
-                // whether a deadline was missed if the code here took too long
+            // Disable sensors when task is stopped
+            stopImu();
+        }
 
-                // Read new IMU sample
-                status = readImu(imuSample);
-                if (status == true)
-                {
-                    LOG_TRACE("Acc: X %d, Y %d, Z %d, Gyro: X %d, Y %d, Z %d",
-                              imuSample.accel.x, imuSample.accel.y, imuSample.accel.z, imuSample.gyro.x, imuSample.gyro.y, imuSample.gyro.z);
-                    prevSample = imuSample;
-                }
-                else
+        vTaskDelete(NULL);
+    }
+
+    /**
+     * @brief Analysis worker task, executes segment jobs on the other core in parallel with the analysis task
+     *
+     * @param pvParameters Task parameters
+     */
+    void analysisWorkerTask(void *pvParameters)
+    {
+        (void *)pvParameters; // unused
+
+        while (1)
+        {
+            AnalysisJob job;
+            if (analysisQueue.receive(job) == true)
+            {
+                executeAnalysisJob(job);
+            }
+        }
+
+        vTaskDelete(NULL);
+    }
+
+    /**
+     * @brief Analysis task, consumer of the samples ring
+     * Processes filled segments and hands the complete measurement over to the loop task to be saved
+     *
+     * @param pvParameters Task parameters
+     */
+    void analysisTask(void *pvParameters)
+    {
+        (void *)pvParameters; // unused
+
+        while (1)
+        {
+            // Wait for a filled segment in the samples ring
+            eventGroup.wait(EventBits::segmentReady);
+
+            while (1)
+            {
+                // Setup resets the ring under the same mutex, so the slot is peeked, processed
+                // and given back to IMU task within one lock
+                analysisMutex.lock();
+
+                size_t slot;
+                bool isReady = sampleRing.peek(slot);
+                bool isComplete = false;
+                if (isReady == true)
                 {
-                    LOG_ERROR("IMU reading failed");
-                    // Duplicate previous sample
-                    imuSample = prevSample;
+                    isComplete = processSegment(slot);
+                    sampleRing.release();
                 }
 
-                size_t offset = segmentIndex * context.segmentSize + sampleIndex;
-
-                // Fill buffer data with IMU sample
-                fillBuffer(offset, imuSample);
+                analysisMutex.unlock();
 
-                sampleIndex++;
-                if (sampleIndex >= context.segmentSize)
+                if (isReady == false)
                 {
-                    EventBits_t event = segmentIndex == 0 ? EventBits::segment0Ready : EventBits::segment1Ready;
-                    eventGroup.set(event);
-
-                    // Start filling the next segment
-                    segmentIndex = 1 - segmentIndex;
-                    sampleIndex = 0;
+                    break;
                 }
 
-                // Check if stop event occurs
-                events = eventGroup.wait(EventBits::stopImu, 0);
+                if (isComplete == true)
+                {
+                    // Results are kept unchanged until the loop task saves them
+                    eventGroup.set(EventBits::measureReady);
+                    eventGroup.wait(EventBits::measureSaved);
+                }
             }
-
-            // Disable sensors when task is stopped
-            imu.accelerometer_disable();
-            imu.gyroscope_disable();
         }
 
         vTaskDelete(NULL);
@@ -1040,6 +2978,141 @@ namespace
                                           {
                                               snprintf(dataString, sizeof(dataString), "%u", settings.statisticState);
 
+                                              *responseString = dataString;
+                                          });
+
+        Serials::Manager::subscribeToRead(Serials::CommandId::AcquisitionMode,
+                                          [](const char **responseString)
+                                          {
+                                              snprintf(dataString, sizeof(dataString), "%u", settings.acquisitionMode);
+
+                                              *responseString = dataString;
+                                          });
+
+        Serials::Manager::subscribeToRead(Serials::CommandId::SamplingHealth,
+                                          [](const char **responseString)
+                                          {
+                                              SamplingHealth health = getSamplingHealth();
+
+                                              // Samples, missed deadlines, duplicated samples, read failures,
+                                              // dropped segments, max batch mean and mean interval between samples,
+                                              // FIFO overflows, invalid FIFO packets
+                                              snprintf(dataString, sizeof(dataString), "%u %u %u %u %u %uus %.1fus %u %u",
+                                                       health.samples, health.missedDeadlines, health.duplicatedSamples,
+                                                       health.readFailures, sampleRing.stats().overruns,
+                                                       health.batchIntervalMaxUs, health.intervalMeanUs(),
+                                                       health.fifoOverflows, health.invalidPackets);
+
+                                              *responseString = dataString;
+                                          });
+
+        Serials::Manager::subscribeToRead(Serials::CommandId::SessionMode,
+                                          [](const char **responseString)
+                                          {
+                                              snprintf(dataString, sizeof(dataString), "%u", settings.sessionMode);
+
+                                              *responseString = dataString;
+                                          });
+
+        Serials::Manager::subscribeToRead(Serials::CommandId::WomThreshold,
+                                          [](const char **responseString)
+                                          {
+                                              snprintf(dataString, sizeof(dataString), "%u", settings.womThreshold);
+
+                                              *responseString = dataString;
+                                          });
+
+        Serials::Manager::subscribeToRead(Serials::CommandId::ShortInterval,
+                                          [](const char **responseString)
+                                          {
+                                              snprintf(dataString, sizeof(dataString), "%u", settings.shortInterval);
+
+                                              *responseString = dataString;
+                                          });
+
+        Serials::Manager::subscribeToRead(Serials::CommandId::PowerMode,
+                                          [](const char **responseString)
+                                          {
+                                              // Light sleep may be requested, but not available in the framework build
+                                              snprintf(dataString, sizeof(dataString), "%u %u", settings.powerMode, context.isLightSleep);
+
+                                              *responseString = dataString;
+                                          });
+
+        Serials::Manager::subscribeToRead(Serials::CommandId::TemperatureCompensation,
+                                          [](const char **responseString)
+                                          {
+                                              // Slope and offset of axises X/Y/Z
+                                              snprintf(dataString, sizeof(dataString), "%.3f %.1f %.3f %.1f %.3f %.1f",
+                                                       compensation.slope[0], compensation.offset[0],
+                                                       compensation.slope[1], compensation.offset[1],
+                                                       compensation.slope[2], compensation.offset[2]);
+
+                                              *responseString = dataString;
+                                          });
+
+        Serials::Manager::subscribeToRead(Serials::CommandId::ResultFormat,
+                                          [](const char **responseString)
+                                          {
+                                              snprintf(dataString, sizeof(dataString), "%u", settings.resultFormat);
+
+                                              *responseString = dataString;
+                                          });
+
+        Serials::Manager::subscribeToRead(Serials::CommandId::PsdResolution,
+                                          [](const char **responseString)
+                                          {
+                                              snprintf(dataString, sizeof(dataString), "%u", settings.psdResolution);
+
+                                              *responseString = dataString;
+                                          });
+
+        Serials::Manager::subscribeToRead(Serials::CommandId::StorageLayout,
+                                          [](const char **responseString)
+                                          {
+                                              snprintf(dataString, sizeof(dataString), "%u", settings.storageLayout);
+
+                                              *responseString = dataString;
+                                          });
+
+        Serials::Manager::subscribeToRead(Serials::CommandId::RawCapture,
+                                          [](const char **responseString)
+                                          {
+                                              snprintf(dataString, sizeof(dataString), "%u", settings.rawCapture);
+
+                                              *responseString = dataString;
+                                          });
+
+        Serials::Manager::subscribeToRead(Serials::CommandId::Journaling,
+                                          [](const char **responseString)
+                                          {
+                                              // Actual state, journaling falls back to direct writing if the journal can't be used
+                                              snprintf(dataString, sizeof(dataString), "%u", FileSD::getJournaling() ? 1 : 0);
+
+                                              *responseString = dataString;
+                                          });
+
+        Serials::Manager::subscribeToRead(Serials::CommandId::StorageStats,
+                                          [](const char **responseString)
+                                          {
+                                              StorageStats stats = getStorageStats();
+                                              uint32_t writeMeanMs = (stats.stored > 0) ? stats.writeSumMs / stats.stored : 0;
+
+                                              // Queue depth, max queue depth, stored results,
+                                              // last, max and mean storing time, max wait for free snapshot
+                                              snprintf(dataString, sizeof(dataString), "%u %u %u %ums %ums %ums %ums",
+                                                       storageQueue.count(), stats.depthMax, stats.stored,
+                                                       stats.writeLastMs, stats.writeMaxMs, writeMeanMs,
+                                                       stats.waitMaxMs);
+
+                                              *responseString = dataString;
+                                          });
+
+        Serials::Manager::subscribeToRead(Serials::CommandId::ActiveTime,
+                                          [](const char **responseString)
+                                          {
+                                              snprintf(dataString, sizeof(dataString), "%.1f%%", getActivePercents());
+
                                               *responseString = dataString;
                                           });
     }
@@ -1054,7 +3127,7 @@ namespace
         Serials::Manager::subscribeToWrite(Serials::CommandId::MeasureFrequency,
                                            [](const char *dataString)
                                            {
-                                               uint8_t value = atoi(dataString);
+                                               int value = atoi(dataString);
 
                                                if (value < sampleFrequencyMin)
                                                {
@@ -1155,6 +3228,197 @@ namespace
                                                settings.statisticState = value;
                                                InternalStorage::updateSettings(settingsId, settings);
                                            });
+
+        Serials::Manager::subscribeToWrite(Serials::CommandId::AcquisitionMode,
+                                           [](const char *dataString)
+                                           {
+                                               uint8_t value = atoi(dataString);
+
+                                               if (value >= static_cast<uint8_t>(AcquisitionMode::Count))
+                                               {
+                                                   value = acquisitionModeDefault;
+                                               }
+
+                                               // Stop IMU sampling
+                                               stopImuTask();
+
+                                               // Update IMU acquisition mode setting
+                                               settings.acquisitionMode = value;
+                                               InternalStorage::updateSettings(settingsId, settings);
+
+                                               // Restart measurements
+                                               setupMeasurements(settings.pointsPsd, settings.frequency);
+
+                                               // Start IMU sampling
+                                               startImuTask();
+                                           });
+
+        Serials::Manager::subscribeToWrite(Serials::CommandId::SessionMode,
+                                           [](const char *dataString)
+                                           {
+                                               uint8_t value = atoi(dataString);
+
+                                               if (value >= static_cast<uint8_t>(SessionMode::Count))
+                                               {
+                                                   value = sessionModeDefault;
+                                               }
+
+                                               // Update measurement session mode setting, applied on the next sleep
+                                               settings.sessionMode = value;
+                                               InternalStorage::updateSettings(settingsId, settings);
+                                           });
+
+        Serials::Manager::subscribeToWrite(Serials::CommandId::WomThreshold,
+                                           [](const char *dataString)
+                                           {
+                                               uint16_t value = atoi(dataString);
+
+                                               if (value < womThresholdMin)
+                                               {
+                                                   value = womThresholdMin;
+                                               }
+                                               else if (value > womThresholdMax)
+                                               {
+                                                   value = womThresholdMax;
+                                               }
+
+                                               // Update wake on motion threshold setting, applied on the next sleep
+                                               settings.womThreshold = value;
+                                               InternalStorage::updateSettings(settingsId, settings);
+                                           });
+
+        Serials::Manager::subscribeToWrite(Serials::CommandId::ShortInterval,
+                                           [](const char *dataString)
+                                           {
+                                               uint32_t value = atoi(dataString);
+
+                                               // Update short measure interval setting
+                                               settings.shortInterval = value;
+                                               InternalStorage::updateSettings(settingsId, settings);
+                                           });
+
+        Serials::Manager::subscribeToWrite(Serials::CommandId::TemperatureCompensation,
+                                           [](const char *dataString)
+                                           {
+                                               // Axis index (0 X, 1 Y, 2 Z), slope (LSB/C) and offset (LSB)
+                                               unsigned axis;
+                                               float slope;
+                                               float offset;
+
+                                               int count = sscanf(dataString, "%u %f %f", &axis, &slope, &offset);
+                                               if (count != 3 || axis >= 3)
+                                               {
+                                                   LOG_ERROR("Invalid temperature compensation: %s", dataString);
+                                                   return;
+                                               }
+
+                                               // Don't change the table in the middle of the segment processing
+                                               analysisMutex.lock();
+                                               compensation.slope[axis] = slope;
+                                               compensation.offset[axis] = offset;
+                                               analysisMutex.unlock();
+
+                                               InternalStorage::updateSettings(compensationId, compensation);
+                                           });
+
+        Serials::Manager::subscribeToWrite(Serials::CommandId::ResultFormat,
+                                           [](const char *dataString)
+                                           {
+                                               uint8_t value = atoi(dataString);
+
+                                               if (value >= static_cast<uint8_t>(ResultFormat::Count))
+                                               {
+                                                   value = resultFormatDefault;
+                                               }
+
+                                               // Result format is applied by the next saving
+                                               settings.resultFormat = value;
+                                               InternalStorage::updateSettings(settingsId, settings);
+                                           });
+
+        Serials::Manager::subscribeToWrite(Serials::CommandId::PsdResolution,
+                                           [](const char *dataString)
+                                           {
+                                               int value = atoi(dataString);
+
+                                               if (value < psdResolutionMin || value > UINT8_MAX)
+                                               {
+                                                   value = psdResolutionDefault;
+                                               }
+
+                                               // Resolution is applied by the next saving
+                                               settings.psdResolution = value;
+                                               InternalStorage::updateSettings(settingsId, settings);
+                                           });
+
+        Serials::Manager::subscribeToWrite(Serials::CommandId::StorageLayout,
+                                           [](const char *dataString)
+                                           {
+                                               uint8_t value = atoi(dataString);
+
+                                               if (value >= static_cast<uint8_t>(StorageLayout::Count))
+                                               {
+                                                   value = storageLayoutDefault;
+                                               }
+
+                                               // Storage layout is applied by the next saving
+                                               settings.storageLayout = value;
+                                               InternalStorage::updateSettings(settingsId, settings);
+                                           });
+
+        Serials::Manager::subscribeToWrite(Serials::CommandId::RawCapture,
+                                           [](const char *dataString)
+                                           {
+                                               uint8_t value = atoi(dataString);
+
+                                               settings.rawCapture = (value != 0) ? 1 : 0;
+                                               InternalStorage::updateSettings(settingsId, settings);
+
+                                               // Raw file covers the rest of the current measurement
+                                               if (settings.rawCapture != 0 && RawCapture::isRunning() == false)
+                                               {
+                                                   startRawCapture();
+                                               }
+                                               else if (settings.rawCapture == 0)
+                                               {
+                                                   RawCapture::stop();
+                                               }
+                                           });
+
+        Serials::Manager::subscribeToWrite(Serials::CommandId::Journaling,
+                                           [](const char *dataString)
+                                           {
+                                               uint8_t value = atoi(dataString);
+
+                                               // Journaling is applied by the next saving
+                                               settings.journaling = (value != 0) ? 1 : 0;
+                                               InternalStorage::updateSettings(settingsId, settings);
+                                               FileSD::setJournaling(settings.journaling != 0);
+                                           });
+
+        Serials::Manager::subscribeToWrite(Serials::CommandId::PowerMode,
+                                           [](const char *dataString)
+                                           {
+                                               uint8_t value = atoi(dataString);
+
+                                               if (value >= static_cast<uint8_t>(PowerMode::Count))
+                                               {
+                                                   value = powerModeDefault;
+                                               }
+
+                                               // Stop IMU sampling
+                                               stopImuTask();
+
+                                               // Update power mode setting
+                                               settings.powerMode = value;
+                                               InternalStorage::updateSettings(settingsId, settings);
+
+                                               // Restart measurements
+                                               setupMeasurements(settings.pointsPsd, settings.frequency);
+
+                                               // Start IMU sampling
+                                               startImuTask();
+                                           });
     }
 } // namespace
 
@@ -1167,18 +3431,53 @@ bool Manager::initialize()
 {
     // Read settings
     InternalStorage::readSettings(settingsId, settings);
+    InternalStorage::readSettings(compensationId, compensation);
+
+    // Result files are journaled to survive power fail while writing
+    FileSD::setJournaling(settings.journaling != 0);
+
+    // Determine the session type by the wake up source
+    if (static_cast<SessionMode>(settings.sessionMode) == SessionMode::WakeOnMotion)
+    {
+        if (Board::isWokenByImu() == true)
+        {
+            sessionType = SessionType::Motion;
+        }
+        else if (Board::isWokenByTimer() == true && settings.shortInterval > 0)
+        {
+            sessionType = SessionType::Short;
+        }
+    }
+    LOG_INFO("Measurement session: %s, measure interval %u sec", getSessionTypeString(sessionType), getMeasureInterval());
 
     // Register local serial handlers
     registerSerialReadHandlers();
     registerSerialWriteHandlers();
 
+    // Wake up the loop task on serial input, the first loop pass handles input received before
+    Serials::Manager::onReceive([]()
+                                { eventGroup.set(EventBits::serialReceived); });
+    eventGroup.set(EventBits::serialReceived);
+
     // Start accelerometer readings
     bool status = setupImu();
     if (status == true)
     {
         LOG_INFO("IMU initialized");
 
-        xTaskCreatePinnedToCore(imuTask, "imuTask", 4096, NULL, 1, NULL, 0);
+        xTaskCreatePinnedToCore(imuTask, "imuTask", 4096, NULL, imuTaskPriority, NULL, 0);
+        xTaskCreatePinnedToCore(analysisWorkerTask, "analysisWorker", analysisTaskStackSize, NULL,
+                                analysisTaskPriority, NULL, analysisWorkerCore);
+        xTaskCreatePinnedToCore(analysisTask, "analysisTask", analysisTaskStackSize, NULL,
+                                analysisTaskPriority, NULL, analysisTaskCore);
+        RawCapture::initialize();
+
+        for (size_t slot = 0; slot < storageQueueLength; slot++)
+        {
+            storageFreeQueue.send(slot);
+        }
+        xTaskCreatePinnedToCore(storageTask, "storageTask", storageTaskStackSize, NULL,
+                                storageTaskPriority, NULL, storageTaskCore);
 
         // Wait IMU task is idle
         EventBits_t events = eventGroup.wait(EventBits::imuIdle);
@@ -1188,6 +3487,10 @@ bool Manager::initialize()
 
             setupMeasurements(settings.pointsPsd, settings.frequency);
 
+            // Raw capture is started by the loop task once the card is mounted, the boot doesn't wait for the card
+            FileSD::onMounted([]()
+                              { eventGroup.set(EventBits::storageMounted); });
+
             // Start IMU sampling
             startImuTask();
         }
@@ -1201,54 +3504,90 @@ bool Manager::initialize()
         LOG_ERROR("IMU initialization failed");
     }
 
+    // Reference system timer to RTC in the background
+    startTimerDrift();
+
     return status;
 }
 
 /**
  * @brief Perform sensor input data processing
+ * Segments are processed by the analysis tasks, only the complete measurement is saved here
+ * Blocks until the measurement is complete or serial input is received (or the card is mounted), so the loop task doesn't poll
  */
 void Manager::process()
 {
-    // Check if event occurs
-    EventBits_t events = eventGroup.wait(EventBits::segment0Ready | EventBits::segment1Ready, 0);
-    if (events != 0)
+    // Wait for the complete measurement, serial input returns to the loop to handle commands
+    EventBits_t events = eventGroup.wait(EventBits::measureReady | EventBits::serialReceived | EventBits::storageMounted);
+    if (events & EventBits::storageMounted)
     {
-        // Increment count of ready segments
-        context.segmentCount++;
-        size_t measureTimeMs = context.segmentCount * context.segmentTimeMs;
+        // The first measurement is captured from the moment the card is ready
+        if (RawCapture::isRunning() == false)
+        {
+            startRawCapture();
+        }
+    }
 
-        float readyPercents = static_cast<float>(measureTimeMs) / secondsToMillis(settings.measureInterval) * 100;
-        LOG_INFO("PSD segment %d is ready, %.1f%%", context.segmentCount, readyPercents);
+    if (events & EventBits::measureReady)
+    {
+        int64_t startUs = esp_timer_get_time();
 
-        size_t segmentIndex = (events & EventBits::segment0Ready) ? 0 : 1;
-        performCalculations(segmentIndex);
+        BlockRing::Stats ringStats = sampleRing.stats();
+        LOG_INFO("Samples ring: depth %u, max depth %u of %u slots, overruns %u of %u segments",
+                 ringStats.depth, ringStats.depthMax, sampleRing.slotCount(),
+                 ringStats.overruns, ringStats.committed + ringStats.overruns);
 
-        // Check if there is enough time to take the next segment
-        if (measureTimeMs + context.segmentTimeMs > secondsToMillis(settings.measureInterval + measureIntervalJitter))
+        // Close the raw file of the measurement, continuous measurements capture the next one right away
+        RawCapture::stop();
+        if (settings.pauseInterval == 0)
         {
-            LOG_DEBUG("Measure time %d ms + segment time %d ms > measure interval %u sec + interval jitter %d sec",
-                      measureTimeMs, context.segmentTimeMs, settings.measureInterval, measureIntervalJitter);
+            startRawCapture();
+        }
 
-            context.segmentCount = 0;
+        // Hand off measurements to the storage task
+        saveMeasurements();
+
+        countActiveTime(startUs);
 
-            // Save measurements to the storage
-            saveMeasurements();
+        // Check if board should go to sleep during pause interval
+        if (settings.pauseInterval > 0)
+        {
+            // Stop IMU sampling
+            stopImuTask();
 
-            // Check if board should go to sleep during pause interval
-            if (settings.pauseInterval > 0)
+            bool isWakeOnMotion = false;
+            if (static_cast<SessionMode>(settings.sessionMode) == SessionMode::WakeOnMotion)
             {
-                // Stop IMU sampling
-                stopImuTask();
+                isWakeOnMotion = armWakeOnMotion();
+            }
 
-                FileSD::stopFileSystem();
+            // Results must be on the card before power down
+            waitStorage();
+            FileSD::stopFileSystem();
 
-                Board::deepSleep(settings.pauseInterval);
+            if (isWakeOnMotion == true)
+            {
+                // Sleep until motion, wake up on timer only to take the short session (if enabled)
+                size_t sleepDuration = (settings.shortInterval > 0) ? settings.pauseInterval : 0;
+                Board::deepSleep(sleepDuration, true);
             }
             else
             {
-                // Reset measurements statistic
-                resetStatistics();
+                Board::deepSleep(settings.pauseInterval);
             }
         }
+        else
+        {
+            // Continuous measurements don't sleep, the next session is a full one
+            sessionType = SessionType::Timer;
+
+            // Reset measurements statistic
+            resetStatistics();
+            resetSamplingHealth();
+            resetActiveTime();
+
+            // Let the analysis task continue with the next measurement
+            eventGroup.set(EventBits::measureSaved);
+        }
     }
 }
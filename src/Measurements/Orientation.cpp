@@ -0,0 +1,317 @@
+/**
+ * @file Orientation.cpp
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Orientation (roll/pitch) filters implementation
+ * @version 0.1
+ * @date 2024-08-24
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include "Measurements/Orientation.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+using namespace Measurements::Orientation;
+
+namespace
+{
+    // Radians to degrees conversion factor
+    constexpr float radToDeg = 180.0f / M_PI;
+    // Degrees to radians conversion factor
+    constexpr float degToRad = M_PI / 180.0f;
+
+    // Complementary filter time constant, seconds (gyroscope dominates faster changes)
+    constexpr float complementaryTimeConstant = 1.0f;
+} // namespace
+
+/**
+ * @brief Setup filter for the sampling frequency
+ *
+ * @param[in] sampleFrequency Sampling frequency, Hz
+ */
+void MadgwickFilter::begin(float sampleFrequency)
+{
+    _filter.begin(sampleFrequency);
+}
+
+/**
+ * @brief Update filter with the new sample
+ *
+ * @param[in] gx Gyroscope X axis, deg/s
+ * @param[in] gy Gyroscope Y axis, deg/s
+ * @param[in] gz Gyroscope Z axis, deg/s
+ * @param[in] ax Accelerometer X axis, G
+ * @param[in] ay Accelerometer Y axis, G
+ * @param[in] az Accelerometer Z axis, G
+ */
+void MadgwickFilter::update(float gx, float gy, float gz, float ax, float ay, float az)
+{
+    _filter.updateIMU(gx, gy, gz, ax, ay, az);
+}
+
+/**
+ * @brief Get roll angle
+ *
+ * @return Roll angle, degrees
+ */
+float MadgwickFilter::roll()
+{
+    return _filter.getRoll();
+}
+
+/**
+ * @brief Get pitch angle
+ *
+ * @return Pitch angle, degrees
+ */
+float MadgwickFilter::pitch()
+{
+    return _filter.getPitch();
+}
+
+/**
+ * @brief Setup filter for the sampling frequency
+ *
+ * @param[in] sampleFrequency Sampling frequency, Hz
+ */
+void MahonyFilter::begin(float sampleFrequency)
+{
+    assert(sampleFrequency > 0);
+
+    _sampleInterval = 1.0f / sampleFrequency;
+}
+
+/**
+ * @brief Set filter gains, the integral error is reset
+ *
+ * @param[in] kp Proportional gain
+ * @param[in] ki Integral gain (gyroscope bias compensation), zero disables it
+ */
+void MahonyFilter::setGains(float kp, float ki)
+{
+    assert(kp >= 0);
+    assert(ki >= 0);
+
+    _twoKp = 2.0f * kp;
+    _twoKi = 2.0f * ki;
+
+    _integralX = 0;
+    _integralY = 0;
+    _integralZ = 0;
+}
+
+/**
+ * @brief Update filter with the new sample
+ *
+ * @param[in] gx Gyroscope X axis, deg/s
+ * @param[in] gy Gyroscope Y axis, deg/s
+ * @param[in] gz Gyroscope Z axis, deg/s
+ * @param[in] ax Accelerometer X axis, G
+ * @param[in] ay Accelerometer Y axis, G
+ * @param[in] az Accelerometer Z axis, G
+ */
+void MahonyFilter::update(float gx, float gy, float gz, float ax, float ay, float az)
+{
+    gx *= degToRad;
+    gy *= degToRad;
+    gz *= degToRad;
+
+    // Compute feedback only if accelerometer measurement is valid (avoids NaN in normalisation)
+    if (!(ax == 0.0f && ay == 0.0f && az == 0.0f))
+    {
+        float recipNorm = 1.0f / sqrtf(ax * ax + ay * ay + az * az);
+        ax *= recipNorm;
+        ay *= recipNorm;
+        az *= recipNorm;
+
+        // Estimated direction of gravity (half)
+        float halfVx = _q1 * _q3 - _q0 * _q2;
+        float halfVy = _q0 * _q1 + _q2 * _q3;
+        float halfVz = _q0 * _q0 - 0.5f + _q3 * _q3;
+
+        // Error is cross product between estimated and measured direction of gravity (half)
+        float halfEx = ay * halfVz - az * halfVy;
+        float halfEy = az * halfVx - ax * halfVz;
+        float halfEz = ax * halfVy - ay * halfVx;
+
+        if (_twoKi > 0.0f)
+        {
+            _integralX += _twoKi * halfEx * _sampleInterval;
+            _integralY += _twoKi * halfEy * _sampleInterval;
+            _integralZ += _twoKi * halfEz * _sampleInterval;
+
+            gx += _integralX;
+            gy += _integralY;
+            gz += _integralZ;
+        }
+
+        // Apply proportional feedback
+        gx += _twoKp * halfEx;
+        gy += _twoKp * halfEy;
+        gz += _twoKp * halfEz;
+    }
+
+    // Integrate rate of change of quaternion
+    gx *= 0.5f * _sampleInterval;
+    gy *= 0.5f * _sampleInterval;
+    gz *= 0.5f * _sampleInterval;
+
+    float qa = _q0;
+    float qb = _q1;
+    float qc = _q2;
+    _q0 += (-qb * gx - qc * gy - _q3 * gz);
+    _q1 += (qa * gx + qc * gz - _q3 * gy);
+    _q2 += (qa * gy - qb * gz + _q3 * gx);
+    _q3 += (qa * gz + qb * gy - qc * gx);
+
+    // Normalise quaternion
+    float recipNorm = 1.0f / sqrtf(_q0 * _q0 + _q1 * _q1 + _q2 * _q2 + _q3 * _q3);
+    _q0 *= recipNorm;
+    _q1 *= recipNorm;
+    _q2 *= recipNorm;
+    _q3 *= recipNorm;
+
+    _isAnglesComputed = false;
+}
+
+/**
+ * @brief Get roll angle
+ *
+ * @return Roll angle, degrees
+ */
+float MahonyFilter::roll()
+{
+    if (_isAnglesComputed != true)
+    {
+        computeAngles();
+    }
+
+    return _roll * radToDeg;
+}
+
+/**
+ * @brief Get pitch angle
+ *
+ * @return Pitch angle, degrees
+ */
+float MahonyFilter::pitch()
+{
+    if (_isAnglesComputed != true)
+    {
+        computeAngles();
+    }
+
+    return _pitch * radToDeg;
+}
+
+/**
+ * @brief Compute roll and pitch angles from the quaternion
+ */
+void MahonyFilter::computeAngles()
+{
+    _roll = atan2f(_q0 * _q1 + _q2 * _q3, 0.5f - _q1 * _q1 - _q2 * _q2);
+    _pitch = asinf(-2.0f * (_q1 * _q3 - _q0 * _q2));
+
+    _isAnglesComputed = true;
+}
+
+/**
+ * @brief Setup filter for the sampling frequency
+ *
+ * @param[in] sampleFrequency Sampling frequency, Hz
+ */
+void ComplementaryFilter::begin(float sampleFrequency)
+{
+    assert(sampleFrequency > 0);
+
+    _sampleInterval = 1.0f / sampleFrequency;
+    _gyroWeight = complementaryTimeConstant / (complementaryTimeConstant + _sampleInterval);
+}
+
+/**
+ * @brief Update filter with the new sample
+ *
+ * @param[in] gx Gyroscope X axis, deg/s
+ * @param[in] gy Gyroscope Y axis, deg/s
+ * @param[in] gz Gyroscope Z axis, deg/s
+ * @param[in] ax Accelerometer X axis, G
+ * @param[in] ay Accelerometer Y axis, G
+ * @param[in] az Accelerometer Z axis, G
+ */
+void ComplementaryFilter::update(float gx, float gy, float gz, float ax, float ay, float az)
+{
+    if (_isStarted != true)
+    {
+        // Start from the measured gravity
+        _gravityX = ax;
+        _gravityY = ay;
+        _gravityZ = az;
+        _isStarted = true;
+    }
+    else
+    {
+        // Rotation angles of the sample interval
+        float wx = gx * degToRad * _sampleInterval;
+        float wy = gy * degToRad * _sampleInterval;
+        float wz = gz * degToRad * _sampleInterval;
+
+        // Earth fixed vector seen from the rotating sensor frame: dv = v x w (small angle approximation)
+        float vx = _gravityX + (_gravityY * wz - _gravityZ * wy);
+        float vy = _gravityY + (_gravityZ * wx - _gravityX * wz);
+        float vz = _gravityZ + (_gravityX * wy - _gravityY * wx);
+
+        // Pull the propagated gravity to the accelerometer, it also keeps the vector length bounded
+        _gravityX = _gyroWeight * vx + (1.0f - _gyroWeight) * ax;
+        _gravityY = _gyroWeight * vy + (1.0f - _gyroWeight) * ay;
+        _gravityZ = _gyroWeight * vz + (1.0f - _gyroWeight) * az;
+    }
+
+    _isAnglesComputed = false;
+}
+
+/**
+ * @brief Get roll angle
+ *
+ * @return Roll angle, degrees
+ */
+float ComplementaryFilter::roll()
+{
+    if (_isAnglesComputed != true)
+    {
+        computeAngles();
+    }
+
+    return _roll * radToDeg;
+}
+
+/**
+ * @brief Get pitch angle
+ *
+ * @return Pitch angle, degrees
+ */
+float ComplementaryFilter::pitch()
+{
+    if (_isAnglesComputed != true)
+    {
+        computeAngles();
+    }
+
+    return _pitch * radToDeg;
+}
+
+/**
+ * @brief Compute roll and pitch angles from the gravity vector
+ */
+void ComplementaryFilter::computeAngles()
+{
+    // Same convention as the quaternion filters: pitch = asin(-x / |v|)
+    _roll = atan2f(_gravityY, _gravityZ);
+    _pitch = atan2f(-_gravityX, sqrtf(_gravityY * _gravityY + _gravityZ * _gravityZ));
+
+    _isAnglesComputed = true;
+}
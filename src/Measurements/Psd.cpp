@@ -17,6 +17,10 @@
 
 #include <arduinoFFT.h>
 #include <Debug.hpp>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "Measurements/Kernels.h"
 
 using namespace Measurements;
 
@@ -29,30 +33,38 @@ namespace
      * Calculate average value for elements
      */
     template <typename T>
-    T getAverage(T *elements, size_t count)
+    T getAverage(const T *elements, size_t count)
     {
         assert(elements);
         assert(count > 0);
 
-        double sum = 0;
-        for (size_t idx = 0; idx < count; idx++)
-        {
-            sum += elements[idx];
-        }
+        double sum = static_cast<double>(Kernels::sum(elements, count));
 
         T result = static_cast<T>(sum / count);
         return result;
     }
 
-    /*
-    These are the input and output vectors
-    Input vectors receive computed results from FFT
-    */
-    double vReal[samplesCountMax];
-    double vImag[samplesCountMax];
+    /**
+     * @brief FFT workspace with the input and output vectors
+     * Input vectors receive computed results from FFT
+     * Single precision is native for the FPU, double precision is kept for the bins accumulation only
+     */
+    struct Workspace
+    {
+        float vReal[samplesCountMax];
+        float vImag[samplesCountMax];
+    };
+
+    // FFT workspaces, one per core (no more than one task computes PSD on each core at a time)
+    Workspace workspaces[portNUM_PROCESSORS];
+
+    // Precompiled window factors (window is symmetric, only the first half is stored)
+    float windowFactors[samplesCountMax / 2];
+    // Samples count the window factors are precompiled for (zero if there are no factors yet)
+    size_t windowSamples = 0;
 
     // FFT object
-    auto fft = ArduinoFFT<double>();
+    auto fft = ArduinoFFT<float>();
 } // namespace
 
 /**
@@ -75,6 +87,32 @@ void PSD<Type>::setup(size_t sampleCount, size_t sampleFrequency)
 
     // Reset computed segment count
     _segmentCount = 0;
+
+    if (windowSamples != sampleCount)
+    {
+        // Calculate window factors once per segment size, segments only read them afterwards
+        float *vReal = workspaces[xPortGetCoreID()].vReal;
+        for (size_t idx = 0; idx < sampleCount; idx++)
+        {
+            vReal[idx] = 1;
+        }
+        fft.windowing(vReal, sampleCount, FFT_WIN_TYP_HAMMING, FFT_FORWARD, windowFactors);
+        windowSamples = sampleCount;
+    }
+}
+
+/**
+ * @brief Update sampling frequency (e.g. measured instead of nominal one)
+ * Applies to the segments accumulated so far as well, since scaling is done by the results
+ *
+ * @param[in] sampleFrequency Sampling frequency, Hz
+ */
+template <typename Type>
+void PSD<Type>::setSampleFrequency(double sampleFrequency)
+{
+    assert(sampleFrequency > 0);
+
+    _sampleFrequency = sampleFrequency;
 }
 
 /**
@@ -91,6 +129,10 @@ void PSD<Type>::computeSegment(const Type *samples)
         clear();
     }
 
+    // Segments of different channels are computed on both cores simultaneously
+    float *vReal = workspaces[xPortGetCoreID()].vReal;
+    float *vImag = workspaces[xPortGetCoreID()].vImag;
+
     auto average = getAverage(samples, _sampleCount);
     for (size_t idx = 0; idx < _sampleCount; idx++)
     {
@@ -98,13 +140,14 @@ void PSD<Type>::computeSegment(const Type *samples)
         vImag[idx] = 0;
     }
 
-    fft.windowing(vReal, _sampleCount, FFT_WIN_TYP_HAMMING, FFT_FORWARD);
+    fft.windowing(vReal, _sampleCount, FFTWindow::Precompiled, FFT_FORWARD, windowFactors);
     fft.compute(vReal, vImag, _sampleCount, FFT_FORWARD);
     fft.complexToMagnitude(vReal, vImag, _sampleCount);
 
     for (size_t idx = 0; idx < _binCount; idx++)
     {
-        double bin = static_cast<double>(vReal[idx]) * vReal[idx] / _sampleFrequency / _sampleCount;
+        // Density scaling by the sampling frequency is done by the results
+        double bin = static_cast<double>(vReal[idx]) * vReal[idx];
         if (idx > 0)
         {
             bin *= 2;
@@ -132,10 +175,11 @@ const double *PSD<Type>::getResult(PsdBin *pCoreBin)
         size_t binMaxIdx = _sampleCount;
         double binMaxAmplitude = 0;
 
-        // Calculate average bins
+        // Average bins and scale them to density
+        const double scale = windowCorrection * windowCorrection / _sampleFrequency / _sampleCount;
         for (size_t idx = 0; idx < _binCount; idx++)
         {
-            _bins[idx] = (_bins[idx] / _segmentCount) * windowCorrection * windowCorrection;
+            _bins[idx] = (_bins[idx] / _segmentCount) * scale;
 
             // Check if index is invalid or bigger bin found
             if (binMaxIdx == _sampleCount || _bins[idx] > binMaxAmplitude)
@@ -148,7 +192,7 @@ const double *PSD<Type>::getResult(PsdBin *pCoreBin)
             LOG_TRACE("Bin[%d]: %lf", idx, _bins[idx]);
         }
 
-        double deltaFrequency = static_cast<double>(_sampleFrequency) / _sampleCount;
+        double deltaFrequency = _sampleFrequency / _sampleCount;
         _coreBin.frequency = binMaxIdx * deltaFrequency;
         _coreBin.amplitude = binMaxAmplitude;
 
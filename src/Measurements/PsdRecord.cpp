@@ -0,0 +1,224 @@
+/**
+ * @file PsdRecord.cpp
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Binary PSD result record format implementation
+ * @version 0.1
+ * @date 2024-09-02
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include "Measurements/PsdRecord.h"
+
+#include <assert.h>
+#include <math.h>
+
+using namespace Measurements;
+
+namespace
+{
+    // Largest Log16 code (0 is reserved for zero bins)
+    constexpr uint16_t logCodeMax = UINT16_MAX;
+    // Power ratio of one decade, dB
+    constexpr float decibelsPerDecade = 10;
+
+    /**
+     * @brief Find log10 of the smallest and the largest non-zero bins
+     *
+     * @param[in] bins PSD bins
+     * @param[in] count Number of bins
+     * @param[out] logMin log10 of the smallest non-zero bin (0 if there are no such bins)
+     * @param[out] logMax log10 of the largest non-zero bin (0 if there are no such bins)
+     */
+    void findLogRange(const double *bins, size_t count, double &logMin, double &logMax)
+    {
+        double binMin = 0;
+        double binMax = 0;
+        for (size_t idx = 0; idx < count; idx++)
+        {
+            if (bins[idx] > 0)
+            {
+                if (binMin == 0 || bins[idx] < binMin)
+                {
+                    binMin = bins[idx];
+                }
+                if (bins[idx] > binMax)
+                {
+                    binMax = bins[idx];
+                }
+            }
+        }
+
+        logMin = (binMin > 0) ? log10(binMin) : 0;
+        logMax = (binMax > 0) ? log10(binMax) : 0;
+    }
+
+    /**
+     * @brief Quantise PSD bin to Log16 code
+     *
+     * @param[in] bin PSD bin
+     * @param[in] logMin log10 of the smallest non-zero bin
+     * @param[in] logStep log10 step of the quantisation
+     * @return Log16 code
+     */
+    uint16_t quantizeBin(double bin, float logMin, float logStep)
+    {
+        if (bin > 0)
+        {
+            long code = lround((log10(bin) - logMin) / logStep) + 1;
+            return (code > logCodeMax) ? logCodeMax : code;
+        }
+
+        return 0;
+    }
+} // namespace
+
+/**
+ * @brief Quantise PSD bins to uint16 in log10 scale
+ * The whole range of non-zero bins is spread over 65535 codes, so relative error stays below range / 65534 decades
+ *
+ * @param[in] bins PSD bins
+ * @param[in] count Number of bins
+ * @param[out] codes Quantised bins
+ * @param[out] logMin log10 of the smallest non-zero bin
+ * @param[out] logStep log10 step of the quantisation
+ */
+void PsdRecord::quantizeLog(const double *bins, size_t count, uint16_t *codes, float &logMin, float &logStep)
+{
+    assert(bins);
+    assert(codes);
+
+    double rangeMin;
+    double rangeMax;
+    findLogRange(bins, count, rangeMin, rangeMax);
+
+    logMin = rangeMin;
+    logStep = (rangeMax > rangeMin) ? (rangeMax - logMin) / (logCodeMax - 1) : 1;
+
+    for (size_t idx = 0; idx < count; idx++)
+    {
+        codes[idx] = quantizeBin(bins[idx], logMin, logStep);
+    }
+}
+
+/**
+ * @brief Restore PSD bins from Log16 codes
+ *
+ * @param[in] codes Quantised bins
+ * @param[in] count Number of bins
+ * @param[in] logMin log10 of the smallest non-zero bin
+ * @param[in] logStep log10 step of the quantisation
+ * @param[out] bins PSD bins
+ */
+void PsdRecord::dequantizeLog(const uint16_t *codes, size_t count, float logMin, float logStep, double *bins)
+{
+    assert(codes);
+    assert(bins);
+
+    for (size_t idx = 0; idx < count; idx++)
+    {
+        bins[idx] = (codes[idx] > 0) ? pow(10, logMin + (codes[idx] - 1) * static_cast<double>(logStep)) : 0;
+    }
+}
+
+/**
+ * @brief Compress PSD bins: quantise them in log10 scale with the resolution, delta code and pack to varints
+ * Bins are power densities, so the quantisation step is resolution / 10 decades and every non-zero bin is
+ * reconstructed within +-resolution / 2 dB (the step is made coarser only if the bins span more than 65534 steps)
+ *
+ * @param[in] bins PSD bins
+ * @param[in] count Number of bins
+ * @param[in] resolutionDb Quantisation resolution, dB
+ * @param[out] data Compressed bins (at least count * @ref logDeltaBytesMax bytes)
+ * @param[out] logMin log10 of the smallest non-zero bin
+ * @param[out] logStep log10 step of the quantisation
+ * @return Size of the compressed bins, bytes
+ */
+size_t PsdRecord::compressLog(const double *bins, size_t count, float resolutionDb, uint8_t *data, float &logMin, float &logStep)
+{
+    assert(bins);
+    assert(data);
+    assert(resolutionDb > 0);
+
+    double rangeMin;
+    double rangeMax;
+    findLogRange(bins, count, rangeMin, rangeMax);
+
+    logMin = rangeMin;
+    logStep = resolutionDb / decibelsPerDecade;
+    if ((rangeMax - logMin) / logStep > logCodeMax - 1)
+    {
+        // Too wide range for the resolution
+        logStep = (rangeMax - logMin) / (logCodeMax - 1);
+    }
+
+    size_t size = 0;
+    int32_t previousCode = 0;
+    for (size_t idx = 0; idx < count; idx++)
+    {
+        // Neighbouring bins are close in log scale, so the most of deltas take a single byte
+        int32_t code = quantizeBin(bins[idx], logMin, logStep);
+        int32_t delta = code - previousCode;
+        uint32_t zigzag = (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31);
+        previousCode = code;
+
+        while (zigzag >= 0x80)
+        {
+            data[size++] = (zigzag & 0x7F) | 0x80;
+            zigzag >>= 7;
+        }
+        data[size++] = zigzag;
+    }
+
+    return size;
+}
+
+/**
+ * @brief Restore PSD bins from LogDelta data
+ *
+ * @param[in] data Compressed bins
+ * @param[in] size Size of the data (may be followed by other data), bytes
+ * @param[in] count Number of bins
+ * @param[in] logMin log10 of the smallest non-zero bin
+ * @param[in] logStep log10 step of the quantisation
+ * @param[out] bins PSD bins
+ * @return Size of the compressed bins, bytes (0 if the data ends before the bins or a code is out of Log16 range)
+ */
+size_t PsdRecord::decompressLog(const uint8_t *data, size_t size, size_t count, float logMin, float logStep, double *bins)
+{
+    assert(data || size == 0);
+    assert(bins);
+
+    size_t offset = 0;
+    int32_t previousCode = 0;
+    for (size_t idx = 0; idx < count; idx++)
+    {
+        uint32_t zigzag = 0;
+        bool isLast = false;
+        for (size_t byte = 0; byte < logDeltaBytesMax && isLast == false; byte++)
+        {
+            if (offset >= size)
+            {
+                return 0;
+            }
+
+            zigzag |= static_cast<uint32_t>(data[offset] & 0x7F) << (7 * byte);
+            isLast = ((data[offset] & 0x80) == 0);
+            offset++;
+        }
+
+        int32_t delta = static_cast<int32_t>(zigzag >> 1) ^ -static_cast<int32_t>(zigzag & 1);
+        int32_t code = previousCode + delta;
+        if (isLast == false || code < 0 || code > logCodeMax)
+        {
+            return 0;
+        }
+        previousCode = code;
+
+        uint16_t log16 = code;
+        dequantizeLog(&log16, 1, logMin, logStep, &bins[idx]);
+    }
+
+    return offset;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file PsdRecordWriter.cpp
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Binary PSD result record writer implementation
+ * @version 0.1
+ * @date 2024-09-02
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include "Measurements/PsdRecord.h"
+
+#include <assert.h>
+
+#include "FileSD.hpp"
+
+using namespace Measurements;
+
+/**
+ * @brief Construct a new record writer
+ *
+ * @param[in] file Opened file to write the record to
+ */
+PsdRecord::Writer::Writer(FileSD &file) : _file(file), _crc(0), _size(0), _result(true)
+{
+}
+
+/**
+ * @brief Write record data
+ *
+ * @param[in] data Pointer to the data
+ * @param[in] size Number of bytes to write
+ * @return true if data has been written, false if this or any previous writing failed
+ */
+bool PsdRecord::Writer::write(const void *data, size_t size)
+{
+    assert(data);
+
+    if (_result == true && size > 0)
+    {
+        const uint8_t *bytes = static_cast<const uint8_t *>(data);
+        _crc = (_size == 0) ? _crc32.crc32(bytes, size) : _crc32.crc32_upd(bytes, size);
+        _size += size;
+
+        _result = _file.write(data, size);
+    }
+
+    return _result;
+}
+
+/**
+ * @brief Finish the record with CRC
+ *
+ * @return true if the whole record has been written, false otherwise
+ */
+bool PsdRecord::Writer::finish()
+{
+    if (_result == true)
+    {
+        uint32_t crc = _crc;
+        _result = _file.write(&crc, sizeof(crc));
+    }
+
+    return _result;
+}
@@ -0,0 +1,444 @@
+/**
+ * @file RawCapture.cpp
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Raw IMU samples capture to SD card implementation
+ * @version 0.1
+ * @date 2024-09-06
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include "Measurements/RawCapture.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <atomic>
+
+#include <Debug.hpp>
+#include <esp_timer.h>
+#include <Events.h>
+#include <freertos/task.h>
+#include <RingBuf.h>
+#include <SdFat.h>
+
+#include "FileSD.hpp"
+#include "FwVersion.hpp"
+
+using namespace Measurements;
+
+namespace
+{
+    // SD card sector size, bytes
+    constexpr size_t sectorSize = 512;
+    // Samples ring size, bytes (1.3 seconds of 6 axises at 1 kHz covers SD card write latency spikes)
+    constexpr size_t ringSize = 32 * sectorSize;
+    // Period of the ring checking by the writer task, milliseconds
+    constexpr uint32_t writePeriodMs = 50;
+    // Raw files extension
+    const char *fileExtension = "raw";
+    // Maximum length of path to raw file
+    constexpr size_t pathMaxLength = 48;
+
+    // Writer task priority (the lowest above idle, sampling and analysis preempt it)
+    constexpr UBaseType_t writerTaskPriority = 1;
+    // Writer task stack size, bytes
+    constexpr uint32_t writerTaskStackSize = 3072;
+    // Writer task core
+    constexpr BaseType_t writerTaskCore = 1;
+
+    /**
+     * @brief Event bits of the writer task
+     */
+    namespace EventBits
+    {
+        constexpr EventBits_t start = BIT0;   // Start capture request
+        constexpr EventBits_t stop = BIT1;    // Stop capture request
+        constexpr EventBits_t stopped = BIT2; // Capture is stopped, the file is closed
+    } // namespace EventBits
+
+    // Samples ring, IMU task is producer and writer task is consumer
+    RingBuf<FsFile, ringSize> ring;
+    // Samples ring lock (ring is shared between tasks of both cores)
+    portMUX_TYPE ringLock = portMUX_INITIALIZER_UNLOCKED;
+    // Sector copied out of the ring to write
+    uint8_t sector[sectorSize];
+
+    // Raw file
+    FsFile file;
+    // Capture is running, producer adds samples
+    std::atomic<bool> isCapturing(false);
+    // Capture statistics (updated by the IMU and the writer tasks, guarded by the ring lock)
+    RawCapture::Stats captureStats;
+    // Time of the last block mark, microseconds
+    int64_t lastMarkUs = 0;
+    // Writer task events
+    RTOS::EventGroup eventGroup;
+
+    /**
+     * @brief Write the text header to the first sector of the file
+     *
+     * @param[in] setup Capture setup
+     * @return true if header is written, false otherwise
+     */
+    bool writeHeader(const RawCapture::Setup &setup)
+    {
+        memset(sector, 0, sizeof(sector));
+
+        snprintf(reinterpret_cast<char *>(sector), sizeof(sector),
+                 "RAW,2\r\n"
+                 "FW,%s\r\n"
+                 "Name,%s\r\n"
+                 "Logging Rate,%u\r\n"
+                 "Format,int16le\r\n"
+                 "Channels,ACC_X,ACC_Y,ACC_Z,GYRO_X,GYRO_Y,GYRO_Z\r\n"
+                 "Accel Scale (m/s^2),%G\r\n"
+                 "Gyro Scale (rad/s),%G\r\n"
+                 "Block Marker,%d\r\n"
+                 "Data Offset,%u\r\n",
+                 FwVersion::getVersionString(), setup.fileName, setup.sampleFrequency,
+                 setup.accelScale, setup.gyroScale, RawCapture::blockMarker, sectorSize);
+
+        return (file.write(sector, sizeof(sector)) == sizeof(sector));
+    }
+
+    /**
+     * @brief Copy data out of the ring and write it to the file
+     *
+     * @param[in] size Number of bytes to write (not more than a sector)
+     * @return true if data is written, false otherwise
+     */
+    bool writeOut(size_t size)
+    {
+        portENTER_CRITICAL(&ringLock);
+        size = ring.read(sector, size);
+        portEXIT_CRITICAL(&ringLock);
+
+        int64_t startUs = esp_timer_get_time();
+
+        FileSD::lock();
+        bool result = (file.write(sector, size) == size);
+        FileSD::unlock();
+
+        uint32_t writeUs = esp_timer_get_time() - startUs;
+
+        portENTER_CRITICAL(&ringLock);
+        captureStats.bytes += size;
+        captureStats.writeSumUs += writeUs;
+        if (writeUs > captureStats.writeMaxUs)
+        {
+            captureStats.writeMaxUs = writeUs;
+        }
+        portEXIT_CRITICAL(&ringLock);
+
+        return result;
+    }
+
+    /**
+     * @brief Get number of bytes waiting in the ring
+     *
+     * @return Number of bytes
+     */
+    size_t ringUsed()
+    {
+        portENTER_CRITICAL(&ringLock);
+        size_t used = ring.bytesUsed();
+        portEXIT_CRITICAL(&ringLock);
+
+        return used;
+    }
+
+    /**
+     * @brief Write all whole sectors waiting in the ring
+     *
+     * @return true if writing succeed, false otherwise
+     */
+    bool writeSectors()
+    {
+        bool result = true;
+
+        portENTER_CRITICAL(&ringLock);
+        size_t used = ring.bytesUsed();
+        if (used > captureStats.ringUsedMax)
+        {
+            captureStats.ringUsedMax = used;
+        }
+        portEXIT_CRITICAL(&ringLock);
+
+        while (used >= sectorSize && result == true)
+        {
+            result = writeOut(sectorSize);
+            used -= sectorSize;
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Write the rest of the ring, cut the preallocated space and close the file
+     */
+    void finishFile()
+    {
+        bool result = writeSectors();
+
+        size_t used = ringUsed();
+        if (used > 0 && result == true)
+        {
+            // The only partial sector of the file
+            result = writeOut(used);
+        }
+
+        FileSD::lock();
+        file.truncate();
+        file.close();
+        FileSD::unlock();
+
+        RawCapture::Stats stats = RawCapture::stats();
+        float writeMeanUs = (stats.bytes > 0) ? static_cast<float>(stats.writeSumUs) * sectorSize / stats.bytes : 0;
+        float throughput = (stats.writeSumUs > 0) ? static_cast<float>(stats.bytes) * 1000 / stats.writeSumUs : 0;
+        LOG_INFO("Raw capture %s: %u samples, %u marks, %u overruns, %u bytes, ring max %u of %u, sector write mean %.0f us, max %u us, %.0f KB/s",
+                 result ? "finished" : "failed", stats.samples, stats.marks, stats.overruns, stats.bytes,
+                 stats.ringUsedMax, ringSize, writeMeanUs, stats.writeMaxUs, throughput);
+    }
+
+    /**
+     * @brief Raw capture writer task, writes whole sectors from the ring to the file
+     *
+     * @param pvParameters Task parameters
+     */
+    void writerTask(void *pvParameters)
+    {
+        (void *)pvParameters;
+
+        while (1)
+        {
+            // Wait for the capture start
+            eventGroup.wait(EventBits::start);
+
+            bool result = true;
+            while (1)
+            {
+                EventBits_t events = eventGroup.wait(EventBits::stop, pdMS_TO_TICKS(writePeriodMs));
+                if (events & EventBits::stop)
+                {
+                    break;
+                }
+
+                if (result == true)
+                {
+                    result = writeSectors();
+                    if (result == false)
+                    {
+                        // Stop adding samples, the file is closed by the stop request
+                        LOG_ERROR("Raw capture writing failed");
+                        isCapturing = false;
+                    }
+                }
+            }
+
+            finishFile();
+
+            eventGroup.set(EventBits::stopped);
+        }
+    }
+} // namespace
+
+/**
+ * @brief Initialize raw capture, start the writer task
+ */
+void RawCapture::initialize()
+{
+    xTaskCreatePinnedToCore(writerTask, "rawWriter", writerTaskStackSize, NULL, writerTaskPriority, NULL, writerTaskCore);
+}
+
+/**
+ * @brief Create the raw file and start capture
+ *
+ * @param[in] setup Capture setup
+ * @return true if capture is started, false otherwise
+ */
+bool RawCapture::start(const Setup &setup)
+{
+    assert(setup.directory);
+    assert(setup.fileName);
+    assert(setup.sampleFrequency > 0);
+
+    if (isRunning() == true)
+    {
+        stop();
+    }
+
+    char path[pathMaxLength];
+    int nameOffset = snprintf(path, sizeof(path), "%s/", setup.directory);
+    snprintf(&path[nameOffset], sizeof(path) - nameOffset, "%s.%s", setup.fileName, fileExtension);
+
+    FileSD::lock();
+
+    FsFile *directory = FileSD::directory(setup.directory);
+    bool result = (directory != nullptr);
+    if (result == true)
+    {
+        result = file.open(directory, &path[nameOffset], O_RDWR | O_CREAT | O_TRUNC);
+    }
+
+    if (result == true)
+    {
+        // Contiguous space lets the card write sectors without FAT updates
+        uint64_t length = sectorSize + static_cast<uint64_t>(setup.sampleFrequency) * setup.duration * sizeof(Sample);
+        length = (length + sectorSize - 1) / sectorSize * sectorSize;
+        if (file.preAllocate(length) == false)
+        {
+            LOG_WARNING("Raw file \"%s\" can't be preallocated (%llu bytes)", path, length);
+        }
+
+        result = writeHeader(setup);
+        if (result == false)
+        {
+            file.close();
+        }
+    }
+
+    FileSD::unlock();
+
+    if (result == true)
+    {
+        lastMarkUs = 0;
+
+        portENTER_CRITICAL(&ringLock);
+        captureStats = {0};
+        ring.begin(nullptr);
+        // Ring is guarded by the spinlock, its own interrupt masking isn't needed
+        ring.beginISR();
+        portEXIT_CRITICAL(&ringLock);
+
+        isCapturing = true;
+        eventGroup.set(EventBits::start);
+
+        LOG_INFO("Raw capture to \"%s\" started", path);
+    }
+    else
+    {
+        LOG_ERROR("Raw file \"%s\" isn't created", path);
+    }
+
+    return result;
+}
+
+/**
+ * @brief Stop capture, write the rest of samples and close the file
+ * Blocks until the writer task has finished the file
+ */
+void RawCapture::stop()
+{
+    if (isRunning() == false)
+    {
+        return;
+    }
+
+    isCapturing = false;
+
+    eventGroup.set(EventBits::stop);
+    eventGroup.wait(EventBits::stopped);
+}
+
+/**
+ * @brief Check if capture is running
+ *
+ * @return true if capture is running, false otherwise
+ */
+bool RawCapture::isRunning()
+{
+    return file.isOpen();
+}
+
+/**
+ * @brief Add sample to the capture (producer side, doesn't block)
+ *
+ * @param[in] sample Raw IMU sample
+ * @return true if sample is added or capture isn't running, false if sample is dropped
+ */
+bool RawCapture::write(const Sample &sample)
+{
+    if (isCapturing == false)
+    {
+        return true;
+    }
+
+    const Sample *pSample = &sample;
+    Sample clamped;
+    if (sample.accX == blockMarker && sample.accY == blockMarker)
+    {
+        // Saturated sample must not look like the block mark
+        clamped = sample;
+        clamped.accY++;
+        pSample = &clamped;
+    }
+
+    portENTER_CRITICAL(&ringLock);
+    size_t size = ring.write(pSample, sizeof(*pSample));
+    bool result = (size == sizeof(sample));
+    if (result == true)
+    {
+        captureStats.samples++;
+    }
+    else
+    {
+        captureStats.overruns++;
+    }
+    portEXIT_CRITICAL(&ringLock);
+
+    return result;
+}
+
+/**
+ * @brief Mark the end of the acquired block with its timestamp (producer side, doesn't block)
+ * Marks closer than blockMarkIntervalUs to the previous one are skipped
+ *
+ * @param[in] timeUs System timer time of the latest sample of the block, microseconds
+ * @return true if mark is added, skipped or capture isn't running, false if mark is dropped
+ */
+bool RawCapture::mark(int64_t timeUs)
+{
+    if (isCapturing == false || timeUs - lastMarkUs < blockMarkIntervalUs)
+    {
+        return true;
+    }
+
+    BlockMark blockMark = {.marker = {blockMarker, blockMarker}, .timeUs = timeUs};
+
+    portENTER_CRITICAL(&ringLock);
+    size_t size = ring.write(&blockMark, sizeof(blockMark));
+    bool result = (size == sizeof(blockMark));
+    if (result == true)
+    {
+        captureStats.marks++;
+    }
+    else
+    {
+        captureStats.overruns++;
+    }
+    portEXIT_CRITICAL(&ringLock);
+
+    if (result == true)
+    {
+        lastMarkUs = timeUs;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Get statistics of the current (or the last) capture
+ *
+ * @return Capture statistics
+ */
+RawCapture::Stats RawCapture::stats()
+{
+    portENTER_CRITICAL(&ringLock);
+    Stats stats = captureStats;
+    portEXIT_CRITICAL(&ringLock);
+
+    return stats;
+}
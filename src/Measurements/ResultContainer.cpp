@@ -0,0 +1,97 @@
+/**
+ * @file ResultContainer.cpp
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Daily container of measurement results format implementation
+ * @version 0.1
+ * @date 2024-09-09
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include "Measurements/ResultContainer.h"
+
+#include <stddef.h>
+
+#include <FastCRC.h>
+
+using namespace Measurements;
+
+namespace
+{
+    // CRC calculator
+    FastCRC32 crc32;
+} // namespace
+
+/**
+ * @brief Make the trailer of the record
+ *
+ * @param[in] offset Offset of the record from the beginning of the file
+ * @param[in] time Epoch time of the record, seconds
+ * @return Record trailer
+ */
+ResultContainer::RecordTrailer ResultContainer::makeTrailer(uint32_t offset, uint32_t time)
+{
+    RecordTrailer trailer = {
+        .offset = offset,
+        .time = time,
+        .crc = 0,
+        .magic = trailerMagic,
+    };
+    trailer.crc = crc32.crc32(reinterpret_cast<const uint8_t *>(&trailer), offsetof(RecordTrailer, crc));
+
+    return trailer;
+}
+
+/**
+ * @brief Check the trailer of the record
+ *
+ * @param[in] trailer Record trailer
+ * @param[in] offset Offset of the record from the beginning of the file
+ * @return true if the trailer is valid and belongs to the record, false otherwise
+ */
+bool ResultContainer::checkTrailer(const RecordTrailer &trailer, uint32_t offset)
+{
+    bool result = (trailer.magic == trailerMagic && trailer.offset == offset);
+    if (result == true)
+    {
+        result = (crc32.crc32(reinterpret_cast<const uint8_t *>(&trailer), offsetof(RecordTrailer, crc)) == trailer.crc);
+    }
+
+    return result;
+}
+
+/**
+ * @brief Check the footer layout against the file
+ *
+ * @param[in] footer Container footer
+ * @param[in] fileSize Size of the file, bytes
+ * @return true if the footer and the index fit the file, false otherwise
+ */
+bool ResultContainer::checkFooter(const Footer &footer, size_t fileSize)
+{
+    return (footer.magic == magic && footer.version == version && footer.recordCount <= recordsMax &&
+            static_cast<size_t>(footer.indexOffset) + footer.recordCount * sizeof(IndexEntry) + sizeof(footer) == fileSize);
+}
+
+/**
+ * @brief Calculate CRC of the index and the footer fields preceding the CRC
+ *
+ * @param[in] entries Index entries (footer record count)
+ * @param[in] footer Container footer
+ * @return CRC value
+ */
+uint32_t ResultContainer::calculateCrc(const IndexEntry *entries, const Footer &footer)
+{
+    const uint8_t *footerBytes = reinterpret_cast<const uint8_t *>(&footer);
+    size_t indexSize = footer.recordCount * sizeof(*entries);
+
+    if (indexSize == 0)
+    {
+        return crc32.crc32(footerBytes, offsetof(Footer, crc));
+    }
+
+    crc32.crc32(reinterpret_cast<const uint8_t *>(entries), indexSize);
+
+    return crc32.crc32_upd(footerBytes, offsetof(Footer, crc));
+}
@@ -0,0 +1,274 @@
+/**
+ * @file ResultContainerWriter.cpp
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Daily container of measurement results writer implementation
+ * @version 0.1
+ * @date 2024-09-09
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include "Measurements/ResultContainer.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <Debug.hpp>
+
+#include "FileSD.hpp"
+
+using namespace Measurements;
+
+namespace
+{
+    // Container file extension
+    const char *fileExtension = "pdc";
+    // Maximum length of the container path
+    constexpr size_t pathMaxLength = 40;
+
+    // Index of the opened (or the last written) container
+    ResultContainer::IndexEntry indexEntries[ResultContainer::recordsMax];
+    // Number of records in the index
+    size_t recordCount = 0;
+    // Offset of the record being added (the index is written after it)
+    uint32_t recordOffset = 0;
+    // Path of the container the index belongs to
+    char indexPath[pathMaxLength + 1] = {0};
+    // Size of the container when the index was written (it's reused while the container isn't changed)
+    size_t indexFileSize = 0;
+
+    /**
+     * @brief Index loading status
+     */
+    enum class IndexStatus
+    {
+        Loaded,       // Index is loaded from the footer (or the container is empty)
+        Broken,       // Footer or index is broken, the index can be rebuilt from the record trailers
+        OtherVersion, // Container has the other format version
+    };
+
+    /**
+     * @brief Load the index of the opened container
+     *
+     * @param[in] file File of the container
+     * @return Index loading status
+     */
+    IndexStatus loadIndex(FileSD &file)
+    {
+        size_t fileSize = file.size();
+        if (fileSize == 0)
+        {
+            recordCount = 0;
+            recordOffset = 0;
+            return IndexStatus::Loaded;
+        }
+
+        ResultContainer::Footer footer;
+        bool result = (fileSize >= sizeof(footer));
+        if (result == true)
+        {
+            result = file.read(fileSize - sizeof(footer), &footer, sizeof(footer));
+        }
+        if (result == true && footer.magic == ResultContainer::magic && footer.version != ResultContainer::version)
+        {
+            return IndexStatus::OtherVersion;
+        }
+        if (result == true)
+        {
+            result = ResultContainer::checkFooter(footer, fileSize);
+        }
+        if (result == true && footer.recordCount > 0)
+        {
+            result = file.read(footer.indexOffset, indexEntries, footer.recordCount * sizeof(*indexEntries));
+        }
+        if (result == true)
+        {
+            result = (ResultContainer::calculateCrc(indexEntries, footer) == footer.crc);
+        }
+
+        if (result == true)
+        {
+            recordCount = footer.recordCount;
+            recordOffset = footer.indexOffset;
+        }
+
+        return (result == true) ? IndexStatus::Loaded : IndexStatus::Broken;
+    }
+
+    /**
+     * @brief Rebuild the index of the opened container from the record trailers
+     * The rest after the last whole record (the cut record or index) is dropped by the next record
+     *
+     * @param[in] file File of the container
+     * @return true if any record is found, false otherwise
+     */
+    bool recoverIndex(FileSD &file)
+    {
+        uint32_t endOffset = 0;
+        size_t count = ResultContainer::rebuildIndex([&file](size_t position, void *buffer, size_t size)
+                                                     { return file.read(position, buffer, size); },
+                                                     file.size(), indexEntries, ResultContainer::recordsMax, endOffset);
+
+        bool result = (count > 0);
+        if (result == true)
+        {
+            recordCount = count;
+            recordOffset = endOffset;
+        }
+
+        return result;
+    }
+} // namespace
+
+/**
+ * @brief Open the container (the first part with free index entries) and prepare it to add a record
+ * The record is written to the file by the usual file writings after that
+ *
+ * @param[out] file File to open the container in
+ * @param[in] directory Container directory
+ * @param[in] name Container name (parts have "_<part>" suffix)
+ * @return true if the container is ready to add a record, false otherwise
+ */
+bool ResultContainer::open(FileSD &file, const char *directory, const char *name)
+{
+    assert(directory);
+    assert(name);
+
+    bool result = false;
+
+    for (size_t part = 0; part < partsMax && result == false; part++)
+    {
+        char partName[pathMaxLength + 1];
+        if (part == 0)
+        {
+            snprintf(partName, sizeof(partName), "%s", name);
+        }
+        else
+        {
+            snprintf(partName, sizeof(partName), "%s_%u", name, part);
+        }
+
+        bool isOpen = file.create(directory, partName, fileExtension);
+        if (isOpen == false)
+        {
+            break;
+        }
+
+        char path[pathMaxLength + 1];
+        snprintf(path, sizeof(path), "%s/%s", directory, partName);
+
+        // Index stays in RAM while the container isn't changed by anybody else
+        if (strcmp(path, indexPath) == 0 && file.size() == indexFileSize)
+        {
+            result = true;
+        }
+        else
+        {
+            IndexStatus status = loadIndex(file);
+            result = (status == IndexStatus::Loaded);
+            if (status == IndexStatus::Broken)
+            {
+                result = recoverIndex(file);
+                if (result == true)
+                {
+                    LOG_WARNING("Container \"%s\" index is rebuilt: %u records, %u bytes after them are dropped",
+                                path, recordCount, file.size() - recordOffset);
+                }
+            }
+
+            if (result == true)
+            {
+                snprintf(indexPath, sizeof(indexPath), "%s", path);
+            }
+            else
+            {
+                LOG_ERROR("Container \"%s\" is broken, the next part is used", path);
+            }
+        }
+
+        if (result == true && recordCount >= recordsMax)
+        {
+            LOG_INFO("Container \"%s\" is full, the next part is used", path);
+            result = false;
+        }
+
+        if (result == true)
+        {
+            // Record replaces the index, the index is written again by close
+            result = file.truncate(recordOffset);
+        }
+
+        if (result == false)
+        {
+            indexPath[0] = '\0';
+            file.close();
+        }
+    }
+
+    if (result == false)
+    {
+        LOG_ERROR("Container \"%s/%s\" isn't opened", directory, name);
+    }
+
+    return result;
+}
+
+/**
+ * @brief Finish the record with the index and the footer, close the container
+ *
+ * @param[in] file File of the opened container
+ * @param[in] time Epoch time of the record, seconds
+ * @return true if the index is written, false otherwise
+ */
+bool ResultContainer::close(FileSD &file, uint32_t time)
+{
+    assert(recordCount < recordsMax);
+
+    indexEntries[recordCount] = {
+        .offset = recordOffset,
+        .time = time,
+    };
+    recordCount++;
+
+    // Trailer lets the index be rebuilt if the power fails before the footer is written
+    RecordTrailer trailer = makeTrailer(recordOffset, time);
+    bool result = file.write(&trailer, sizeof(trailer));
+
+    Footer footer = {
+        .indexOffset = static_cast<uint32_t>(file.size()),
+        .recordCount = static_cast<uint16_t>(recordCount),
+        .version = version,
+        .crc = 0,
+        .magic = magic,
+    };
+    footer.crc = calculateCrc(indexEntries, footer);
+
+    if (result == true)
+    {
+        result = file.write(indexEntries, recordCount * sizeof(*indexEntries));
+    }
+    if (result == true)
+    {
+        result = file.write(&footer, sizeof(footer));
+    }
+
+    indexFileSize = file.size();
+    recordOffset = footer.indexOffset;
+    file.close();
+
+    if (result == true)
+    {
+        LOG_DEBUG("Record %u at %u is added to container \"%s\"", recordCount, indexEntries[recordCount - 1].offset, indexPath);
+    }
+    else
+    {
+        LOG_ERROR("Container \"%s\" index isn't written", indexPath);
+        // Index in RAM doesn't match the file any more
+        indexPath[0] = '\0';
+    }
+
+    return result;
+}
@@ -17,6 +17,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "Measurements/Kernels.h"
+
 using namespace Measurements;
 
 /**
@@ -53,24 +55,17 @@ void Statistic<Type>::calculate(const Type *data, size_t size)
         _deviation = 0;
     }
 
-    for (size_t idx = 0; idx < size; idx++)
-    {
-        Type value = data[idx];
-
-        updateMaxMin(value);
+    // Update maximum/minimum with the data set extremes
+    updateMaxMin(Kernels::min(data, size));
+    updateMaxMin(Kernels::max(data, size));
 
-        _mean += static_cast<double>(value);
-    }
+    double sum = static_cast<double>(Kernels::sum(data, size));
 
     // Calculate average
-    _mean /= size;
+    _mean = (_mean + sum) / size;
 
-    for (size_t idx = 0; idx < size; idx++)
-    {
-        double diff = static_cast<double>(data[idx]) - _mean;
-
-        _deviation += (diff * diff);
-    }
+    // Sum of squared differences from the average (centred, doesn't cancel for small deviations of large values)
+    _deviation += Kernels::sumSquares(data, size, _mean);
 
     // Calculate standard deviation
     _deviation /= size;
@@ -102,6 +102,16 @@ void SerialDevice::stop()
     }
 }
 
+/**
+ * @brief Set the handler called when new data is received by the serial interface
+ *
+ * @param handler Handler function
+ */
+void SerialDevice::onReceive(SerialInterface::ReceiveHandler handler)
+{
+    _serialInterface.onReceive(handler);
+}
+
 /**
  * @brief Print data to serial device
  *
@@ -138,6 +148,14 @@ SerialDevice::InputStatus SerialDevice::process()
 
     if (_isActive == true)
     {
+        // Check incoming message receiving timeout before the new characters, the loop task may be called
+        // only when they come, so the stale part of the message doesn't take the next message
+        if (_state != State::Start && _elapsed > comingMaxTimeMs)
+        {
+            // Reset state to Start by timeout
+            setState(State::Start);
+        }
+
         // Try to get new character from serial input
         while (_serialInterface.available() && inputStatus == InputStatus::Continue)
         {
@@ -153,13 +171,6 @@ SerialDevice::InputStatus SerialDevice::process()
         {
             sendNack();
         }
-
-        // Check incoming message receiving timeout
-        if (_state != State::Start && _elapsed > comingMaxTimeMs)
-        {
-            // Reset state to Start by timeout
-            setState(State::Start);
-        }
     }
 
     return inputStatus;
@@ -370,6 +370,20 @@ void Manager::process()
     }
 }
 
+/**
+ * @brief Set the handler called when any serial device receives new data
+ * Lets the main loop sleep until the input comes instead of polling devices
+ *
+ * @param handler Handler function
+ */
+void Manager::onReceive(ReceiveHandler &&handler)
+{
+    for (auto &device : serialDevices)
+    {
+        device.onReceive(handler);
+    }
+}
+
 /**
  * @brief Subscribe to specified read command to provide read data
  * May be only one subscriber that provides read data
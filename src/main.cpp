@@ -76,7 +76,10 @@ void registerSerialReadHandlers()
     Serials::Manager::subscribeToRead(Serials::CommandId::BatteryStatus,
                                       [](const char **responseString)
                                       {
+                                          // Battery measurement detaches SPI pins of SD card, written by other tasks
+                                          FileSD::lock();
                                           const auto &batteryStatus = Battery::readStatus();
+                                          FileSD::unlock();
 
                                           snprintf(dataString, sizeof(dataString), "%umV %u%%",
                                                    batteryStatus.voltage, batteryStatus.level);
@@ -116,6 +119,8 @@ void registerSerialWriteHandlers()
  */
 void setup()
 {
+    uint32_t setupStartMs = millis();
+
     // Setup the board first
     Board::setup();
 
@@ -138,12 +143,8 @@ void setup()
         LOG_ERROR("System time initialization failed");
     }
 
-    // Start SD file system
-    status = FileSD::startFileSystem(Board::SpiConfig::frequency);
-    if (status == false)
-    {
-        LOG_ERROR("SD initialization failed");
-    }
+    // Start SD file system, the card is mounted in background while measurements run
+    FileSD::startFileSystem(Board::SpiConfig::frequency);
 
     status = Measurements::Manager::initialize();
     if (status == false)
@@ -151,7 +152,7 @@ void setup()
         LOG_ERROR("Measurements initialization failed");
     }
 
-    LOG_INFO("Setup done");
+    LOG_INFO("Setup done in %u ms", millis() - setupStartMs);
 }
 
 /**
@@ -162,6 +163,6 @@ void loop()
     // Receive and handle serial commands from serial devices (if available)
     Serials::Manager::process();
 
-    // Perform sensor input data processing (if needed)
+    // Perform sensor input data processing (if needed), sleeps until the measurement or serial input
     Measurements::Manager::process();
 }
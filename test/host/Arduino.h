@@ -0,0 +1,174 @@
+/**
+ * @file Arduino.h
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Host stand-in of Arduino core for native tests
+ * @version 0.1
+ * @date 2024-08-14
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <chrono>
+#include <thread>
+
+// Arduino core is built with its version defined, libraries (SdFat) check it
+#ifndef ARDUINO
+#define ARDUINO 10819
+#endif
+
+typedef uint8_t byte;
+
+// Bit masks of ESP-IDF (esp_bit_defs.h comes with the core)
+#define BIT15 0x00008000
+#define BIT14 0x00004000
+#define BIT13 0x00002000
+#define BIT12 0x00001000
+#define BIT11 0x00000800
+#define BIT10 0x00000400
+#define BIT9 0x00000200
+#define BIT8 0x00000100
+#define BIT7 0x00000080
+#define BIT6 0x00000040
+#define BIT5 0x00000020
+#define BIT4 0x00000010
+#define BIT3 0x00000008
+#define BIT2 0x00000004
+#define BIT1 0x00000002
+#define BIT0 0x00000001
+
+/**
+ * @brief Get host time since the first call, microseconds
+ *
+ * @return Time, microseconds
+ */
+inline unsigned long micros()
+{
+    static const auto start = std::chrono::steady_clock::now();
+    return static_cast<unsigned long>(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+/**
+ * @brief Get host time since the first call, milliseconds
+ *
+ * @return Time, milliseconds
+ */
+inline unsigned long millis()
+{
+    return micros() / 1000;
+}
+
+/**
+ * @brief Sleep for given time, tests don't need the exact delay
+ *
+ * @param[in] ms Time, milliseconds
+ */
+inline void delay(unsigned long ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+/**
+ * @brief Sleep for given time
+ *
+ * @param[in] us Time, microseconds
+ */
+inline void delayMicroseconds(unsigned int us)
+{
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+/**
+ * @brief Interrupts are host threads, module code guards shared data by its own locks
+ */
+inline void noInterrupts()
+{
+}
+
+/**
+ * @brief Interrupts are host threads, module code guards shared data by its own locks
+ */
+inline void interrupts()
+{
+}
+
+/**
+ * @brief Byte output (base of the serial ports, files and buffers)
+ */
+class Print
+{
+public:
+    virtual ~Print() = default;
+
+    /**
+     * @brief Write a byte
+     *
+     * @param[in] data Byte to write
+     * @return Number of written bytes
+     */
+    virtual size_t write(uint8_t data) = 0;
+
+    /**
+     * @brief Write bytes
+     *
+     * @param[in] buffer Bytes to write
+     * @param[in] size Number of bytes
+     * @return Number of written bytes
+     */
+    virtual size_t write(const uint8_t *buffer, size_t size)
+    {
+        size_t count = 0;
+        while (count < size && write(buffer[count]) == 1)
+        {
+            count++;
+        }
+
+        return count;
+    }
+
+    /**
+     * @brief Write zero terminated string
+     *
+     * @param[in] string String to write
+     * @return Number of written bytes
+     */
+    size_t write(const char *string)
+    {
+        return (string != nullptr) ? write(reinterpret_cast<const uint8_t *>(string), strlen(string)) : 0;
+    }
+
+    int getWriteError()
+    {
+        return _writeError;
+    }
+
+    void clearWriteError()
+    {
+        _writeError = 0;
+    }
+
+protected:
+    void setWriteError(int error = 1)
+    {
+        _writeError = error;
+    }
+
+private:
+    int _writeError = 0; // Write error code
+};
+
+/**
+ * @brief Byte input and output, tests don't read streams
+ */
+class Stream : public Print
+{
+};
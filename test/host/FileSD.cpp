@@ -0,0 +1,70 @@
+/**
+ * @file FileSD.cpp
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Host stand-in of the SD file system for native tests, the card is the "sd" directory of the host temporary path
+ * @version 0.1
+ * @date 2024-09-06
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include "FileSD.hpp"
+
+#include <assert.h>
+
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace
+{
+    // SD card access mutex
+    std::recursive_mutex sdMutex;
+    // Opened directories by their card paths
+    std::map<std::string, std::unique_ptr<FsFile>> directories;
+} // namespace
+
+/**
+ * @brief Lock SD card access
+ */
+void FileSD::lock()
+{
+    sdMutex.lock();
+}
+
+/**
+ * @brief Unlock SD card access
+ */
+void FileSD::unlock()
+{
+    sdMutex.unlock();
+}
+
+/**
+ * @brief Get the opened directory, the directory is created if it doesn't exist
+ *
+ * @param[in] directory Directory path (nested directories are separated by "/")
+ * @return Directory handle, nullptr if the directory can't be opened
+ */
+FsFile *FileSD::directory(const char *directory)
+{
+    assert(directory);
+
+    std::lock_guard<std::recursive_mutex> lock(sdMutex);
+
+    auto &handle = directories[directory];
+    if (handle == nullptr)
+    {
+        std::filesystem::path path = std::filesystem::temp_directory_path() / "sd" / directory;
+        std::error_code error;
+        std::filesystem::create_directories(path, error);
+
+        handle = std::make_unique<FsFile>();
+        handle->open(path.c_str());
+    }
+
+    return handle->isOpen() ? handle.get() : nullptr;
+}
@@ -0,0 +1,233 @@
+/**
+ * @file SdFat.h
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Host stand-in of SdFat files for native tests, files are host files and writes take the modelled card time
+ * @version 0.1
+ * @date 2024-09-06
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#pragma once
+
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+typedef int oflag_t;
+
+/**
+ * @brief SD card write timing model
+ * Every write takes writeUs, every stallPeriod write takes stallUs more (card internal erase and wear levelling)
+ */
+struct SdCardModel
+{
+    uint32_t writeUs;     // Time of the write, microseconds
+    uint32_t stallPeriod; // Number of writes between the stalls (0 no stalls)
+    uint32_t stallUs;     // Time of the stall, microseconds
+};
+
+/**
+ * @brief File or directory on the host file system
+ */
+class FsFile
+{
+public:
+    // Timing of the writes of all files
+    inline static SdCardModel cardModel = {0, 0, 0};
+
+    FsFile() : _file(nullptr), _isDirectory(false), _writes(0)
+    {
+    }
+
+    ~FsFile()
+    {
+        close();
+    }
+
+    FsFile(const FsFile &) = delete;
+    FsFile &operator=(const FsFile &) = delete;
+
+    /**
+     * @brief Open file or directory
+     *
+     * @param[in] path Host path
+     * @param[in] oflag Open flags (O_RDONLY, O_RDWR, O_CREAT, O_TRUNC)
+     * @return true if opened, false otherwise
+     */
+    bool open(const char *path, oflag_t oflag = O_RDONLY)
+    {
+        close();
+
+        struct stat status;
+        if (stat(path, &status) == 0 && S_ISDIR(status.st_mode))
+        {
+            _path = path;
+            _isDirectory = true;
+            return true;
+        }
+
+        const char *mode = (oflag & O_TRUNC) ? "w+b" : ((oflag & O_RDWR) ? "r+b" : "rb");
+        _file = fopen(path, mode);
+        if (_file == nullptr && (oflag & O_CREAT))
+        {
+            _file = fopen(path, "w+b");
+        }
+        if (_file != nullptr)
+        {
+            _path = path;
+            _writes = 0;
+        }
+
+        return (_file != nullptr);
+    }
+
+    /**
+     * @brief Open file or directory in the directory
+     *
+     * @param[in] directory Opened directory
+     * @param[in] path Path relative to the directory
+     * @param[in] oflag Open flags
+     * @return true if opened, false otherwise
+     */
+    bool open(FsFile *directory, const char *path, oflag_t oflag = O_RDONLY)
+    {
+        if (directory == nullptr || directory->_isDirectory == false)
+        {
+            return false;
+        }
+
+        return open((directory->_path + "/" + path).c_str(), oflag);
+    }
+
+    /**
+     * @brief Close file or directory
+     *
+     * @return true always
+     */
+    bool close()
+    {
+        if (_file != nullptr)
+        {
+            fclose(_file);
+            _file = nullptr;
+        }
+        _isDirectory = false;
+        _path.clear();
+
+        return true;
+    }
+
+    bool isOpen() const
+    {
+        return (_file != nullptr || _isDirectory == true);
+    }
+
+    bool isDir() const
+    {
+        return _isDirectory;
+    }
+
+    explicit operator bool() const
+    {
+        return isOpen();
+    }
+
+    /**
+     * @brief Preallocate file space, host files have no clusters to allocate
+     *
+     * @param[in] length Length to preallocate, bytes
+     * @return true if the file is opened, false otherwise
+     */
+    bool preAllocate(uint64_t length)
+    {
+        return (_file != nullptr);
+    }
+
+    /**
+     * @brief Write data at the current position, the call takes the modelled card time
+     *
+     * @param[in] buffer Data to write
+     * @param[in] size Number of bytes
+     * @return Number of written bytes
+     */
+    size_t write(const void *buffer, size_t size)
+    {
+        if (_file == nullptr)
+        {
+            return 0;
+        }
+
+        _writes++;
+        uint32_t us = cardModel.writeUs;
+        if (cardModel.stallPeriod > 0 && _writes % cardModel.stallPeriod == 0)
+        {
+            us += cardModel.stallUs;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+
+        return fwrite(buffer, 1, size, _file);
+    }
+
+    /**
+     * @brief Read data at the current position
+     *
+     * @param[out] buffer Buffer to read to
+     * @param[in] size Number of bytes
+     * @return Number of read bytes, -1 on failure
+     */
+    int read(void *buffer, size_t size)
+    {
+        if (_file == nullptr)
+        {
+            return -1;
+        }
+
+        return static_cast<int>(fread(buffer, 1, size, _file));
+    }
+
+    /**
+     * @brief Cut the file at the current position
+     *
+     * @return true if the file is cut, false otherwise
+     */
+    bool truncate()
+    {
+        if (_file == nullptr || fflush(_file) != 0)
+        {
+            return false;
+        }
+
+        return (ftruncate(fileno(_file), ftell(_file)) == 0);
+    }
+
+    /**
+     * @brief Get file size
+     *
+     * @return File size, bytes
+     */
+    uint64_t size()
+    {
+        if (_file == nullptr || fflush(_file) != 0)
+        {
+            return 0;
+        }
+
+        struct stat status;
+        return (fstat(fileno(_file), &status) == 0) ? status.st_size : 0;
+    }
+
+private:
+    std::string _path;  // Host path
+    FILE *_file;        // Host file (nullptr for directories)
+    bool _isDirectory;  // Opened object is a directory
+    uint32_t _writes;   // Number of writes since opening
+};
@@ -0,0 +1,207 @@
+/**
+ * @file Wire.h
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Host stand-in of Arduino I2C bus for native tests, transactions are passed to a register-level device model
+ * @version 0.1
+ * @date 2024-08-14
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief I2C device model
+ * The register pointer is set by the first written byte, next bytes are written to the registers.
+ * Every register access moves the pointer by the device rules (see @ref nextRegister).
+ */
+class I2cDevice
+{
+public:
+    virtual ~I2cDevice() = default;
+
+    /**
+     * @brief Write a register
+     *
+     * @param[in] address Register address
+     * @param[in] value Register value
+     */
+    virtual void writeRegister(uint8_t address, uint8_t value) = 0;
+
+    /**
+     * @brief Read a register
+     *
+     * @param[in] address Register address
+     * @return Register value
+     */
+    virtual uint8_t readRegister(uint8_t address) = 0;
+
+    /**
+     * @brief Get the register address of the next access, registers auto increment by default
+     *
+     * @param[in] address Register address of the current access
+     * @return Register address of the next access
+     */
+    virtual uint8_t nextRegister(uint8_t address)
+    {
+        return address + 1;
+    }
+};
+
+/**
+ * @brief I2C bus stand-in, a single device is attached
+ */
+class TwoWire
+{
+    constexpr static size_t bufferSize = 128; // Same as ESP32 Arduino I2C buffer
+
+public:
+    /**
+     * @brief Attach a device model to the bus
+     *
+     * @param[in] device Device model, nullptr to detach
+     * @param[in] address Device I2C address
+     */
+    void attach(I2cDevice *device, uint8_t address)
+    {
+        _device = device;
+        _address = address;
+    }
+
+    /**
+     * @brief Fail transactions (device NACKs)
+     *
+     * @param[in] count Number of failing transactions
+     * @param[in] after Number of successful transactions before the first failure
+     */
+    void failTransactions(size_t count, size_t after = 0)
+    {
+        _failures = count;
+        _failuresAfter = after;
+    }
+
+    /**
+     * @brief Get number of bus transactions
+     *
+     * @return Number of transactions
+     */
+    size_t transactions() const
+    {
+        return _transactions;
+    }
+
+    void beginTransmission(uint8_t address)
+    {
+        _txAddress = address;
+        _txLength = 0;
+    }
+
+    size_t write(uint8_t value)
+    {
+        if (_txLength >= bufferSize)
+        {
+            return 0;
+        }
+
+        _txBuffer[_txLength++] = value;
+
+        return 1;
+    }
+
+    uint8_t endTransmission(bool sendStop = true)
+    {
+        (void)sendStop;
+
+        _transactions++;
+
+        if (isAcknowledged(_txAddress) == false)
+        {
+            return 2; // Address NACK
+        }
+
+        if (_txLength > 0)
+        {
+            _register = _txBuffer[0];
+            for (size_t idx = 1; idx < _txLength; idx++)
+            {
+                _device->writeRegister(_register, _txBuffer[idx]);
+                _register = _device->nextRegister(_register);
+            }
+        }
+
+        return 0;
+    }
+
+    uint8_t requestFrom(uint8_t address, size_t size)
+    {
+        _transactions++;
+
+        _rxLength = 0;
+        _rxIndex = 0;
+
+        if (isAcknowledged(address) == false || size > bufferSize)
+        {
+            return 0;
+        }
+
+        for (size_t idx = 0; idx < size; idx++)
+        {
+            _rxBuffer[idx] = _device->readRegister(_register);
+            _register = _device->nextRegister(_register);
+        }
+        _rxLength = size;
+
+        return static_cast<uint8_t>(size);
+    }
+
+    int available()
+    {
+        return static_cast<int>(_rxLength - _rxIndex);
+    }
+
+    int read()
+    {
+        if (_rxIndex >= _rxLength)
+        {
+            return -1;
+        }
+
+        return _rxBuffer[_rxIndex++];
+    }
+
+private:
+    bool isAcknowledged(uint8_t address)
+    {
+        if (_failuresAfter > 0)
+        {
+            _failuresAfter--;
+        }
+        else if (_failures > 0)
+        {
+            _failures--;
+            return false;
+        }
+
+        return _device != nullptr && address == _address;
+    }
+
+    I2cDevice *_device = nullptr;
+    uint8_t _address = 0;
+    size_t _failures = 0;
+    size_t _failuresAfter = 0;
+    size_t _transactions = 0;
+
+    uint8_t _register = 0;
+    uint8_t _txAddress = 0;
+    uint8_t _txBuffer[bufferSize];
+    size_t _txLength = 0;
+    uint8_t _rxBuffer[bufferSize];
+    size_t _rxLength = 0;
+    size_t _rxIndex = 0;
+};
+
+inline TwoWire Wire;
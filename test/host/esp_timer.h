@@ -0,0 +1,27 @@
+/**
+ * @file esp_timer.h
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Host stand-in of ESP-IDF system timer for native tests
+ * @version 0.1
+ * @date 2024-09-06
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <chrono>
+
+/**
+ * @brief Get host time since the first call, microseconds
+ *
+ * @return Time, microseconds
+ */
+inline int64_t esp_timer_get_time()
+{
+    static const auto start = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,52 @@
+/**
+ * @file FreeRTOS.h
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Host stand-in of FreeRTOS types and port macros for native tests
+ * @version 0.1
+ * @date 2024-08-14
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <mutex>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdFALSE ((BaseType_t)0)
+#define pdTRUE ((BaseType_t)1)
+#define pdFAIL (pdFALSE)
+#define pdPASS (pdTRUE)
+
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFUL)
+#define configTICK_RATE_HZ (1000)
+#define portTICK_PERIOD_MS ((TickType_t)1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(xTimeInMs) ((TickType_t)(((TickType_t)(xTimeInMs) * (TickType_t)configTICK_RATE_HZ) / (TickType_t)1000U))
+
+// Host "interrupts" run in a thread, there is no scheduler to yield to
+#define portYIELD_FROM_ISR()
+
+// Critical section spinlock is a host mutex, "interrupts" and tasks are host threads
+typedef std::mutex portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED {}
+#define portENTER_CRITICAL(mux) (mux)->lock()
+#define portEXIT_CRITICAL(mux) (mux)->unlock()
+
+// Host tests run module code on a single "core"
+#define portNUM_PROCESSORS (1)
+
+inline BaseType_t xPortGetCoreID()
+{
+    return 0;
+}
+
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
@@ -0,0 +1,105 @@
+/**
+ * @file event_groups.h
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Host stand-in of FreeRTOS event groups for native tests, "interrupts" are host threads
+ * @version 0.1
+ * @date 2024-08-14
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#include "freertos/FreeRTOS.h"
+
+typedef uint32_t EventBits_t;
+
+/**
+ * @brief Event group data, the bits are guarded by the mutex
+ * Tasks wait forever, so the mutex and the condition aren't destroyed at exit under the waiting host threads
+ */
+struct StaticEventGroup_t
+{
+    std::mutex &mutex = *new std::mutex;
+    std::condition_variable &condition = *new std::condition_variable;
+    EventBits_t bits;
+};
+
+typedef StaticEventGroup_t *EventGroupHandle_t;
+
+inline EventGroupHandle_t xEventGroupCreateStatic(StaticEventGroup_t *buffer)
+{
+    buffer->bits = 0;
+    return buffer;
+}
+
+inline EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits)
+{
+    std::lock_guard<std::mutex> lock(group->mutex);
+    group->bits |= bits;
+    group->condition.notify_all();
+
+    return group->bits;
+}
+
+inline EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits)
+{
+    std::lock_guard<std::mutex> lock(group->mutex);
+    EventBits_t previous = group->bits;
+    group->bits &= ~bits;
+
+    return previous;
+}
+
+inline BaseType_t xEventGroupSetBitsFromISR(EventGroupHandle_t group, EventBits_t bits, BaseType_t *higherPriorityTaskWoken)
+{
+    xEventGroupSetBits(group, bits);
+    *higherPriorityTaskWoken = pdFALSE;
+
+    return pdPASS;
+}
+
+inline BaseType_t xEventGroupClearBitsFromISR(EventGroupHandle_t group, EventBits_t bits)
+{
+    xEventGroupClearBits(group, bits);
+
+    return pdPASS;
+}
+
+/**
+ * @brief Wait bits, the result is the group bits before clearing (timeout too), same as FreeRTOS
+ */
+inline EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clearOnExit,
+                                       BaseType_t waitForAllBits, TickType_t ticks)
+{
+    std::unique_lock<std::mutex> lock(group->mutex);
+
+    auto isSet = [&]()
+    {
+        return (waitForAllBits == pdTRUE) ? ((group->bits & bits) == bits) : ((group->bits & bits) != 0);
+    };
+
+    bool result;
+    if (ticks == portMAX_DELAY)
+    {
+        group->condition.wait(lock, isSet);
+        result = true;
+    }
+    else
+    {
+        result = group->condition.wait_for(lock, std::chrono::milliseconds(ticks * portTICK_PERIOD_MS), isSet);
+    }
+
+    EventBits_t value = group->bits;
+    if (result == true && clearOnExit == pdTRUE)
+    {
+        group->bits &= ~bits;
+    }
+
+    return value;
+}
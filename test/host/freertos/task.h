@@ -0,0 +1,92 @@
+/**
+ * @file task.h
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Host stand-in of FreeRTOS task timing for native tests, OS tick is the host millisecond
+ * @version 0.1
+ * @date 2024-08-14
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#pragma once
+
+#include <chrono>
+#include <thread>
+
+#include "freertos/FreeRTOS.h"
+
+typedef void (*TaskFunction_t)(void *);
+typedef void *TaskHandle_t;
+
+/**
+ * @brief Start the task as a detached host thread, priority, stack size and core aren't modelled
+ *
+ * @param[in] function Task function
+ * @param[in] name Task name
+ * @param[in] stackSize Task stack size, bytes
+ * @param[in] parameters Task parameters
+ * @param[in] priority Task priority
+ * @param[out] handle Task handle (nullptr, tasks aren't controlled)
+ * @param[in] core Task core
+ * @return pdPASS always
+ */
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *name, uint32_t stackSize, void *parameters,
+                                          UBaseType_t priority, TaskHandle_t *handle, BaseType_t core)
+{
+    std::thread(function, parameters).detach();
+    if (handle != nullptr)
+    {
+        *handle = nullptr;
+    }
+
+    return pdPASS;
+}
+
+/**
+ * @brief Get host time since the first call, OS ticks
+ *
+ * @return Time, OS ticks
+ */
+inline TickType_t xTaskGetTickCount()
+{
+    static const auto start = std::chrono::steady_clock::now();
+    return static_cast<TickType_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() /
+        portTICK_PERIOD_MS);
+}
+
+/**
+ * @brief Sleep the calling thread
+ *
+ * @param[in] ticks Time, OS ticks
+ */
+inline void vTaskDelay(TickType_t ticks)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks * portTICK_PERIOD_MS));
+}
+
+/**
+ * @brief Sleep the calling thread until the next wake up time
+ *
+ * @param[in,out] previousWakeTime Time of the previous wake up, OS ticks
+ * @param[in] ticks Period, OS ticks
+ * @return pdTRUE if the thread was delayed, pdFALSE if the wake up time was missed
+ */
+inline BaseType_t xTaskDelayUntil(TickType_t *previousWakeTime, TickType_t ticks)
+{
+    TickType_t wakeTime = *previousWakeTime + ticks;
+    TickType_t now = xTaskGetTickCount();
+
+    *previousWakeTime = wakeTime;
+
+    // Same as FreeRTOS, the time is compared with the tick counter overflow taken into account
+    if (static_cast<int32_t>(wakeTime - now) <= 0)
+    {
+        return pdFALSE;
+    }
+
+    vTaskDelay(wakeTime - now);
+
+    return pdTRUE;
+}
@@ -0,0 +1,211 @@
+/**
+ * @file test_block_ring.cpp
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Host tests of the lock-free single producer single consumer ring, two-thread stress included
+ * @version 0.1
+ * @date 2024-08-26
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <thread>
+
+#include <unity.h>
+
+#include "Measurements/BlockRing.h"
+
+using namespace Measurements;
+
+namespace
+{
+    constexpr size_t slotCount = 3;
+    // Block size, words (several cache lines, torn blocks are visible)
+    constexpr size_t blockSize = 64;
+    // Number of blocks produced by the stress test
+    constexpr size_t stressBlocks = 200000;
+
+    BlockRing ring;
+    uint32_t blocks[slotCount][blockSize];
+} // namespace
+
+void setUp(void)
+{
+    ring.reset(slotCount);
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief Blocks are consumed in order, full ring drops new blocks and counts overruns
+ */
+void test_fill_and_drain(void)
+{
+    size_t slot = 0;
+    size_t peekSlot = 0;
+
+    TEST_ASSERT_FALSE(ring.peek(peekSlot));
+
+    for (size_t idx = 0; idx < slotCount; idx++)
+    {
+        TEST_ASSERT_TRUE(ring.acquire(slot));
+        TEST_ASSERT_EQUAL_size_t(idx, slot);
+        // Acquiring again without commit returns the same slot
+        TEST_ASSERT_TRUE(ring.acquire(slot));
+        TEST_ASSERT_EQUAL_size_t(idx, slot);
+        ring.commit();
+    }
+
+    TEST_ASSERT_FALSE(ring.acquire(slot));
+    TEST_ASSERT_FALSE(ring.acquire(slot));
+
+    BlockRing::Stats stats = ring.stats();
+    TEST_ASSERT_EQUAL_size_t(slotCount, stats.depth);
+    TEST_ASSERT_EQUAL_size_t(slotCount, stats.depthMax);
+    TEST_ASSERT_EQUAL_size_t(slotCount, stats.committed);
+    TEST_ASSERT_EQUAL_size_t(2, stats.overruns);
+
+    for (size_t idx = 0; idx < slotCount; idx++)
+    {
+        TEST_ASSERT_TRUE(ring.peek(peekSlot));
+        TEST_ASSERT_EQUAL_size_t(idx, peekSlot);
+        ring.release();
+    }
+
+    TEST_ASSERT_FALSE(ring.peek(peekSlot));
+    TEST_ASSERT_TRUE(ring.acquire(slot));
+    TEST_ASSERT_EQUAL_size_t(0, slot);
+    TEST_ASSERT_EQUAL_size_t(0, ring.stats().depth);
+}
+
+/**
+ * @brief Reset clears blocks and statistics
+ */
+void test_reset(void)
+{
+    size_t slot = 0;
+
+    for (size_t idx = 0; idx < slotCount + 1; idx++)
+    {
+        if (ring.acquire(slot) == true)
+        {
+            ring.commit();
+        }
+    }
+
+    ring.reset(slotCount + 1);
+
+    BlockRing::Stats stats = ring.stats();
+    TEST_ASSERT_EQUAL_size_t(slotCount + 1, ring.slotCount());
+    TEST_ASSERT_EQUAL_size_t(0, stats.depth);
+    TEST_ASSERT_EQUAL_size_t(0, stats.depthMax);
+    TEST_ASSERT_EQUAL_size_t(0, stats.committed);
+    TEST_ASSERT_EQUAL_size_t(0, stats.overruns);
+    TEST_ASSERT_FALSE(ring.peek(slot));
+}
+
+/**
+ * @brief Producer and consumer threads: no torn, lost, duplicated or reordered blocks
+ * Every word of the block holds the block sequence number, the consumer checks all of them
+ */
+void test_two_thread_stress(void)
+{
+    std::atomic<bool> isProduced{false};
+    size_t dropped = 0;
+    size_t consumed = 0;
+    size_t tornBlocks = 0;
+    size_t orderErrors = 0;
+
+    std::thread producer([&]()
+                         {
+                             uint32_t sequence = 1;
+                             while (sequence <= stressBlocks)
+                             {
+                                 size_t slot;
+                                 if (ring.acquire(slot) == false)
+                                 {
+                                     // Ring is full, the block is dropped like IMU task drops the segment
+                                     dropped++;
+                                     sequence++;
+                                     std::this_thread::yield();
+                                     continue;
+                                 }
+
+                                 for (size_t idx = 0; idx < blockSize; idx++)
+                                 {
+                                     blocks[slot][idx] = sequence;
+                                 }
+                                 ring.commit();
+                                 sequence++;
+                             }
+
+                             isProduced = true;
+                         });
+
+    std::thread consumer([&]()
+                         {
+                             uint32_t lastSequence = 0;
+                             while (true)
+                             {
+                                 size_t slot;
+                                 if (ring.peek(slot) == false)
+                                 {
+                                     if (isProduced == true && ring.peek(slot) == false)
+                                     {
+                                         break;
+                                     }
+                                     std::this_thread::yield();
+                                     continue;
+                                 }
+
+                                 uint32_t sequence = blocks[slot][0];
+                                 for (size_t idx = 1; idx < blockSize; idx++)
+                                 {
+                                     if (blocks[slot][idx] != sequence)
+                                     {
+                                         tornBlocks++;
+                                         break;
+                                     }
+                                 }
+                                 if (sequence <= lastSequence)
+                                 {
+                                     orderErrors++;
+                                 }
+                                 lastSequence = sequence;
+
+                                 // Data is still read while the slot isn't released, producer can't touch it
+                                 ring.release();
+                                 consumed++;
+                             }
+                         });
+
+    producer.join();
+    consumer.join();
+
+    BlockRing::Stats stats = ring.stats();
+
+    TEST_ASSERT_EQUAL_size_t(0, tornBlocks);
+    TEST_ASSERT_EQUAL_size_t(0, orderErrors);
+    TEST_ASSERT_EQUAL_size_t(stressBlocks, consumed + dropped);
+    TEST_ASSERT_EQUAL_size_t(consumed, stats.committed);
+    TEST_ASSERT_EQUAL_size_t(dropped, stats.overruns);
+    TEST_ASSERT_EQUAL_size_t(0, stats.depth);
+    TEST_ASSERT_TRUE(stats.depthMax <= slotCount);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_fill_and_drain);
+    RUN_TEST(test_reset);
+    RUN_TEST(test_two_thread_stress);
+
+    return UNITY_END();
+}
@@ -0,0 +1,182 @@
+/**
+ * @file test_float_format.cpp
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Host tests of the fast "%G" formatting against the library printf
+ * @version 0.1
+ * @date 2024-09-05
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <limits>
+#include <random>
+
+#include <unity.h>
+
+#include <FloatFormat.hpp>
+
+namespace
+{
+    // Number of random values of every fuzz test
+    constexpr size_t fuzzCount = 2000000;
+    // Number of reported mismatches
+    constexpr size_t reportMax = 5;
+
+    /**
+     * @brief Format value by both formatters and compare the strings
+     *
+     * @param[in] value Value to format
+     * @return true if strings are the same, false otherwise
+     */
+    bool isFormattedAsPrintf(double value)
+    {
+        char actual[FloatFormat::lengthMax + 1];
+        size_t length = FloatFormat::formatG(actual, value);
+        actual[length] = '\0';
+
+        char expected[32];
+        snprintf(expected, sizeof(expected), "%G", value);
+
+        bool result = (strcmp(actual, expected) == 0);
+        if (result == false)
+        {
+            char message[96];
+            snprintf(message, sizeof(message), "%a: \"%s\" instead of \"%s\"", value, actual, expected);
+            TEST_MESSAGE(message);
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Format random values and count mismatches
+     *
+     * @param[in] generate Generator of the next value, returns false if the value should be skipped
+     * @return Number of mismatches
+     */
+    template <typename Generator>
+    size_t fuzz(Generator generate)
+    {
+        size_t mismatches = 0;
+
+        for (size_t idx = 0; idx < fuzzCount; idx++)
+        {
+            double value;
+            if (generate(value) == false)
+            {
+                continue;
+            }
+
+            if (isFormattedAsPrintf(value) == false)
+            {
+                mismatches++;
+                if (mismatches >= reportMax)
+                {
+                    break;
+                }
+            }
+        }
+
+        return mismatches;
+    }
+} // namespace
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief Notation switches, rounding carries, ties, subnormals and special values
+ */
+void test_edge_values(void)
+{
+    const double values[] = {
+        0.0, -0.0, 1, -1, 0.5, 10, 100000, 999999, 999999.4, 999999.5, 1e6, 1234567,
+        0.0001, 0.00009999995, 0.000099999949, 1e-5, 9.999995, 9.9999949, 0.1, 0.2, 0.3,
+        1.0000005, 2.5e-7, 1.5, 12345.65, 1e22, 1e23, 1e-22, 1e-23, 1e100, 1e-100, 1e300, 1e-300,
+        std::numeric_limits<double>::max(), std::numeric_limits<double>::min(),
+        std::numeric_limits<double>::denorm_min(), std::numeric_limits<float>::max(),
+        std::numeric_limits<float>::min(), std::numeric_limits<float>::denorm_min(),
+        INFINITY, -INFINITY, NAN};
+
+    for (double value : values)
+    {
+        TEST_ASSERT_TRUE(isFormattedAsPrintf(value));
+    }
+}
+
+/**
+ * @brief Values of the whole range of double bit patterns
+ */
+void test_fuzz_double_bits(void)
+{
+    std::mt19937_64 generator(43);
+
+    size_t mismatches = fuzz([&generator](double &value)
+                             {
+                                 uint64_t bits = generator();
+                                 memcpy(&value, &bits, sizeof(value));
+                                 return isfinite(value) != 0;
+                             });
+
+    TEST_ASSERT_EQUAL_size_t(0, mismatches);
+}
+
+/**
+ * @brief Values of float bit patterns, PSD bins are float precision values mostly
+ */
+void test_fuzz_float_bits(void)
+{
+    std::mt19937 generator(43);
+
+    size_t mismatches = fuzz([&generator](double &value)
+                             {
+                                 uint32_t bits = generator();
+                                 float single;
+                                 memcpy(&single, &bits, sizeof(single));
+                                 value = single;
+                                 return isfinite(single) != 0;
+                             });
+
+    TEST_ASSERT_EQUAL_size_t(0, mismatches);
+}
+
+/**
+ * @brief Short decimal values, they are close to the rounding ties often
+ */
+void test_fuzz_decimal_values(void)
+{
+    std::mt19937_64 generator(43);
+    std::uniform_int_distribution<int64_t> digits(-9999999, 9999999);
+    std::uniform_int_distribution<int> exponents(-30, 30);
+
+    size_t mismatches = fuzz([&](double &value)
+                             {
+                                 value = digits(generator) * pow(10, exponents(generator));
+                                 return true;
+                             });
+
+    TEST_ASSERT_EQUAL_size_t(0, mismatches);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_edge_values);
+    RUN_TEST(test_fuzz_double_bits);
+    RUN_TEST(test_fuzz_float_bits);
+    RUN_TEST(test_fuzz_decimal_values);
+
+    return UNITY_END();
+}
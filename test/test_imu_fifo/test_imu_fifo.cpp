@@ -0,0 +1,293 @@
+/**
+ * @file test_imu_fifo.cpp
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Host tests of the IMU FIFO draining against a register-level sensor model
+ * @version 0.1
+ * @date 2024-08-14
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <deque>
+#include <vector>
+
+#include <unity.h>
+
+#include <IIM42652.h>
+#include <Wire.h>
+
+#include "Measurements/ImuFifo.h"
+
+using namespace Measurements;
+
+namespace
+{
+    constexpr uint8_t imuAddress = 0x68;
+
+    /**
+     * @brief IIM42652 register model: FIFO count registers, streaming FIFO data register and plain registers
+     */
+    class ImuModel : public I2cDevice
+    {
+    public:
+        void writeRegister(uint8_t address, uint8_t value) override
+        {
+            registers[address] = value;
+            if (address == IIM42652_REG_SIGNAL_PATH_RESET && (value & BIT_SIGNAL_PATH_RESET_FIFO_FLUSH))
+            {
+                fifo.clear();
+            }
+        }
+
+        uint8_t readRegister(uint8_t address) override
+        {
+            switch (address)
+            {
+            case IIM42652_REG_FIFO_COUNTH:
+                // Count is latched on COUNTH reading
+                latchedCount = (fifo.size() > IIM42652_FIFO_SIZE) ? IIM42652_FIFO_SIZE : fifo.size();
+                return static_cast<uint8_t>(latchedCount >> 8);
+            case IIM42652_REG_FIFO_COUNTL:
+                return static_cast<uint8_t>(latchedCount & 0xFF);
+            case IIM42652_REG_FIFO_DATA:
+                if (fifo.empty() == true)
+                {
+                    return 0xFF; // Empty FIFO reads as invalid header
+                }
+                else
+                {
+                    uint8_t value = fifo.front();
+                    fifo.pop_front();
+                    return value;
+                }
+            default:
+                return registers[address];
+            }
+        }
+
+        uint8_t nextRegister(uint8_t address) override
+        {
+            // FIFO data register address isn't incremented
+            return (address == IIM42652_REG_FIFO_DATA) ? address : address + 1;
+        }
+
+        /**
+         * @brief Push a packet 3 into the FIFO
+         */
+        void pushPacket(uint8_t header, int16_t accelX, int16_t gyroX, int8_t temperature, uint16_t timestamp)
+        {
+            int16_t values[6] = {accelX, static_cast<int16_t>(accelX + 1), static_cast<int16_t>(accelX + 2),
+                                 gyroX,  static_cast<int16_t>(gyroX + 1),  static_cast<int16_t>(gyroX + 2)};
+
+            fifo.push_back(header);
+            for (int16_t value : values)
+            {
+                fifo.push_back(static_cast<uint8_t>(static_cast<uint16_t>(value) >> 8));
+                fifo.push_back(static_cast<uint8_t>(value & 0xFF));
+            }
+            fifo.push_back(static_cast<uint8_t>(temperature));
+            fifo.push_back(static_cast<uint8_t>(timestamp >> 8));
+            fifo.push_back(static_cast<uint8_t>(timestamp & 0xFF));
+        }
+
+        void pushValidPacket(int16_t value)
+        {
+            pushPacket(BIT_FIFO_HEADER_ACCEL | BIT_FIFO_HEADER_GYRO, value, -value, 25, value);
+        }
+
+        uint8_t registers[256] = {0};
+        std::deque<uint8_t> fifo;
+        size_t latchedCount = 0;
+    };
+
+    ImuModel model;
+    IIM42652 imu;
+    uint8_t fifoBuffer[IIM42652_FIFO_SIZE];
+    std::vector<IIM42652_fifo_packet_t> storedPackets;
+
+    void storePacket(const IIM42652_fifo_packet_t &packet)
+    {
+        storedPackets.push_back(packet);
+    }
+} // namespace
+
+void setUp(void)
+{
+    model = ImuModel();
+    storedPackets.clear();
+
+    Wire.attach(&model, imuAddress);
+    Wire.failTransactions(0);
+    imu.begin(Wire, imuAddress);
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief FIFO is configured in stream mode with packet 3 and the watermark in bytes
+ */
+void test_fifo_configuration(void)
+{
+    model.pushValidPacket(1);
+
+    TEST_ASSERT_TRUE(imu.fifo_configuration(20));
+
+    TEST_ASSERT_EQUAL_HEX8(IIM42652_FIFO_CONFIG_MODE_STREAM, model.registers[IIM42652_REG_FIFO_CONFIG]);
+    TEST_ASSERT_EQUAL_HEX8(BIT_FIFO_CONFIG1_ACCEL_EN | BIT_FIFO_CONFIG1_GYRO_EN | BIT_FIFO_CONFIG1_TEMP_EN |
+                               BIT_FIFO_CONFIG1_WM_GT_TH,
+                           model.registers[IIM42652_REG_FIFO_CONFIG1]);
+    TEST_ASSERT_EQUAL_UINT16(20 * IIM42652_FIFO_PACKET_SIZE, model.registers[IIM42652_REG_FIFO_CONFIG2] |
+                                                                 (model.registers[IIM42652_REG_FIFO_CONFIG3] << 8));
+    TEST_ASSERT_EQUAL_size_t(0, model.fifo.size()); // Flushed
+}
+
+/**
+ * @brief Valid packets are parsed in FIFO order and all of them are stored
+ */
+void test_valid_packets_are_stored(void)
+{
+    // More than one I2C read chunk
+    constexpr size_t packetCount = 3 * IIM42652_FIFO_READ_CHUNK / IIM42652_FIFO_PACKET_SIZE + 1;
+    for (size_t idx = 0; idx < packetCount; idx++)
+    {
+        model.pushValidPacket(static_cast<int16_t>(idx * 100));
+    }
+
+    ImuFifo::Batch batch;
+    TEST_ASSERT_TRUE(ImuFifo::drain(imu, fifoBuffer, storePacket, batch));
+
+    TEST_ASSERT_EQUAL_size_t(packetCount, batch.packets);
+    TEST_ASSERT_EQUAL_size_t(packetCount, batch.stored);
+    TEST_ASSERT_EQUAL_size_t(0, batch.invalid);
+    TEST_ASSERT_FALSE(batch.isOverflow);
+    TEST_ASSERT_EQUAL_size_t(packetCount, storedPackets.size());
+    for (size_t idx = 0; idx < packetCount; idx++)
+    {
+        const IIM42652_fifo_packet_t &packet = storedPackets[idx];
+        int16_t value = static_cast<int16_t>(idx * 100);
+
+        TEST_ASSERT_EQUAL_INT16(value, packet.accel.x);
+        TEST_ASSERT_EQUAL_INT16(value + 2, packet.accel.z);
+        TEST_ASSERT_EQUAL_INT16(-value, packet.gyro.x);
+        TEST_ASSERT_EQUAL_INT16(-value + 1, packet.gyro.y);
+        TEST_ASSERT_EQUAL_INT8(25, packet.temperature);
+        TEST_ASSERT_EQUAL_UINT16(static_cast<uint16_t>(value), packet.timestamp);
+    }
+    TEST_ASSERT_EQUAL_size_t(0, model.fifo.size());
+}
+
+/**
+ * @brief Invalid packets are counted but not stored
+ */
+void test_invalid_packets_are_not_stored(void)
+{
+    model.pushValidPacket(1);
+    model.pushPacket(BIT_FIFO_HEADER_ACCEL | BIT_FIFO_HEADER_GYRO, IIM42652_FIFO_INVALID_DATA, 0, 0, 0); // Not ready
+    model.pushPacket(BIT_FIFO_HEADER_ACCEL, 3, 3, 0, 0);                                               // No gyro
+    model.pushPacket(BIT_FIFO_HEADER_MSG, 4, 4, 0, 0);                                                 // Empty FIFO
+    model.pushValidPacket(5);
+
+    ImuFifo::Batch batch;
+    TEST_ASSERT_TRUE(ImuFifo::drain(imu, fifoBuffer, storePacket, batch));
+
+    TEST_ASSERT_EQUAL_size_t(5, batch.packets);
+    TEST_ASSERT_EQUAL_size_t(2, batch.stored);
+    TEST_ASSERT_EQUAL_size_t(3, batch.invalid);
+    TEST_ASSERT_EQUAL_size_t(2, storedPackets.size());
+    TEST_ASSERT_EQUAL_INT16(1, storedPackets[0].accel.x);
+    TEST_ASSERT_EQUAL_INT16(5, storedPackets[1].accel.x);
+}
+
+/**
+ * @brief Full FIFO is reported as overflow and the read is limited to the FIFO capacity
+ */
+void test_overflow_is_reported(void)
+{
+    constexpr size_t packetCount = IIM42652_FIFO_SIZE / IIM42652_FIFO_PACKET_SIZE + 4;
+    for (size_t idx = 0; idx < packetCount; idx++)
+    {
+        model.pushValidPacket(static_cast<int16_t>(idx));
+    }
+
+    ImuFifo::Batch batch;
+    TEST_ASSERT_TRUE(ImuFifo::drain(imu, fifoBuffer, storePacket, batch));
+
+    TEST_ASSERT_TRUE(batch.isOverflow);
+    TEST_ASSERT_EQUAL_size_t(IIM42652_FIFO_SIZE / IIM42652_FIFO_PACKET_SIZE, batch.packets);
+    TEST_ASSERT_EQUAL_size_t(batch.packets, batch.stored);
+    TEST_ASSERT_EQUAL_size_t(4 * IIM42652_FIFO_PACKET_SIZE, model.fifo.size());
+}
+
+/**
+ * @brief Partial packet stays in FIFO until it is complete
+ */
+void test_partial_packet_stays_in_fifo(void)
+{
+    model.pushValidPacket(1);
+    model.pushValidPacket(2);
+    for (size_t idx = 0; idx < IIM42652_FIFO_PACKET_SIZE / 2; idx++)
+    {
+        model.fifo.pop_back();
+    }
+
+    ImuFifo::Batch batch;
+    TEST_ASSERT_TRUE(ImuFifo::drain(imu, fifoBuffer, storePacket, batch));
+
+    TEST_ASSERT_EQUAL_size_t(1, batch.packets);
+    TEST_ASSERT_EQUAL_size_t(1, batch.stored);
+    TEST_ASSERT_EQUAL_size_t(IIM42652_FIFO_PACKET_SIZE / 2, model.fifo.size());
+}
+
+/**
+ * @brief Empty FIFO is drained without data reading
+ */
+void test_empty_fifo(void)
+{
+    size_t transactions = Wire.transactions();
+
+    ImuFifo::Batch batch;
+    TEST_ASSERT_TRUE(ImuFifo::drain(imu, fifoBuffer, storePacket, batch));
+
+    TEST_ASSERT_EQUAL_size_t(0, batch.packets);
+    TEST_ASSERT_EQUAL_size_t(0, storedPackets.size());
+    TEST_ASSERT_EQUAL_size_t(2, Wire.transactions() - transactions); // Count register only
+}
+
+/**
+ * @brief I2C failure is reported and no packets are handled
+ */
+void test_i2c_failure(void)
+{
+    model.pushValidPacket(1);
+
+    ImuFifo::Batch batch;
+    Wire.failTransactions(1);
+    TEST_ASSERT_FALSE(ImuFifo::drain(imu, fifoBuffer, storePacket, batch));
+    TEST_ASSERT_EQUAL_size_t(0, storedPackets.size());
+
+    // FIFO data reading fails after the count has been read (count register write and read)
+    Wire.failTransactions(1, 2);
+    TEST_ASSERT_FALSE(ImuFifo::drain(imu, fifoBuffer, storePacket, batch));
+    TEST_ASSERT_EQUAL_size_t(0, storedPackets.size());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_fifo_configuration);
+    RUN_TEST(test_valid_packets_are_stored);
+    RUN_TEST(test_invalid_packets_are_not_stored);
+    RUN_TEST(test_overflow_is_reported);
+    RUN_TEST(test_partial_packet_stays_in_fifo);
+    RUN_TEST(test_empty_fifo);
+    RUN_TEST(test_i2c_failure);
+
+    return UNITY_END();
+}
@@ -0,0 +1,274 @@
+/**
+ * @file test_imu_trigger.cpp
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Host tests of the IMU data trigger with a simulated INT1 interrupt source
+ * @version 0.1
+ * @date 2024-08-14
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <unity.h>
+
+#include <Events.h>
+#include <freertos/task.h>
+
+#include "Measurements/ImuTrigger.h"
+
+using namespace Measurements;
+
+namespace
+{
+    constexpr EventBits_t dataReadyEvent = 1 << 3;
+    constexpr EventBits_t stopEvent = 1 << 5;
+    constexpr EventBits_t otherEvent = 1 << 0;
+
+    // Expected interval between interrupts, microseconds
+    constexpr size_t intervalUs = 5000;
+    constexpr size_t intervalMs = intervalUs / 1000;
+
+    /**
+     * @brief Simulated IMU INT1 source, the "interrupt handler" runs in a host thread
+     */
+    class InterruptSource
+    {
+    public:
+        explicit InterruptSource(RTOS::EventGroup &eventGroup) : _eventGroup(eventGroup)
+        {
+        }
+
+        ~InterruptSource()
+        {
+            stop();
+        }
+
+        /**
+         * @brief Raise a number of interrupts with the given interval
+         */
+        void start(size_t count, size_t periodMs)
+        {
+            _thread = std::thread([this, count, periodMs]()
+                                  {
+                                      for (size_t idx = 0; idx < count && _isStopped == false; idx++)
+                                      {
+                                          std::this_thread::sleep_for(std::chrono::milliseconds(periodMs));
+                                          _eventGroup.setIsr(dataReadyEvent);
+                                          _raised++;
+                                      }
+                                  });
+        }
+
+        void stop()
+        {
+            _isStopped = true;
+            if (_thread.joinable() == true)
+            {
+                _thread.join();
+            }
+        }
+
+        size_t raised() const
+        {
+            return _raised;
+        }
+
+    private:
+        RTOS::EventGroup &_eventGroup;
+        std::thread _thread;
+        std::atomic<bool> _isStopped{false};
+        std::atomic<size_t> _raised{0};
+    };
+
+    /**
+     * @brief Get time since the given time point, milliseconds
+     */
+    double elapsedMs(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+} // namespace
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief Every interrupt wakes up the waiting task, nothing is missed
+ */
+void test_interrupt_wakes_up(void)
+{
+    constexpr size_t count = 20;
+
+    RTOS::EventGroup eventGroup;
+    ImuTrigger trigger(eventGroup, dataReadyEvent, stopEvent);
+    InterruptSource source(eventGroup);
+
+    trigger.start(intervalUs, true);
+    source.start(count, intervalMs);
+
+    for (size_t idx = 0; idx < count; idx++)
+    {
+        bool isMissed = true;
+
+        EventBits_t events = trigger.wait(isMissed);
+
+        TEST_ASSERT_EQUAL_UINT32(dataReadyEvent, events);
+        TEST_ASSERT_FALSE(isMissed);
+        TEST_ASSERT_TRUE(trigger.isInterrupt());
+    }
+
+    source.stop();
+    TEST_ASSERT_EQUAL_size_t(count, source.raised());
+}
+
+/**
+ * @brief Unrelated events don't wake up the task and aren't reported
+ */
+void test_other_events_are_ignored(void)
+{
+    RTOS::EventGroup eventGroup;
+    ImuTrigger trigger(eventGroup, dataReadyEvent, stopEvent);
+    InterruptSource source(eventGroup);
+
+    trigger.start(intervalUs, true);
+    eventGroup.set(otherEvent);
+    source.start(1, intervalMs);
+
+    bool isMissed = true;
+    EventBits_t events = trigger.wait(isMissed);
+
+    TEST_ASSERT_EQUAL_UINT32(dataReadyEvent, events);
+    TEST_ASSERT_FALSE(isMissed);
+}
+
+/**
+ * @brief Missing interrupt falls back to the timer polling after the timeout
+ */
+void test_interrupt_timeout_falls_back_to_polling(void)
+{
+    constexpr size_t count = 3;
+
+    RTOS::EventGroup eventGroup;
+    ImuTrigger trigger(eventGroup, dataReadyEvent, stopEvent);
+    InterruptSource source(eventGroup);
+
+    trigger.start(intervalUs, true);
+    source.start(count, intervalMs);
+
+    bool isMissed = true;
+    for (size_t idx = 0; idx < count; idx++)
+    {
+        TEST_ASSERT_EQUAL_UINT32(dataReadyEvent, trigger.wait(isMissed));
+    }
+    source.stop();
+
+    // Interrupt source is dead (eg: INT1 isn't wired)
+    auto start = std::chrono::steady_clock::now();
+    EventBits_t events = trigger.wait(isMissed);
+    double timeoutMs = elapsedMs(start);
+
+    TEST_ASSERT_EQUAL_UINT32(0, events);
+    TEST_ASSERT_TRUE(isMissed);
+    TEST_ASSERT_FALSE(trigger.isInterrupt());
+    TEST_ASSERT_TRUE(timeoutMs >= ImuTrigger::interruptTimeoutFactor * intervalMs - 1);
+
+    // Timer polling keeps the interval
+    constexpr size_t pollCount = 10;
+    start = std::chrono::steady_clock::now();
+    for (size_t idx = 0; idx < pollCount; idx++)
+    {
+        events = trigger.wait(isMissed);
+        TEST_ASSERT_EQUAL_UINT32(0, events);
+    }
+    double pollMs = elapsedMs(start);
+
+    TEST_ASSERT_TRUE(pollMs >= (pollCount - 1) * intervalMs);
+    TEST_ASSERT_TRUE(pollMs < (pollCount + 4) * intervalMs);
+}
+
+/**
+ * @brief Stop event ends waiting for the interrupt
+ */
+void test_stop_while_waiting_interrupt(void)
+{
+    RTOS::EventGroup eventGroup;
+    ImuTrigger trigger(eventGroup, dataReadyEvent, stopEvent);
+
+    trigger.start(intervalUs, true);
+
+    std::thread stopper([&eventGroup]()
+                        {
+                            std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+                            eventGroup.set(stopEvent);
+                        });
+
+    bool isMissed = true;
+    EventBits_t events = trigger.wait(isMissed);
+    stopper.join();
+
+    TEST_ASSERT_EQUAL_UINT32(stopEvent, events);
+    TEST_ASSERT_FALSE(isMissed);
+    TEST_ASSERT_TRUE(trigger.isInterrupt());
+}
+
+/**
+ * @brief Timer polling reports the stop event on the next wake up
+ */
+void test_stop_while_polling(void)
+{
+    RTOS::EventGroup eventGroup;
+    ImuTrigger trigger(eventGroup, dataReadyEvent, stopEvent);
+
+    trigger.start(intervalUs, false);
+
+    bool isMissed = true;
+    TEST_ASSERT_EQUAL_UINT32(0, trigger.wait(isMissed));
+    TEST_ASSERT_FALSE(isMissed);
+
+    eventGroup.set(stopEvent | otherEvent);
+    TEST_ASSERT_EQUAL_UINT32(stopEvent, trigger.wait(isMissed));
+}
+
+/**
+ * @brief Late polling wake up is reported as missed deadline
+ */
+void test_late_polling_is_missed(void)
+{
+    RTOS::EventGroup eventGroup;
+    ImuTrigger trigger(eventGroup, dataReadyEvent, stopEvent);
+
+    trigger.start(intervalUs, false);
+
+    // Processing took longer than the period
+    vTaskDelay(2 * intervalMs + 1);
+
+    bool isMissed = false;
+    trigger.wait(isMissed);
+    TEST_ASSERT_TRUE(isMissed);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_interrupt_wakes_up);
+    RUN_TEST(test_other_events_are_ignored);
+    RUN_TEST(test_interrupt_timeout_falls_back_to_polling);
+    RUN_TEST(test_stop_while_waiting_interrupt);
+    RUN_TEST(test_stop_while_polling);
+    RUN_TEST(test_late_polling_is_missed);
+
+    return UNITY_END();
+}
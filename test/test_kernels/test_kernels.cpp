@@ -0,0 +1,260 @@
+/**
+ * @file test_kernels.cpp
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Host tests of the portable vector reduction kernels and statistics
+ * @version 0.1
+ * @date 2024-08-20
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <random>
+
+#include <unity.h>
+
+#include "Measurements/Kernels.h"
+#include "Measurements/Statistic.h"
+
+using namespace Measurements;
+
+namespace
+{
+    // Maximum size of the test data set (more than the 32-bit lanes sum block)
+    constexpr size_t sizeMax = 70000;
+    // Number of statistic samples per segment
+    constexpr size_t segmentSize = 256;
+
+    int16_t dataInt[sizeMax];
+    float dataFloat[sizeMax];
+    float dataFloat2[sizeMax];
+
+    std::mt19937 generator(12345);
+
+    /**
+     * @brief Fill the int16 data set with random values of the full range
+     */
+    void fillInt(size_t size)
+    {
+        std::uniform_int_distribution<int> distribution(INT16_MIN, INT16_MAX);
+        for (size_t idx = 0; idx < size; idx++)
+        {
+            dataInt[idx] = distribution(generator);
+        }
+    }
+
+    /**
+     * @brief Fill the float data set with normal values
+     */
+    void fillNormal(float *data, size_t size, double mean, double deviation)
+    {
+        std::normal_distribution<double> distribution(mean, deviation);
+        for (size_t idx = 0; idx < size; idx++)
+        {
+            data[idx] = static_cast<float>(distribution(generator));
+        }
+    }
+
+    /**
+     * @brief Get the reference standard deviation by the two-pass long double calculation
+     */
+    template <typename Type>
+    double referenceDeviation(const Type *data, size_t size)
+    {
+        long double sum = 0;
+        for (size_t idx = 0; idx < size; idx++)
+        {
+            sum += data[idx];
+        }
+        long double mean = sum / size;
+
+        long double sumSquares = 0;
+        for (size_t idx = 0; idx < size; idx++)
+        {
+            long double diff = data[idx] - mean;
+            sumSquares += diff * diff;
+        }
+
+        return static_cast<double>(sqrtl(sumSquares / size));
+    }
+} // namespace
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief Int16 kernels match the scalar reference for any size and alignment
+ */
+void test_int16_kernels_match_reference(void)
+{
+    fillInt(sizeMax);
+
+    const size_t sizes[] = {1, 3, 8, 17, 255, 1024, 4099, 65536 + 5};
+    for (size_t size : sizes)
+    {
+        for (size_t offset = 0; offset < 8; offset++)
+        {
+            const int16_t *data = &dataInt[offset];
+            const int16_t *data2 = &dataInt[sizeMax - size - (offset + 3) % 8];
+
+            int16_t minimum = data[0];
+            int16_t maximum = data[0];
+            int64_t sum = 0;
+            int64_t sumSquares = 0;
+            int64_t dot = 0;
+            for (size_t idx = 0; idx < size; idx++)
+            {
+                minimum = (data[idx] < minimum) ? data[idx] : minimum;
+                maximum = (data[idx] > maximum) ? data[idx] : maximum;
+                sum += data[idx];
+                sumSquares += static_cast<int64_t>(data[idx]) * data[idx];
+                dot += static_cast<int64_t>(data[idx]) * data2[idx];
+            }
+
+            TEST_ASSERT_EQUAL_INT16(minimum, Kernels::min(data, size));
+            TEST_ASSERT_EQUAL_INT16(maximum, Kernels::max(data, size));
+            TEST_ASSERT_EQUAL_INT64(sum, Kernels::sum(data, size));
+            TEST_ASSERT_EQUAL_INT64(sumSquares, Kernels::sumSquares(data, size));
+            TEST_ASSERT_EQUAL_INT64(dot, Kernels::dot(data, data2, size));
+        }
+    }
+}
+
+/**
+ * @brief Int16 sums don't overflow at the range extremes
+ */
+void test_int16_extremes(void)
+{
+    for (size_t idx = 0; idx < sizeMax; idx++)
+    {
+        dataInt[idx] = INT16_MIN;
+    }
+
+    TEST_ASSERT_EQUAL_INT64(static_cast<int64_t>(INT16_MIN) * sizeMax, Kernels::sum(dataInt, sizeMax));
+    TEST_ASSERT_EQUAL_INT64(static_cast<int64_t>(INT16_MIN) * INT16_MIN * sizeMax, Kernels::sumSquares(dataInt, sizeMax));
+    TEST_ASSERT_EQUAL_INT16(INT16_MIN, Kernels::min(dataInt, sizeMax));
+    TEST_ASSERT_EQUAL_INT16(INT16_MIN, Kernels::max(dataInt, sizeMax));
+}
+
+/**
+ * @brief Float kernels match the long double reference
+ */
+void test_float_kernels_match_reference(void)
+{
+    fillNormal(dataFloat, sizeMax, 170.0, 10.0);
+    fillNormal(dataFloat2, sizeMax, -3.0, 1.0);
+
+    const size_t sizes[] = {1, 5, 256, 1023, sizeMax};
+    for (size_t size : sizes)
+    {
+        float minimum = dataFloat[0];
+        float maximum = dataFloat[0];
+        long double sum = 0;
+        long double sumSquares = 0;
+        long double dot = 0;
+        for (size_t idx = 0; idx < size; idx++)
+        {
+            minimum = (dataFloat[idx] < minimum) ? dataFloat[idx] : minimum;
+            maximum = (dataFloat[idx] > maximum) ? dataFloat[idx] : maximum;
+            sum += dataFloat[idx];
+            sumSquares += static_cast<long double>(dataFloat[idx]) * dataFloat[idx];
+            dot += static_cast<long double>(dataFloat[idx]) * dataFloat2[idx];
+        }
+
+        TEST_ASSERT_EQUAL_FLOAT(minimum, Kernels::min(dataFloat, size));
+        TEST_ASSERT_EQUAL_FLOAT(maximum, Kernels::max(dataFloat, size));
+        TEST_ASSERT_DOUBLE_WITHIN(fabsl(sum) * 1e-12, static_cast<double>(sum), Kernels::sum(dataFloat, size));
+        TEST_ASSERT_DOUBLE_WITHIN(sumSquares * 1e-6, static_cast<double>(sumSquares), Kernels::sumSquares(dataFloat, size));
+        TEST_ASSERT_DOUBLE_WITHIN(fabsl(dot) * 1e-5 + 1e-3, static_cast<double>(dot), Kernels::dot(dataFloat, dataFloat2, size));
+    }
+}
+
+/**
+ * @brief Centred sums of squares don't cancel for small deviations of large values
+ */
+void test_centred_sum_squares(void)
+{
+    for (size_t idx = 0; idx < segmentSize; idx++)
+    {
+        dataInt[idx] = 16000 + idx % 2;
+    }
+    // Deviations are +-0.5 around the mean
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, 0.25 * segmentSize, Kernels::sumSquares(dataInt, segmentSize, 16000.5));
+
+    fillNormal(dataFloat, segmentSize, 25.0, 0.01);
+    double mean = Kernels::sum(dataFloat, segmentSize) / segmentSize;
+    double deviation = referenceDeviation(dataFloat, segmentSize);
+    double expected = deviation * deviation * segmentSize;
+    TEST_ASSERT_DOUBLE_WITHIN(expected * 1e-4, expected, Kernels::sumSquares(dataFloat, segmentSize, mean));
+}
+
+/**
+ * @brief Statistic deviation of float channels matches the two-pass reference
+ * (temperature at 25 degrees and roll near 170 degrees with small deviations)
+ */
+void test_statistic_float_deviation(void)
+{
+    struct Case
+    {
+        double mean;
+        double deviation;
+    };
+    const Case cases[] = {{25.0, 0.01}, {170.0, 0.01}, {170.0, 0.1}, {-170.0, 0.001}, {0.0, 1.0}};
+
+    for (const auto &testCase : cases)
+    {
+        fillNormal(dataFloat, segmentSize, testCase.mean, testCase.deviation);
+
+        Statistic<float> statistic;
+        statistic.reset();
+        statistic.calculate(dataFloat, segmentSize);
+
+        double reference = referenceDeviation(dataFloat, segmentSize);
+        TEST_ASSERT_DOUBLE_WITHIN(reference * 1e-3, reference, statistic.deviation());
+        TEST_ASSERT_DOUBLE_WITHIN(fabs(testCase.mean) * 1e-7 + 1e-9, Kernels::sum(dataFloat, segmentSize) / segmentSize, statistic.mean());
+    }
+}
+
+/**
+ * @brief Statistic of int16 channels matches the two-pass reference
+ */
+void test_statistic_int16(void)
+{
+    std::normal_distribution<double> distribution(16000.0, 0.7);
+    for (size_t idx = 0; idx < segmentSize; idx++)
+    {
+        dataInt[idx] = static_cast<int16_t>(lround(distribution(generator)));
+    }
+
+    Statistic<int16_t> statistic;
+    statistic.reset();
+    statistic.calculate(dataInt, segmentSize);
+
+    double reference = referenceDeviation(dataInt, segmentSize);
+    TEST_ASSERT_DOUBLE_WITHIN(reference * 1e-9, reference, statistic.deviation());
+    TEST_ASSERT_EQUAL_INT16(Kernels::min(dataInt, segmentSize), statistic.min());
+    TEST_ASSERT_EQUAL_INT16(Kernels::max(dataInt, segmentSize), statistic.max());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_int16_kernels_match_reference);
+    RUN_TEST(test_int16_extremes);
+    RUN_TEST(test_float_kernels_match_reference);
+    RUN_TEST(test_centred_sum_squares);
+    RUN_TEST(test_statistic_float_deviation);
+    RUN_TEST(test_statistic_int16);
+
+    return UNITY_END();
+}
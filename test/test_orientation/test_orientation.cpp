@@ -0,0 +1,258 @@
+/**
+ * @file test_orientation.cpp
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Host accuracy comparison and benchmark of the orientation filters on a synthesized 1 kHz recording
+ * with the known attitude: sensor noise, vibration and gyroscope bias are added to the ideal samples
+ * @version 0.1
+ * @date 2024-08-24
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <unity.h>
+
+#include "Measurements/Orientation.h"
+
+using namespace Measurements::Orientation;
+
+namespace
+{
+    constexpr float sampleFrequency = 1000;
+    // Recording duration, seconds
+    constexpr size_t duration = 60;
+    // Time to skip before the errors are accounted (filters start from the level attitude), seconds
+    constexpr size_t settleTime = 20;
+
+    // Sensor ranges, same as the firmware configuration
+    constexpr double accelRangeG = 2;
+    constexpr double gyroRangeDps = 250;
+
+    constexpr double degToRad = M_PI / 180;
+    constexpr double radToDeg = 180 / M_PI;
+
+    /**
+     * @brief Recorded sample with the true attitude
+     */
+    struct Sample
+    {
+        float gx, gy, gz; // Gyroscope, deg/s
+        float ax, ay, az; // Accelerometer, G
+        double roll;      // True roll, degrees
+        double pitch;     // True pitch, degrees
+    };
+
+    /**
+     * @brief Recording conditions
+     */
+    struct Conditions
+    {
+        double rollAmplitude;  // Roll swing amplitude, degrees
+        double pitchAmplitude; // Pitch swing amplitude, degrees
+        double rollOffset;     // Roll offset, degrees
+        double pitchOffset;    // Pitch offset, degrees
+        double gyroBias;       // Gyroscope X/Y bias, deg/s
+        double gyroNoise;      // Gyroscope noise, deg/s RMS
+        double vibration;      // Accelerometer vibration and noise, G RMS
+    };
+
+    /**
+     * @brief Filter accuracy and speed
+     */
+    struct Result
+    {
+        double rollRms;  // Roll RMS error, degrees
+        double pitchRms; // Pitch RMS error, degrees
+        double errorMax; // Maximum error, degrees
+        double updateNs; // Mean update time with the angles reading, nanoseconds
+    };
+
+    /**
+     * @brief Quantize the value to the sensor LSB
+     */
+    float quantize(double value, double range)
+    {
+        double lsb = range / 32768;
+        double raw = round(value / lsb);
+        raw = (raw > INT16_MAX) ? INT16_MAX : ((raw < INT16_MIN) ? INT16_MIN : raw);
+
+        return static_cast<float>(raw * lsb);
+    }
+
+    /**
+     * @brief Synthesize the recording: roll and pitch swing, gravity and body rates follow the true attitude
+     * Angles follow the filters convention: roll = atan2(gravityY, gravityZ), pitch = asin(-gravityX)
+     */
+    std::vector<Sample> synthesize(const Conditions &conditions)
+    {
+        std::mt19937 generator(36);
+        std::normal_distribution<double> gyroNoise(0.0, conditions.gyroNoise);
+        std::normal_distribution<double> accelNoise(0.0, conditions.vibration);
+
+        const double rollFrequency = 0.2;
+        const double pitchFrequency = 0.13;
+
+        std::vector<Sample> recording(static_cast<size_t>(sampleFrequency) * duration);
+        for (size_t idx = 0; idx < recording.size(); idx++)
+        {
+            double time = idx / sampleFrequency;
+
+            double roll = (conditions.rollOffset + conditions.rollAmplitude * sin(2 * M_PI * rollFrequency * time)) * degToRad;
+            double pitch = (conditions.pitchOffset + conditions.pitchAmplitude * sin(2 * M_PI * pitchFrequency * time + 1)) * degToRad;
+            double rollRate = conditions.rollAmplitude * degToRad * 2 * M_PI * rollFrequency * cos(2 * M_PI * rollFrequency * time);
+            double pitchRate = conditions.pitchAmplitude * degToRad * 2 * M_PI * pitchFrequency * cos(2 * M_PI * pitchFrequency * time + 1);
+
+            // Body rates of the roll-pitch attitude without yaw
+            double p = rollRate;
+            double q = pitchRate * cos(roll);
+            double r = -pitchRate * sin(roll);
+
+            Sample &sample = recording[idx];
+            sample.roll = roll * radToDeg;
+            sample.pitch = pitch * radToDeg;
+            sample.gx = quantize(p * radToDeg + conditions.gyroBias + gyroNoise(generator), gyroRangeDps);
+            sample.gy = quantize(q * radToDeg + conditions.gyroBias + gyroNoise(generator), gyroRangeDps);
+            sample.gz = quantize(r * radToDeg + gyroNoise(generator), gyroRangeDps);
+            sample.ax = quantize(-sin(pitch) + accelNoise(generator), accelRangeG);
+            sample.ay = quantize(cos(pitch) * sin(roll) + accelNoise(generator), accelRangeG);
+            sample.az = quantize(cos(pitch) * cos(roll) + accelNoise(generator), accelRangeG);
+        }
+
+        return recording;
+    }
+
+    /**
+     * @brief Replay the recording through the filter, angles are read every sample like the firmware does
+     */
+    template <typename Filter>
+    Result replay(Filter &filter, const std::vector<Sample> &recording)
+    {
+        Result result = {};
+        std::vector<float> roll(recording.size());
+        std::vector<float> pitch(recording.size());
+
+        filter.begin(sampleFrequency);
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t idx = 0; idx < recording.size(); idx++)
+        {
+            const Sample &sample = recording[idx];
+            filter.update(sample.gx, sample.gy, sample.gz, sample.ax, sample.ay, sample.az);
+            roll[idx] = filter.roll();
+            pitch[idx] = filter.pitch();
+        }
+        result.updateNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                          recording.size();
+
+        size_t first = static_cast<size_t>(sampleFrequency) * settleTime;
+        for (size_t idx = first; idx < recording.size(); idx++)
+        {
+            double rollError = roll[idx] - recording[idx].roll;
+            double pitchError = pitch[idx] - recording[idx].pitch;
+
+            result.rollRms += rollError * rollError;
+            result.pitchRms += pitchError * pitchError;
+            result.errorMax = fmax(result.errorMax, fmax(fabs(rollError), fabs(pitchError)));
+        }
+        result.rollRms = sqrt(result.rollRms / (recording.size() - first));
+        result.pitchRms = sqrt(result.pitchRms / (recording.size() - first));
+
+        return result;
+    }
+
+    void report(const char *name, const Result &result)
+    {
+        char message[120];
+        snprintf(message, sizeof(message), "%-14s roll RMS %5.2f deg, pitch RMS %5.2f deg, max %5.2f deg, %6.1f ns/update",
+                 name, result.rollRms, result.pitchRms, result.errorMax, result.updateNs);
+        TEST_MESSAGE(message);
+    }
+} // namespace
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief All filters track the swinging sensor with vibration, noise and gyroscope bias
+ */
+void test_filters_track_motion(void)
+{
+    const Conditions conditions = {.rollAmplitude = 20,
+                                   .pitchAmplitude = 10,
+                                   .rollOffset = 5,
+                                   .pitchOffset = -3,
+                                   .gyroBias = 0.3,
+                                   .gyroNoise = 0.1,
+                                   .vibration = 0.02};
+    std::vector<Sample> recording = synthesize(conditions);
+
+    MadgwickFilter madgwick;
+    MahonyFilter mahony;
+    ComplementaryFilter complementary;
+
+    Result madgwickResult = replay(madgwick, recording);
+    Result mahonyResult = replay(mahony, recording);
+    Result complementaryResult = replay(complementary, recording);
+
+    report("Madgwick", madgwickResult);
+    report("Mahony", mahonyResult);
+    report("Complementary", complementaryResult);
+
+    TEST_ASSERT_TRUE(madgwickResult.rollRms < 2.0 && madgwickResult.pitchRms < 2.0);
+    TEST_ASSERT_TRUE(mahonyResult.rollRms < 2.0 && mahonyResult.pitchRms < 2.0);
+    TEST_ASSERT_TRUE(complementaryResult.rollRms < 2.0 && complementaryResult.pitchRms < 2.0);
+}
+
+/**
+ * @brief Mahony's integral gain removes the gyroscope bias error of the resting sensor
+ */
+void test_mahony_integral_compensates_bias(void)
+{
+    const Conditions conditions = {.rollAmplitude = 0,
+                                   .pitchAmplitude = 0,
+                                   .rollOffset = 10,
+                                   .pitchOffset = -5,
+                                   .gyroBias = 1.0,
+                                   .gyroNoise = 0.1,
+                                   .vibration = 0.005};
+    std::vector<Sample> recording = synthesize(conditions);
+
+    MahonyFilter proportional;
+    proportional.setGains(0.5f, 0.0f);
+    MahonyFilter integral;
+    integral.setGains(0.5f, 0.1f);
+
+    Result proportionalResult = replay(proportional, recording);
+    Result integralResult = replay(integral, recording);
+
+    report("Mahony Ki 0", proportionalResult);
+    report("Mahony Ki 0.1", integralResult);
+
+    // Proportional feedback leaves about bias / 2Kp error
+    TEST_ASSERT_TRUE(proportionalResult.rollRms > 0.5);
+    TEST_ASSERT_TRUE(integralResult.rollRms < 0.2 && integralResult.pitchRms < 0.2);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_filters_track_motion);
+    RUN_TEST(test_mahony_integral_compensates_bias);
+
+    return UNITY_END();
+}
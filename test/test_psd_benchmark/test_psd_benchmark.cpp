@@ -0,0 +1,373 @@
+/**
+ * @file test_psd_benchmark.cpp
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Host benchmark of the segment analysis: recorded samples are replayed through PSD and statistics
+ * at 1024 points per segment. A raw capture file is replayed if PSD_BENCH_CAPTURE environment variable
+ * points to it, a synthesized 1 kHz recording with known tones is replayed otherwise
+ * @version 0.1
+ * @date 2024-08-16
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <unity.h>
+
+#include "Measurements/Orientation.h"
+#include "Measurements/Psd.h"
+#include "Measurements/RawCapture.h"
+#include "Measurements/Statistic.h"
+
+using namespace Measurements;
+
+namespace
+{
+    // Segment size, samples
+    constexpr size_t segmentSize = 1024;
+    // Number of replayed segments
+    constexpr size_t segmentCount = 32;
+    // Raw file header size (see RawCapture.h)
+    constexpr size_t rawHeaderSize = 512;
+
+    // Sensor ranges, same as the firmware configuration
+    constexpr float accelRangeG = 2;
+    constexpr float gyroRangeDps = 250;
+
+    // Synthesized recording: sampling frequency and tones of the channels, Hz
+    constexpr size_t synthFrequency = 1000;
+    constexpr double toneAccX = 12.5;
+    constexpr double toneAccY = 40.0;
+    constexpr double toneGyroX = 3.0;
+    constexpr double toneGyroY = 110.0;
+
+    /**
+     * @brief Segment analysis jobs, same as MeasureManager analysis jobs
+     */
+    enum Job : size_t
+    {
+        AccelResult,
+        Angles,
+        PsdAccX,
+        PsdAccY,
+        GyroX,
+        GyroY,
+        StatisticAccZ,
+        StatisticGyroZ,
+        JobCount
+    };
+
+    const char *jobNames[JobCount] = {"AccelResult", "Angles", "PsdAccX", "PsdAccY",
+                                      "GyroX", "GyroY", "StatisticAccZ", "StatisticGyroZ"};
+
+    /**
+     * @brief Job timing structure
+     */
+    struct Timing
+    {
+        double sumUs;
+        double maxUs;
+    };
+
+    std::vector<RawCapture::Sample> recording;
+    size_t sampleFrequency;
+
+    // Segment channels
+    int16_t accX[segmentSize], accY[segmentSize], accZ[segmentSize];
+    int16_t gyrX[segmentSize], gyrY[segmentSize], gyrZ[segmentSize];
+    float accelResult[segmentSize], angleRoll[segmentSize], anglePitch[segmentSize];
+
+    PSD<int16_t> psdAccX, psdAccY, psdGyroX, psdGyroY;
+    PSD<float> psdAccResult;
+    Statistic<int16_t> statisticAccX, statisticAccY, statisticAccZ, statisticGyroX, statisticGyroY, statisticGyroZ;
+    Statistic<float> statisticAccelResult, statisticRoll, statisticPitch;
+    Orientation::Filter orientationFilter;
+
+    /**
+     * @brief Load raw capture file
+     *
+     * @return true if the file is loaded, false otherwise
+     */
+    bool loadRecording(const char *path)
+    {
+        FILE *file = fopen(path, "rb");
+        if (file == nullptr)
+        {
+            return false;
+        }
+
+        char header[rawHeaderSize + 1] = {0};
+        bool result = (fread(header, 1, rawHeaderSize, file) == rawHeaderSize);
+        if (result == true)
+        {
+            const char *rate = strstr(header, "Logging Rate,");
+            // Version 2 adds block marks in place of samples
+            result = ((strncmp(header, "RAW,1", 5) == 0 || strncmp(header, "RAW,2", 5) == 0) && rate != nullptr);
+            if (result == true)
+            {
+                sampleFrequency = strtoul(rate + strlen("Logging Rate,"), nullptr, 10);
+            }
+        }
+
+        RawCapture::Sample sample;
+        while (result == true && fread(&sample, sizeof(sample), 1, file) == 1)
+        {
+            bool isMark = (sample.accX == RawCapture::blockMarker && sample.accY == RawCapture::blockMarker);
+            if (isMark == false)
+            {
+                recording.push_back(sample);
+            }
+        }
+        fclose(file);
+
+        return result && recording.size() >= segmentSize && sampleFrequency > 0;
+    }
+
+    /**
+     * @brief Synthesize a recording: tilted sensor, a tone on every PSD channel and sensor noise
+     */
+    void synthesizeRecording()
+    {
+        std::mt19937 generator(31);
+        std::normal_distribution<double> noise(0.0, 4.0);
+
+        const double accelLsb = 32768 / accelRangeG;
+        const double gyroLsb = 32768 / gyroRangeDps;
+
+        sampleFrequency = synthFrequency;
+        recording.resize(segmentSize * segmentCount);
+        for (size_t idx = 0; idx < recording.size(); idx++)
+        {
+            double time = static_cast<double>(idx) / sampleFrequency;
+
+            RawCapture::Sample &sample = recording[idx];
+            sample.accX = lround((0.10 + 0.02 * sin(2 * M_PI * toneAccX * time)) * accelLsb + noise(generator));
+            sample.accY = lround((-0.05 + 0.01 * sin(2 * M_PI * toneAccY * time)) * accelLsb + noise(generator));
+            sample.accZ = lround(0.99 * accelLsb + noise(generator));
+            sample.gyrX = lround(0.8 * sin(2 * M_PI * toneGyroX * time) * gyroLsb + noise(generator));
+            sample.gyrY = lround(0.3 * sin(2 * M_PI * toneGyroY * time) * gyroLsb + noise(generator));
+            sample.gyrZ = lround(noise(generator));
+        }
+    }
+
+    /**
+     * @brief Copy the next segment of the recording into the channels
+     */
+    void loadSegment(size_t segment)
+    {
+        size_t offset = (segment * segmentSize) % (recording.size() - segmentSize + 1);
+        for (size_t idx = 0; idx < segmentSize; idx++)
+        {
+            const RawCapture::Sample &sample = recording[offset + idx];
+            accX[idx] = sample.accX;
+            accY[idx] = sample.accY;
+            accZ[idx] = sample.accZ;
+            gyrX[idx] = sample.gyrX;
+            gyrY[idx] = sample.gyrY;
+            gyrZ[idx] = sample.gyrZ;
+        }
+    }
+
+    /**
+     * @brief Accelerometer resultant direction by Linear Least Square, same as MeasureManager
+     */
+    void calculateAccelResult(double meanAccX, double meanAccY)
+    {
+        double sumX = 0, sumY = 0, sumX2 = 0, sumXY = 0;
+        for (size_t idx = 0; idx < segmentSize; idx++)
+        {
+            sumX += accX[idx];
+            sumY += accY[idx];
+            sumX2 += static_cast<double>(accX[idx]) * accX[idx];
+            sumXY += static_cast<double>(accX[idx]) * accY[idx];
+        }
+
+        double denominator = segmentSize * sumX2 - sumX * sumX;
+        double theta = (denominator != 0.0) ? atan((segmentSize * sumXY - sumX * sumY) / denominator) : 0.0;
+        double cosTheta = cos(theta);
+        double sinTheta = sin(theta);
+        for (size_t idx = 0; idx < segmentSize; idx++)
+        {
+            double x = (accX[idx] - meanAccX) * accelRangeG * 9.81 / 32768;
+            double y = (accY[idx] - meanAccY) * accelRangeG * 9.81 / 32768;
+
+            accelResult[idx] = x * cosTheta + y * sinTheta;
+        }
+    }
+
+    /**
+     * @brief Run the segment analysis job
+     */
+    void runJob(Job job)
+    {
+        switch (job)
+        {
+        case AccelResult:
+            calculateAccelResult(statisticAccX.mean(), statisticAccY.mean());
+            psdAccResult.computeSegment(accelResult);
+            statisticAccelResult.calculate(accelResult, segmentSize);
+            break;
+
+        case Angles:
+            for (size_t idx = 0; idx < segmentSize; idx++)
+            {
+                orientationFilter.update(gyrX[idx] * gyroRangeDps / 32768, gyrY[idx] * gyroRangeDps / 32768,
+                                         gyrZ[idx] * gyroRangeDps / 32768, accX[idx] * accelRangeG / 32768,
+                                         accY[idx] * accelRangeG / 32768, accZ[idx] * accelRangeG / 32768);
+                angleRoll[idx] = orientationFilter.roll();
+                anglePitch[idx] = orientationFilter.pitch();
+            }
+            statisticRoll.calculate(angleRoll, segmentSize);
+            statisticPitch.calculate(anglePitch, segmentSize);
+            break;
+
+        case PsdAccX:
+            psdAccX.computeSegment(accX);
+            break;
+
+        case PsdAccY:
+            psdAccY.computeSegment(accY);
+            break;
+
+        case GyroX:
+            psdGyroX.computeSegment(gyrX);
+            statisticGyroX.calculate(gyrX, segmentSize);
+            break;
+
+        case GyroY:
+            psdGyroY.computeSegment(gyrY);
+            statisticGyroY.calculate(gyrY, segmentSize);
+            break;
+
+        case StatisticAccZ:
+            statisticAccZ.calculate(accZ, segmentSize);
+            break;
+
+        case StatisticGyroZ:
+            statisticGyroZ.calculate(gyrZ, segmentSize);
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    /**
+     * @brief Check that the core bin of the PSD is at the tone frequency
+     */
+    template <typename Type>
+    void checkCoreBin(PSD<Type> &psd, double tone)
+    {
+        PsdBin coreBin;
+        psd.getResult(&coreBin);
+
+        TEST_ASSERT_DOUBLE_WITHIN(static_cast<double>(sampleFrequency) / segmentSize, tone, coreBin.frequency);
+    }
+} // namespace
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief Replay the recording segment by segment and report the analysis time
+ */
+void test_segment_analysis_benchmark(void)
+{
+    const char *capture = getenv("PSD_BENCH_CAPTURE");
+    bool isRecorded = (capture != nullptr && loadRecording(capture) == true);
+    if (isRecorded == false)
+    {
+        synthesizeRecording();
+    }
+
+    orientationFilter.begin(sampleFrequency);
+    psdAccX.setup(segmentSize, sampleFrequency);
+    psdAccY.setup(segmentSize, sampleFrequency);
+    psdGyroX.setup(segmentSize, sampleFrequency);
+    psdGyroY.setup(segmentSize, sampleFrequency);
+    psdAccResult.setup(segmentSize, sampleFrequency);
+
+    Timing timings[JobCount] = {};
+    double segmentMaxUs = 0;
+    double segmentSumUs = 0;
+
+    for (size_t segment = 0; segment < segmentCount; segment++)
+    {
+        loadSegment(segment);
+
+        auto segmentStart = std::chrono::steady_clock::now();
+
+        // Accelerometer X/Y means are required by the resultant direction job
+        statisticAccX.calculate(accX, segmentSize);
+        statisticAccY.calculate(accY, segmentSize);
+
+        for (size_t job = 0; job < JobCount; job++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            runJob(static_cast<Job>(job));
+            double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+            timings[job].sumUs += us;
+            timings[job].maxUs = (us > timings[job].maxUs) ? us : timings[job].maxUs;
+        }
+
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - segmentStart).count();
+        segmentSumUs += us;
+        segmentMaxUs = (us > segmentMaxUs) ? us : segmentMaxUs;
+    }
+
+    char message[120];
+    snprintf(message, sizeof(message), "%s recording, %u Hz, %u points, %u segments",
+             (isRecorded == true) ? capture : "Synthesized", static_cast<unsigned>(sampleFrequency),
+             static_cast<unsigned>(segmentSize), static_cast<unsigned>(segmentCount));
+    TEST_MESSAGE(message);
+    for (size_t job = 0; job < JobCount; job++)
+    {
+        snprintf(message, sizeof(message), "%-16s mean %8.1f us, max %8.1f us", jobNames[job],
+                 timings[job].sumUs / segmentCount, timings[job].maxUs);
+        TEST_MESSAGE(message);
+    }
+    snprintf(message, sizeof(message), "%-16s mean %8.1f us, max %8.1f us", "Segment",
+             segmentSumUs / segmentCount, segmentMaxUs);
+    TEST_MESSAGE(message);
+
+    // Segment should be analysed before the next one is acquired
+    TEST_ASSERT_TRUE(segmentMaxUs < 1e6 * segmentSize / sampleFrequency);
+
+    if (isRecorded == false)
+    {
+        checkCoreBin(psdAccX, toneAccX);
+        checkCoreBin(psdAccY, toneAccY);
+        checkCoreBin(psdGyroX, toneGyroX);
+        checkCoreBin(psdGyroY, toneGyroY);
+
+        // Sensor is at rest, the angles follow the tilt
+        TEST_ASSERT_DOUBLE_WITHIN(1.0, atan2(-0.05, 0.99) * 180 / M_PI, statisticRoll.mean());
+        TEST_ASSERT_DOUBLE_WITHIN(1.0, asin(-0.10 / sqrt(0.10 * 0.10 + 0.05 * 0.05 + 0.99 * 0.99)) * 180 / M_PI,
+                                  statisticPitch.mean());
+    }
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_segment_analysis_benchmark);
+
+    return UNITY_END();
+}
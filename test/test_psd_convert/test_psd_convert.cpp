@@ -0,0 +1,666 @@
+/**
+ * @file test_psd_convert.cpp
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Host tests of the PSD record converter: records convert back to the text the firmware writes,
+ * container records are found by the index or by their trailers after a power fail
+ * @version 0.1
+ * @date 2024-09-02
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include <FastCRC.h>
+#include <unity.h>
+
+#include "Measurements/PsdRecord.h"
+#include "Measurements/ResultContainer.h"
+#include "Measurements/ResultCsv.h"
+#include "PsdConvert.h"
+
+using namespace Measurements;
+
+namespace
+{
+    // Number of PSD bins of every channel
+    constexpr uint16_t binCount = 257;
+    // PSD segment size, samples
+    constexpr uint16_t segmentSize = 512;
+    // LogDelta resolution, dB (firmware default)
+    constexpr float resolutionDb = 0.1;
+
+    // PSD bins of the channels, float precision values survive the Float32 record exactly
+    std::vector<double> psdAccel(binCount);
+    std::vector<double> psdGyro(binCount);
+
+    // Result as the firmware hands it to the CSV and the record writers
+    ResultCsv::Header header;
+    std::vector<ResultCsv::Channel> channels;
+
+    /**
+     * @brief Append data to the record, accumulating its CRC
+     */
+    struct RecordBuilder
+    {
+        std::vector<uint8_t> data; // Record data
+
+        void add(const void *buffer, size_t size)
+        {
+            const uint8_t *bytes = static_cast<const uint8_t *>(buffer);
+            data.insert(data.end(), bytes, bytes + size);
+        }
+
+        void finish()
+        {
+            FastCRC32 crc32;
+            uint32_t crc = crc32.crc32(data.data(), data.size());
+            add(&crc, sizeof(crc));
+        }
+    };
+
+    /**
+     * @brief Build the record from the result in the same way as the firmware binary result writer
+     *
+     * @param[in] encoding PSD bins encoding
+     * @param[in] headerSize Size of the record header (the older writers have the shorter one)
+     * @return Record data
+     */
+    std::vector<uint8_t> buildRecord(PsdRecord::BinEncoding encoding, size_t headerSize = sizeof(PsdRecord::Header))
+    {
+        PsdRecord::Header recordHeader = {
+            .magic = PsdRecord::magic,
+            .version = PsdRecord::version,
+            .headerSize = static_cast<uint16_t>(headerSize),
+            .binEncoding = static_cast<uint8_t>(encoding),
+            .channelCount = static_cast<uint8_t>(channels.size()),
+            .segmentSize = header.segmentSize,
+            .binCount = header.binCount,
+            .loggingRate = header.loggingRate,
+            .measuredRate = static_cast<float>(header.measuredRate),
+            .sampleClockPpm = static_cast<float>(header.sampleClockPpm),
+            .timerDriftPpm = static_cast<float>(header.timerDriftPpm),
+            .startTime = {header.startTime[0], header.startTime[1], header.startTime[2],
+                          header.startTime[3], header.startTime[4], header.startTime[5]},
+            .session = header.session,
+            .batteryLevel = header.batteryLevel,
+            .batteryVoltage = header.batteryVoltage,
+            .firmware = {0},
+            .samples = header.samples,
+            .missedDeadlines = header.missedDeadlines,
+            .duplicatedSamples = header.duplicatedSamples,
+            .readFailures = header.readFailures,
+            .droppedSegments = header.droppedSegments,
+            .batchIntervalMaxUs = header.batchIntervalMaxUs,
+            .intervalMeanUs = header.intervalMeanUs,
+            .fifoOverflows = header.fifoOverflows,
+            .invalidPackets = header.invalidPackets,
+            .lightSleep = header.isLightSleep,
+        };
+        strncpy(recordHeader.firmware, header.firmware, sizeof(recordHeader.firmware) - 1);
+
+        RecordBuilder record;
+        record.add(&recordHeader, headerSize);
+
+        for (const auto &channel : channels)
+        {
+            PsdRecord::ChannelDescriptor descriptor = {
+                .name = {0},
+                .units = {0},
+                .hasPsd = (channel.psd != nullptr),
+                .reserved = {0},
+                .maximum = static_cast<float>(channel.maximum),
+                .minimum = static_cast<float>(channel.minimum),
+                .mean = static_cast<float>(channel.mean),
+                .deviation = static_cast<float>(channel.deviation),
+                .coreFrequency = static_cast<float>(channel.coreFrequency),
+                .coreAmplitude = static_cast<float>(channel.coreAmplitude),
+                .logMin = 0,
+                .logStep = 0,
+            };
+            strncpy(descriptor.name, channel.name, sizeof(descriptor.name) - 1);
+            strncpy(descriptor.units, channel.units, sizeof(descriptor.units) - 1);
+
+            if (channel.psd == nullptr)
+            {
+                record.add(&descriptor, sizeof(descriptor));
+            }
+            else if (encoding == PsdRecord::BinEncoding::Log16)
+            {
+                std::vector<uint16_t> codes(header.binCount);
+                PsdRecord::quantizeLog(channel.psd, header.binCount, codes.data(), descriptor.logMin, descriptor.logStep);
+
+                record.add(&descriptor, sizeof(descriptor));
+                record.add(codes.data(), codes.size() * sizeof(uint16_t));
+            }
+            else if (encoding == PsdRecord::BinEncoding::LogDelta)
+            {
+                std::vector<uint8_t> data(header.binCount * PsdRecord::logDeltaBytesMax);
+                size_t size = PsdRecord::compressLog(channel.psd, header.binCount, resolutionDb, data.data(),
+                                                     descriptor.logMin, descriptor.logStep);
+
+                record.add(&descriptor, sizeof(descriptor));
+                record.add(data.data(), size);
+            }
+            else
+            {
+                std::vector<float> bins(channel.psd, channel.psd + header.binCount);
+
+                record.add(&descriptor, sizeof(descriptor));
+                record.add(bins.data(), bins.size() * sizeof(float));
+            }
+        }
+
+        record.finish();
+
+        return record.data;
+    }
+
+    /**
+     * @brief Write the result as text in the same way as the firmware CSV result writer
+     *
+     * @return Result text
+     */
+    std::string writeCsv()
+    {
+        PsdConvert::TextOutput output;
+        ResultCsv::write(output, header, channels.data(), channels.size());
+
+        return output.text();
+    }
+
+    /**
+     * @brief Container built in the same way as the firmware container writer
+     */
+    struct Container
+    {
+        std::vector<uint8_t> data;                        // Container data
+        std::vector<ResultContainer::IndexEntry> entries; // Index entries
+        std::vector<size_t> sizes;                        // Record sizes, bytes
+        size_t indexOffset = 0;                           // Offset of the index
+
+        /**
+         * @brief Add record and its trailer
+         *
+         * @param[in] record Record data
+         * @param[in] time Epoch time of the record, seconds
+         */
+        void add(const std::vector<uint8_t> &record, uint32_t time)
+        {
+            uint32_t offset = data.size();
+            data.insert(data.end(), record.begin(), record.end());
+
+            ResultContainer::RecordTrailer trailer = ResultContainer::makeTrailer(offset, time);
+            const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&trailer);
+            data.insert(data.end(), bytes, bytes + sizeof(trailer));
+
+            entries.push_back({.offset = offset, .time = time});
+            sizes.push_back(record.size());
+        }
+
+        /**
+         * @brief Finish the container with the index and the footer
+         *
+         * @param[in] version Container format version
+         */
+        void finish(uint16_t version = ResultContainer::version)
+        {
+            indexOffset = data.size();
+
+            ResultContainer::Footer footer = {
+                .indexOffset = static_cast<uint32_t>(indexOffset),
+                .recordCount = static_cast<uint16_t>(entries.size()),
+                .version = version,
+                .crc = 0,
+                .magic = ResultContainer::magic,
+            };
+            footer.crc = ResultContainer::calculateCrc(entries.data(), footer);
+
+            const uint8_t *bytes = reinterpret_cast<const uint8_t *>(entries.data());
+            data.insert(data.end(), bytes, bytes + entries.size() * sizeof(ResultContainer::IndexEntry));
+            bytes = reinterpret_cast<const uint8_t *>(&footer);
+            data.insert(data.end(), bytes, bytes + sizeof(footer));
+        }
+    };
+
+    /**
+     * @brief Build the container of a Float32 record, a CSV record and a Log16 record
+     *
+     * @return Container
+     */
+    Container buildContainer()
+    {
+        std::string csv = writeCsv();
+
+        Container container;
+        container.add(buildRecord(PsdRecord::BinEncoding::Float32), 1725000000);
+        container.add(std::vector<uint8_t>(csv.begin(), csv.end()), 1725000600);
+        container.add(buildRecord(PsdRecord::BinEncoding::Log16), 1725001200);
+        container.finish();
+
+        return container;
+    }
+
+    /**
+     * @brief Check the read records are the first records of the container
+     *
+     * @param[in] container Container
+     * @param[in] records Read records
+     * @param[in] count Expected number of records
+     */
+    void checkRecords(const Container &container, const std::vector<PsdConvert::ContainerRecord> &records, size_t count)
+    {
+        TEST_ASSERT_EQUAL_size_t(count, records.size());
+        for (size_t idx = 0; idx < count; idx++)
+        {
+            TEST_ASSERT_EQUAL_size_t(container.entries[idx].offset, records[idx].offset);
+            TEST_ASSERT_EQUAL_size_t(container.sizes[idx], records[idx].size);
+            TEST_ASSERT_EQUAL_UINT32(container.entries[idx].time, records[idx].time);
+        }
+    }
+
+    /**
+     * @brief Check the conversion status, statuses are compared by their descriptions
+     *
+     * @param[in] expected Expected status
+     * @param[in] actual Actual status
+     */
+    void assertStatus(PsdConvert::Status expected, PsdConvert::Status actual)
+    {
+        TEST_ASSERT_EQUAL_STRING(PsdConvert::getStatusString(expected), PsdConvert::getStatusString(actual));
+    }
+
+    /**
+     * @brief Convert the record and check it is converted whole
+     *
+     * @param[in] record Record data
+     * @return Converted text
+     */
+    std::string convert(const std::vector<uint8_t> &record)
+    {
+        PsdConvert::TextOutput output;
+        size_t recordSize = 0;
+
+        assertStatus(PsdConvert::Status::Converted, PsdConvert::convertRecord(record.data(), record.size(), output, recordSize));
+        TEST_ASSERT_EQUAL_size_t(record.size(), recordSize);
+
+        return output.text();
+    }
+} // namespace
+
+void setUp(void)
+{
+    // Power densities over several decades with a core peak and a zero DC bin
+    for (size_t idx = 0; idx < binCount; idx++)
+    {
+        psdAccel[idx] = static_cast<float>(1e-6 * (1 + idx % 7) + 2e-3 * exp(-0.5 * pow((idx - 40.0) / 2, 2)));
+        psdGyro[idx] = static_cast<float>(3e-9 * (1 + idx % 5) + 1e-4 / (1 + idx));
+    }
+    psdAccel[0] = 0;
+
+    header = {
+        .firmware = "1.4",
+        .batteryVoltage = 3912,
+        .batteryLevel = 87,
+        .startTime = {5, 4, 3, 2, 1, 54},
+        .loggingRate = 1000,
+        .measuredRate = 1000.0625,
+        .sampleClockPpm = 62.5,
+        .timerDriftPpm = -3.5,
+        .session = 1,
+        .isLightSleep = true,
+        .samples = 61440,
+        .missedDeadlines = 3,
+        .duplicatedSamples = 2,
+        .readFailures = 1,
+        .fifoOverflows = 4,
+        .invalidPackets = 5,
+        .droppedSegments = 6,
+        .batchIntervalMaxUs = 20480,
+        .intervalMeanUs = 999.9375,
+        .segmentSize = segmentSize,
+        .binCount = binCount,
+    };
+
+    channels = {
+        {.name = "ACC_X", .units = "m/s^2", .maximum = 1.5, .minimum = -1.25, .mean = 0.015625, .deviation = 0.375,
+         .psd = psdAccel.data(), .coreFrequency = 78.125, .coreAmplitude = 0.001953125},
+        {.name = "GYRO_X", .units = "rad/s", .maximum = 0.5, .minimum = -0.5, .mean = 0, .deviation = 0.125,
+         .psd = psdGyro.data(), .coreFrequency = 1.953125, .coreAmplitude = 0.0001},
+        {.name = "TEMP", .units = "degC", .maximum = 31.5, .minimum = 30.25, .mean = 30.75, .deviation = 0.25,
+         .psd = nullptr, .coreFrequency = 0, .coreAmplitude = 0},
+    };
+    // Core amplitude isn't float exact, the record stores float
+    channels[1].coreAmplitude = static_cast<float>(channels[1].coreAmplitude);
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief Float32 record converts to exactly the text the firmware writes for the same result
+ */
+void test_float32_round_trip(void)
+{
+    std::string expected = writeCsv();
+    std::string actual = convert(buildRecord(PsdRecord::BinEncoding::Float32));
+
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), actual.c_str());
+}
+
+/**
+ * @brief Log16 record converts to the text of the restored bins, restored bins are within the quantisation step
+ */
+void test_log16_round_trip(void)
+{
+    std::vector<uint8_t> record = buildRecord(PsdRecord::BinEncoding::Log16);
+
+    for (auto &channel : channels)
+    {
+        if (channel.psd == nullptr)
+        {
+            continue;
+        }
+
+        std::vector<uint16_t> codes(binCount);
+        float logMin;
+        float logStep;
+        PsdRecord::quantizeLog(channel.psd, binCount, codes.data(), logMin, logStep);
+
+        double *bins = const_cast<double *>(channel.psd);
+        std::vector<double> restored(binCount);
+        PsdRecord::dequantizeLog(codes.data(), binCount, logMin, logStep, restored.data());
+        for (size_t idx = 0; idx < binCount; idx++)
+        {
+            if (bins[idx] == 0)
+            {
+                TEST_ASSERT_EQUAL_DOUBLE(0, restored[idx]);
+            }
+            else
+            {
+                // Half of the step in log10 scale and the float precision of the log range
+                TEST_ASSERT_DOUBLE_WITHIN(logStep / 2 + 1e-6, log10(bins[idx]), log10(restored[idx]));
+            }
+            bins[idx] = restored[idx];
+        }
+    }
+
+    std::string expected = writeCsv();
+    std::string actual = convert(record);
+
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), actual.c_str());
+}
+
+/**
+ * @brief LogDelta record converts to the text of the restored bins
+ */
+void test_log_delta_round_trip(void)
+{
+    std::vector<uint8_t> record = buildRecord(PsdRecord::BinEncoding::LogDelta);
+
+    for (auto &channel : channels)
+    {
+        if (channel.psd == nullptr)
+        {
+            continue;
+        }
+
+        std::vector<uint8_t> data(binCount * PsdRecord::logDeltaBytesMax);
+        float logMin;
+        float logStep;
+        size_t size = PsdRecord::compressLog(channel.psd, binCount, resolutionDb, data.data(), logMin, logStep);
+
+        double *bins = const_cast<double *>(channel.psd);
+        TEST_ASSERT_EQUAL_size_t(size, PsdRecord::decompressLog(data.data(), size, binCount, logMin, logStep, bins));
+    }
+
+    std::string expected = writeCsv();
+    std::string actual = convert(record);
+
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), actual.c_str());
+}
+
+/**
+ * @brief Record of the older writer without the trailing header fields converts with them zeroed
+ */
+void test_short_header(void)
+{
+    std::vector<uint8_t> record = buildRecord(PsdRecord::BinEncoding::Float32, offsetof(PsdRecord::Header, lightSleep));
+
+    header.isLightSleep = false;
+    std::string expected = writeCsv();
+    std::string actual = convert(record);
+
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), actual.c_str());
+}
+
+/**
+ * @brief Records written one after another are converted one by one
+ */
+void test_consecutive_records(void)
+{
+    std::vector<uint8_t> data = buildRecord(PsdRecord::BinEncoding::Float32);
+    size_t firstSize = data.size();
+    std::vector<uint8_t> second = buildRecord(PsdRecord::BinEncoding::LogDelta);
+    data.insert(data.end(), second.begin(), second.end());
+
+    PsdConvert::TextOutput output;
+    size_t recordSize = 0;
+    assertStatus(PsdConvert::Status::Converted, PsdConvert::convertRecord(data.data(), data.size(), output, recordSize));
+    TEST_ASSERT_EQUAL_size_t(firstSize, recordSize);
+    assertStatus(PsdConvert::Status::Converted,
+                      PsdConvert::convertRecord(&data[recordSize], data.size() - recordSize, output, recordSize));
+    TEST_ASSERT_EQUAL_size_t(second.size(), recordSize);
+}
+
+/**
+ * @brief Truncated, corrupted and foreign data isn't converted
+ */
+void test_invalid_records(void)
+{
+    std::vector<uint8_t> record = buildRecord(PsdRecord::BinEncoding::Float32);
+    PsdConvert::TextOutput output;
+    size_t recordSize = 0;
+
+    for (size_t size : {size_t(0), size_t(4), sizeof(PsdRecord::Header), record.size() - 1})
+    {
+        assertStatus(PsdConvert::Status::Truncated, PsdConvert::convertRecord(record.data(), size, output, recordSize));
+    }
+
+    // Varint bins end is found by decoding
+    std::vector<uint8_t> compressed = buildRecord(PsdRecord::BinEncoding::LogDelta);
+    for (size_t size = sizeof(PsdRecord::Header); size < compressed.size(); size++)
+    {
+        assertStatus(PsdConvert::Status::Truncated, PsdConvert::convertRecord(compressed.data(), size, output, recordSize));
+    }
+
+    std::vector<uint8_t> corrupted = record;
+    corrupted[sizeof(PsdRecord::Header) + 1] ^= 0x01;
+    assertStatus(PsdConvert::Status::BadChecksum,
+                 PsdConvert::convertRecord(corrupted.data(), corrupted.size(), output, recordSize));
+
+    corrupted = record;
+    corrupted[0] ^= 0xFF;
+    assertStatus(PsdConvert::Status::BadMagic,
+                 PsdConvert::convertRecord(corrupted.data(), corrupted.size(), output, recordSize));
+
+    corrupted = record;
+    corrupted[offsetof(PsdRecord::Header, binEncoding)] = static_cast<uint8_t>(PsdRecord::BinEncoding::Count);
+    assertStatus(PsdConvert::Status::BadLayout,
+                 PsdConvert::convertRecord(corrupted.data(), corrupted.size(), output, recordSize));
+
+    TEST_ASSERT_EQUAL_size_t(0, output.text().size());
+}
+
+/**
+ * @brief Container records are taken from the index, their PSD records convert
+ */
+void test_container_index(void)
+{
+    Container container = buildContainer();
+    std::vector<PsdConvert::ContainerRecord> records;
+    bool isRebuilt = true;
+
+    TEST_ASSERT_TRUE(PsdConvert::readContainer(container.data.data(), container.data.size(), records, isRebuilt));
+    TEST_ASSERT_FALSE(isRebuilt);
+    checkRecords(container, records, container.entries.size());
+
+    std::string expected = writeCsv();
+    PsdConvert::TextOutput output;
+    size_t recordSize = 0;
+    assertStatus(PsdConvert::Status::Converted,
+                 PsdConvert::convertRecord(&container.data[records[0].offset], records[0].size, output, recordSize));
+    TEST_ASSERT_EQUAL_size_t(records[0].size, recordSize);
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), output.text().c_str());
+    TEST_ASSERT_EQUAL_MEMORY(expected.data(), &container.data[records[1].offset], records[1].size);
+
+    TEST_ASSERT_TRUE(PsdConvert::readContainer(nullptr, 0, records, isRebuilt));
+    TEST_ASSERT_EQUAL_size_t(0, records.size());
+}
+
+/**
+ * @brief Power fail at any point of the record or index writing leaves the whole records found by their trailers
+ */
+void test_container_rebuild(void)
+{
+    Container container = buildContainer();
+    std::vector<PsdConvert::ContainerRecord> records;
+    bool isRebuilt = false;
+
+    // Whole records before the cut
+    size_t lastEnd = container.indexOffset;
+    size_t previousEnd = container.entries.back().offset;
+    for (size_t size = previousEnd; size < container.data.size(); size++)
+    {
+        size_t count = (size >= lastEnd) ? container.entries.size() : container.entries.size() - 1;
+
+        TEST_ASSERT_TRUE(PsdConvert::readContainer(container.data.data(), size, records, isRebuilt));
+        TEST_ASSERT_TRUE(isRebuilt);
+        checkRecords(container, records, count);
+    }
+
+    // Broken footer CRC
+    std::vector<uint8_t> data = container.data;
+    data[data.size() - sizeof(ResultContainer::Footer) + offsetof(ResultContainer::Footer, crc)] ^= 0x01;
+    TEST_ASSERT_TRUE(PsdConvert::readContainer(data.data(), data.size(), records, isRebuilt));
+    TEST_ASSERT_TRUE(isRebuilt);
+    checkRecords(container, records, container.entries.size());
+
+    // Broken trailer cuts the records after it
+    data = container.data;
+    data[container.entries[1].offset + container.sizes[1] + offsetof(ResultContainer::RecordTrailer, time)] ^= 0x01;
+    data.resize(container.indexOffset);
+    TEST_ASSERT_TRUE(PsdConvert::readContainer(data.data(), data.size(), records, isRebuilt));
+    checkRecords(container, records, 1);
+
+    // Cut first record
+    TEST_ASSERT_FALSE(PsdConvert::readContainer(container.data.data(), container.sizes[0], records, isRebuilt));
+}
+
+/**
+ * @brief Records of the time range are found by the index only, the records out of the range aren't read
+ */
+void test_container_time_range(void)
+{
+    Container container = buildContainer();
+    const std::vector<uint8_t> &data = container.data;
+
+    size_t bytesRead = 0;
+    auto read = [&data, &bytesRead](size_t position, void *buffer, size_t size)
+    {
+        bool result = (position + size <= data.size());
+        if (result == true)
+        {
+            memcpy(buffer, &data[position], size);
+            bytesRead += size;
+        }
+
+        return result;
+    };
+
+    std::vector<PsdConvert::ContainerRecord> records;
+    bool isRebuilt = true;
+    size_t indexSize = sizeof(ResultContainer::Footer) + container.entries.size() * sizeof(ResultContainer::IndexEntry);
+
+    // The middle record only, the range ends are between the records
+    TEST_ASSERT_TRUE(PsdConvert::readContainer(read, data.size(), {.from = 1725000001, .to = 1725001199}, records, isRebuilt));
+    TEST_ASSERT_FALSE(isRebuilt);
+    TEST_ASSERT_EQUAL_size_t(indexSize, bytesRead);
+    TEST_ASSERT_EQUAL_size_t(1, records.size());
+    TEST_ASSERT_EQUAL_size_t(container.entries[1].offset, records[0].offset);
+    TEST_ASSERT_EQUAL_size_t(container.sizes[1], records[0].size);
+    TEST_ASSERT_EQUAL_UINT32(container.entries[1].time, records[0].time);
+
+    // Extraction reads the record of the range only
+    std::vector<uint8_t> record(records[0].size);
+    TEST_ASSERT_TRUE(read(records[0].offset, record.data(), record.size()));
+    TEST_ASSERT_EQUAL_size_t(indexSize + container.sizes[1], bytesRead);
+    TEST_ASSERT_TRUE(data.size() - bytesRead > container.sizes[0] + container.sizes[2]);
+
+    // The range ends are included
+    bytesRead = 0;
+    TEST_ASSERT_TRUE(PsdConvert::readContainer(read, data.size(), {.from = 1725000600, .to = 1725001200}, records, isRebuilt));
+    TEST_ASSERT_EQUAL_size_t(indexSize, bytesRead);
+    TEST_ASSERT_EQUAL_size_t(2, records.size());
+    TEST_ASSERT_EQUAL_UINT32(container.entries[1].time, records[0].time);
+    TEST_ASSERT_EQUAL_UINT32(container.entries[2].time, records[1].time);
+
+    // No records before and after the container records
+    TEST_ASSERT_TRUE(PsdConvert::readContainer(read, data.size(), {.from = 0, .to = 1724999999}, records, isRebuilt));
+    TEST_ASSERT_EQUAL_size_t(0, records.size());
+    TEST_ASSERT_TRUE(PsdConvert::readContainer(read, data.size(), {.from = 1725001201, .to = UINT32_MAX}, records, isRebuilt));
+    TEST_ASSERT_EQUAL_size_t(0, records.size());
+
+    // Broken footer: the trailer scanning finds the records, the range is applied to them
+    std::vector<uint8_t> cut(data.begin(), data.begin() + container.indexOffset);
+    TEST_ASSERT_TRUE(PsdConvert::readContainer([&cut](size_t position, void *buffer, size_t size)
+                                               {
+                                                   memcpy(buffer, &cut[position], size);
+                                                   return true;
+                                               },
+                                               cut.size(), {.from = 1725000600, .to = 1725000600}, records, isRebuilt));
+    TEST_ASSERT_TRUE(isRebuilt);
+    TEST_ASSERT_EQUAL_size_t(1, records.size());
+    TEST_ASSERT_EQUAL_size_t(container.entries[1].offset, records[0].offset);
+    TEST_ASSERT_EQUAL_size_t(container.sizes[1], records[0].size);
+}
+
+/**
+ * @brief Container of the other format version isn't read
+ */
+void test_container_other_version(void)
+{
+    Container container;
+    container.add(buildRecord(PsdRecord::BinEncoding::Float32), 1725000000);
+    container.finish(ResultContainer::version + 1);
+
+    std::vector<PsdConvert::ContainerRecord> records;
+    bool isRebuilt = false;
+    TEST_ASSERT_FALSE(PsdConvert::readContainer(container.data.data(), container.data.size(), records, isRebuilt));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_float32_round_trip);
+    RUN_TEST(test_log16_round_trip);
+    RUN_TEST(test_log_delta_round_trip);
+    RUN_TEST(test_short_header);
+    RUN_TEST(test_consecutive_records);
+    RUN_TEST(test_invalid_records);
+    RUN_TEST(test_container_index);
+    RUN_TEST(test_container_rebuild);
+    RUN_TEST(test_container_time_range);
+    RUN_TEST(test_container_other_version);
+
+    return UNITY_END();
+}
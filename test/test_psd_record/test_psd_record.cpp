@@ -0,0 +1,258 @@
+/**
+ * @file test_psd_record.cpp
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Host tests of the PSD record bins encodings: Log16 and LogDelta restore the bins within half of the step
+ * @version 0.1
+ * @date 2024-09-10
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <random>
+#include <vector>
+
+#include <unity.h>
+
+#include "Measurements/PsdRecord.h"
+
+using namespace Measurements;
+
+namespace
+{
+    // Number of PSD bins (1024 points segment)
+    constexpr size_t binCount = 513;
+    // Number of random spectra per resolution
+    constexpr size_t spectrumCount = 50;
+    // Power ratio of one decade, dB
+    constexpr double decibelsPerDecade = 10;
+    // Error of the double calculations of the restored bins, dB
+    constexpr double calculationErrorDb = 1e-9;
+
+    std::mt19937 generator(47);
+
+    /**
+     * @brief Make random spectrum: noise floor over several decades, peaks and zero bins
+     *
+     * @param[in] decades Range of the bins, decades
+     * @return PSD bins
+     */
+    std::vector<double> makeSpectrum(double decades)
+    {
+        std::uniform_real_distribution<double> uniform(0, 1);
+        std::normal_distribution<double> noise(0, 0.3);
+
+        std::vector<double> bins(binCount);
+        double floorLog = -decades / 2;
+        for (size_t idx = 0; idx < binCount; idx++)
+        {
+            // Floor falls by the range over the bins, the noise makes neighbours differ
+            double log = floorLog + decades * (1 - static_cast<double>(idx) / binCount) / 2 + noise(generator);
+            bins[idx] = pow(10, log);
+            if (uniform(generator) < 0.02)
+            {
+                bins[idx] *= 1e3;
+            }
+            if (uniform(generator) < 0.01)
+            {
+                bins[idx] = 0;
+            }
+        }
+        bins[0] = 0;
+
+        return bins;
+    }
+
+    /**
+     * @brief Compress and restore the bins, check every non-zero bin is within the bound and zero bins are exact
+     *
+     * @param[in] bins PSD bins
+     * @param[in] resolutionDb Quantisation resolution, dB
+     * @param[out] logStep log10 step of the quantisation
+     * @return Maximum error of the restored bins, dB
+     */
+    double checkLogDelta(const std::vector<double> &bins, float resolutionDb, float &logStep)
+    {
+        std::vector<uint8_t> data(bins.size() * PsdRecord::logDeltaBytesMax);
+        float logMin;
+        size_t size = PsdRecord::compressLog(bins.data(), bins.size(), resolutionDb, data.data(), logMin, logStep);
+
+        std::vector<double> restored(bins.size());
+        TEST_ASSERT_EQUAL_size_t(size, PsdRecord::decompressLog(data.data(), size, bins.size(), logMin, logStep, restored.data()));
+
+        double errorMaxDb = 0;
+        double boundDb = decibelsPerDecade * logStep / 2 + calculationErrorDb;
+        for (size_t idx = 0; idx < bins.size(); idx++)
+        {
+            if (bins[idx] == 0)
+            {
+                TEST_ASSERT_EQUAL_DOUBLE(0, restored[idx]);
+                continue;
+            }
+
+            double errorDb = fabs(decibelsPerDecade * log10(restored[idx] / bins[idx]));
+            TEST_ASSERT_DOUBLE_WITHIN(boundDb, 0, errorDb);
+            errorMaxDb = (errorDb > errorMaxDb) ? errorDb : errorMaxDb;
+        }
+
+        return errorMaxDb;
+    }
+} // namespace
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief Log16 restores every non-zero bin within half of the step spreading the range over the codes
+ */
+void test_log16_bound(void)
+{
+    for (size_t spectrum = 0; spectrum < spectrumCount; spectrum++)
+    {
+        std::vector<double> bins = makeSpectrum(12);
+        std::vector<uint16_t> codes(binCount);
+        float logMin;
+        float logStep;
+        PsdRecord::quantizeLog(bins.data(), binCount, codes.data(), logMin, logStep);
+
+        std::vector<double> restored(binCount);
+        PsdRecord::dequantizeLog(codes.data(), binCount, logMin, logStep, restored.data());
+        for (size_t idx = 0; idx < binCount; idx++)
+        {
+            if (bins[idx] == 0)
+            {
+                TEST_ASSERT_EQUAL_UINT16(0, codes[idx]);
+                TEST_ASSERT_EQUAL_DOUBLE(0, restored[idx]);
+            }
+            else
+            {
+                TEST_ASSERT_DOUBLE_WITHIN(logStep / 2 + 1e-12, log10(bins[idx]), log10(restored[idx]));
+            }
+        }
+    }
+}
+
+/**
+ * @brief LogDelta restores every non-zero bin within +-resolution / 2 dB
+ */
+void test_log_delta_bound(void)
+{
+    for (float resolutionDb : {0.01f, 0.1f, 1.0f, 2.55f})
+    {
+        double errorMaxDb = 0;
+        for (size_t spectrum = 0; spectrum < spectrumCount; spectrum++)
+        {
+            float logStep;
+            double errorDb = checkLogDelta(makeSpectrum(8), resolutionDb, logStep);
+            errorMaxDb = (errorDb > errorMaxDb) ? errorDb : errorMaxDb;
+
+            // Range fits the codes, the step is the resolution
+            TEST_ASSERT_EQUAL_FLOAT(resolutionDb / decibelsPerDecade, logStep);
+        }
+
+        char message[80];
+        snprintf(message, sizeof(message), "Resolution %.2f dB: maximum error %.4f dB", resolutionDb, errorMaxDb);
+        TEST_MESSAGE(message);
+        TEST_ASSERT_TRUE(errorMaxDb <= resolutionDb / 2 + calculationErrorDb);
+    }
+}
+
+/**
+ * @brief Range too wide for the resolution widens the step, the bins are restored within half of the widened step
+ */
+void test_log_delta_widened_step(void)
+{
+    constexpr float resolutionDb = 0.01;
+
+    std::vector<double> bins = makeSpectrum(300);
+    // The extremes take the first and the last codes
+    bins[1] = 1e-200;
+    bins[2] = 1e200;
+
+    float logStep;
+    double errorMaxDb = checkLogDelta(bins, resolutionDb, logStep);
+
+    TEST_ASSERT_TRUE(logStep > resolutionDb / decibelsPerDecade);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3 * logStep, 400.0 / (UINT16_MAX - 1), logStep);
+    TEST_ASSERT_TRUE(errorMaxDb <= decibelsPerDecade * logStep / 2 + calculationErrorDb);
+
+    char message[80];
+    snprintf(message, sizeof(message), "Widened step %.4f dB: maximum error %.4f dB", decibelsPerDecade * logStep, errorMaxDb);
+    TEST_MESSAGE(message);
+}
+
+/**
+ * @brief Smooth spectrum takes about a byte per bin, the decoder finds the end of the bins
+ */
+void test_log_delta_size(void)
+{
+    std::vector<double> bins(binCount);
+    for (size_t idx = 0; idx < binCount; idx++)
+    {
+        bins[idx] = 1e-6 / (1 + idx) + 1e-3 * exp(-0.5 * pow((idx - 100.0) / 5, 2));
+    }
+
+    std::vector<uint8_t> data(binCount * PsdRecord::logDeltaBytesMax + 8, 0xFF);
+    float logMin;
+    float logStep;
+    size_t size = PsdRecord::compressLog(bins.data(), binCount, 0.1, data.data(), logMin, logStep);
+
+    char message[80];
+    snprintf(message, sizeof(message), "%u bins: %u bytes, %.2f bytes per bin", static_cast<unsigned>(binCount),
+             static_cast<unsigned>(size), static_cast<double>(size) / binCount);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(size < binCount * 5 / 4);
+
+    // Data after the bins isn't taken
+    std::vector<double> restored(binCount);
+    TEST_ASSERT_EQUAL_size_t(size, PsdRecord::decompressLog(data.data(), data.size(), binCount, logMin, logStep, restored.data()));
+}
+
+/**
+ * @brief Truncated and malformed data isn't decoded
+ */
+void test_log_delta_invalid_data(void)
+{
+    std::vector<double> bins = makeSpectrum(8);
+    std::vector<uint8_t> data(binCount * PsdRecord::logDeltaBytesMax);
+    float logMin;
+    float logStep;
+    size_t size = PsdRecord::compressLog(bins.data(), binCount, 0.1, data.data(), logMin, logStep);
+
+    std::vector<double> restored(binCount);
+    TEST_ASSERT_EQUAL_size_t(0, PsdRecord::decompressLog(data.data(), size - 1, binCount, logMin, logStep, restored.data()));
+    TEST_ASSERT_EQUAL_size_t(0, PsdRecord::decompressLog(nullptr, 0, binCount, logMin, logStep, restored.data()));
+
+    // Varint longer than the Log16 delta
+    const uint8_t tooLong[] = {0x80, 0x80, 0x80, 0x01};
+    TEST_ASSERT_EQUAL_size_t(0, PsdRecord::decompressLog(tooLong, sizeof(tooLong), 1, logMin, logStep, restored.data()));
+
+    // Code below zero (delta -1 from 0) and above the Log16 range (65536)
+    const uint8_t negative[] = {0x01};
+    TEST_ASSERT_EQUAL_size_t(0, PsdRecord::decompressLog(negative, sizeof(negative), 1, logMin, logStep, restored.data()));
+    const uint8_t overflow[] = {0x80, 0x80, 0x08};
+    TEST_ASSERT_EQUAL_size_t(0, PsdRecord::decompressLog(overflow, sizeof(overflow), 1, logMin, logStep, restored.data()));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_log16_bound);
+    RUN_TEST(test_log_delta_bound);
+    RUN_TEST(test_log_delta_widened_step);
+    RUN_TEST(test_log_delta_size);
+    RUN_TEST(test_log_delta_invalid_data);
+
+    return UNITY_END();
+}
@@ -0,0 +1,275 @@
+/**
+ * @file test_raw_capture_benchmark.cpp
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Host benchmark of the sustained raw capture: 1 kHz x 6 axes blocks with marks are streamed through the
+ * capture ring to a card with modelled write latency spikes while the PSD pipeline analyses the same samples
+ * @version 0.1
+ * @date 2024-09-06
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+#include <esp_timer.h>
+#include <SdFat.h>
+#include <unity.h>
+
+#include "Measurements/Psd.h"
+#include "Measurements/RawCapture.h"
+
+using namespace Measurements;
+
+namespace
+{
+    // Sampling frequency, Hz
+    constexpr size_t sampleFrequency = 1000;
+    // Capture duration, seconds (several card stalls and ring lengths)
+    constexpr size_t captureSeconds = 8;
+    // Samples of the IMU FIFO block
+    constexpr size_t blockSize = 16;
+    // PSD segment size, samples
+    constexpr size_t segmentSize = 1024;
+    // Raw file header size (see RawCapture.h)
+    constexpr size_t rawHeaderSize = 512;
+
+    // Card timing: SPI sector write of 1.5 ms, the card is busy for 250 ms every 64 sectors
+    constexpr SdCardModel cardModel = {.writeUs = 1500, .stallPeriod = 64, .stallUs = 250000};
+
+    // Raw files directory and the file name
+    const char *directory = "RAW";
+    const char *fileName = "bench";
+
+    // Samples of the IMU task, the first "produced" samples are captured and can be analysed
+    std::vector<RawCapture::Sample> recording;
+    std::atomic<size_t> produced(0);
+
+    // PSD channels
+    PSD<int16_t> psd[6];
+    int16_t channels[6][segmentSize];
+
+    /**
+     * @brief Synthesize the recording: a tone on every axis
+     */
+    void synthesizeRecording()
+    {
+        const double tones[6] = {12.5, 40.0, 7.0, 3.0, 110.0, 61.0};
+
+        recording.resize(sampleFrequency * captureSeconds);
+        for (size_t idx = 0; idx < recording.size(); idx++)
+        {
+            double time = static_cast<double>(idx) / sampleFrequency;
+            int16_t values[6];
+            for (size_t axis = 0; axis < 6; axis++)
+            {
+                values[axis] = lround((1000 + 500 * axis) * sin(2 * M_PI * tones[axis] * time));
+            }
+
+            recording[idx] = {.accX = values[0], .accY = values[1], .accZ = values[2],
+                              .gyrX = values[3], .gyrY = values[4], .gyrZ = values[5]};
+        }
+    }
+
+    /**
+     * @brief IMU task: adds the FIFO blocks to the capture in real time, every block is followed by its mark
+     */
+    void imuTask()
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const auto blockPeriod = std::chrono::microseconds(1000000 * blockSize / sampleFrequency);
+
+        for (size_t offset = 0; offset < recording.size(); offset += blockSize)
+        {
+            std::this_thread::sleep_until(start + blockPeriod * (offset / blockSize + 1));
+
+            for (size_t idx = offset; idx < offset + blockSize && idx < recording.size(); idx++)
+            {
+                RawCapture::write(recording[idx]);
+            }
+            produced.store(offset + blockSize, std::memory_order_release);
+
+            RawCapture::mark(esp_timer_get_time());
+        }
+    }
+
+    /**
+     * @brief Analyse the captured segment on all axes
+     *
+     * @param[in] segment Segment index
+     */
+    void analyseSegment(size_t segment)
+    {
+        for (size_t idx = 0; idx < segmentSize; idx++)
+        {
+            const RawCapture::Sample &sample = recording[segment * segmentSize + idx];
+            channels[0][idx] = sample.accX;
+            channels[1][idx] = sample.accY;
+            channels[2][idx] = sample.accZ;
+            channels[3][idx] = sample.gyrX;
+            channels[4][idx] = sample.gyrY;
+            channels[5][idx] = sample.gyrZ;
+        }
+
+        for (size_t axis = 0; axis < 6; axis++)
+        {
+            psd[axis].computeSegment(channels[axis]);
+        }
+    }
+
+    /**
+     * @brief Read the raw file back
+     *
+     * @param[out] samples Samples of the file
+     * @param[out] marks Block mark times of the file, microseconds
+     * @return Size of the file, bytes
+     */
+    size_t readRawFile(std::vector<RawCapture::Sample> &samples, std::vector<int64_t> &marks)
+    {
+        std::filesystem::path path = std::filesystem::temp_directory_path() / "sd" / directory / fileName;
+        path += ".raw";
+
+        FILE *file = fopen(path.c_str(), "rb");
+        TEST_ASSERT_NOT_NULL(file);
+
+        char header[rawHeaderSize + 1] = {0};
+        TEST_ASSERT_EQUAL_size_t(rawHeaderSize, fread(header, 1, rawHeaderSize, file));
+        TEST_ASSERT_EQUAL_INT(0, strncmp(header, "RAW,2", 5));
+
+        RawCapture::Sample sample;
+        while (fread(&sample, sizeof(sample), 1, file) == 1)
+        {
+            bool isMark = (sample.accX == RawCapture::blockMarker && sample.accY == RawCapture::blockMarker);
+            if (isMark == true)
+            {
+                RawCapture::BlockMark mark;
+                memcpy(&mark, &sample, sizeof(mark));
+                marks.push_back(mark.timeUs);
+            }
+            else
+            {
+                samples.push_back(sample);
+            }
+        }
+
+        size_t size = ftell(file);
+        fclose(file);
+
+        return size;
+    }
+} // namespace
+
+void setUp(void)
+{
+    FsFile::cardModel = cardModel;
+}
+
+void tearDown(void)
+{
+    FsFile::cardModel = {0, 0, 0};
+}
+
+/**
+ * @brief Capture 1 kHz x 6 axes in real time alongside PSD and check every sample reaches the file
+ */
+void test_sustained_capture_benchmark(void)
+{
+    synthesizeRecording();
+    for (auto &channel : psd)
+    {
+        channel.setup(segmentSize, sampleFrequency);
+    }
+
+    RawCapture::initialize();
+
+    RawCapture::Setup setup = {
+        .directory = directory,
+        .fileName = fileName,
+        .sampleFrequency = sampleFrequency,
+        .duration = captureSeconds + 1,
+        .accelScale = 2 * 9.81f / 32768,
+        .gyroScale = 250 * static_cast<float>(M_PI) / 180 / 32768,
+    };
+    TEST_ASSERT_TRUE(RawCapture::start(setup));
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread imu(imuTask);
+
+    // PSD pipeline analyses the segments as they are acquired
+    double psdSumUs = 0;
+    double psdMaxUs = 0;
+    size_t segmentCount = recording.size() / segmentSize;
+    for (size_t segment = 0; segment < segmentCount; segment++)
+    {
+        while (produced.load(std::memory_order_acquire) < (segment + 1) * segmentSize)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        auto segmentStart = std::chrono::steady_clock::now();
+        analyseSegment(segment);
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - segmentStart).count();
+
+        psdSumUs += us;
+        psdMaxUs = (us > psdMaxUs) ? us : psdMaxUs;
+    }
+
+    imu.join();
+    RawCapture::stop();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    RawCapture::Stats stats = RawCapture::stats();
+    size_t ringBytes = sizeof(RawCapture::Sample) * (stats.samples + stats.marks);
+    double requiredRate = ringBytes / seconds / 1000;
+    double cardRate = (stats.writeSumUs > 0) ? static_cast<double>(stats.bytes) * 1000 / stats.writeSumUs : 0;
+
+    char message[160];
+    snprintf(message, sizeof(message), "%u Hz x 6 axes, %.1f s: %u samples, %u marks, %u overruns, %u bytes",
+             static_cast<unsigned>(sampleFrequency), seconds, stats.samples, stats.marks, stats.overruns, stats.bytes);
+    TEST_MESSAGE(message);
+    snprintf(message, sizeof(message), "Stream %.1f KB/s, card %.1f KB/s, sector write max %u us, ring max %u bytes",
+             requiredRate, cardRate, stats.writeMaxUs, stats.ringUsedMax);
+    TEST_MESSAGE(message);
+    snprintf(message, sizeof(message), "PSD 6 axes x %u points: mean %.1f us, max %.1f us per segment",
+             static_cast<unsigned>(segmentSize), psdSumUs / segmentCount, psdMaxUs);
+    TEST_MESSAGE(message);
+
+    // Nothing is dropped, the whole stream reaches the file
+    TEST_ASSERT_EQUAL_UINT32(0, stats.overruns);
+    TEST_ASSERT_EQUAL_UINT32(recording.size(), stats.samples);
+    TEST_ASSERT_EQUAL_size_t(ringBytes, stats.bytes);
+    TEST_ASSERT_TRUE(cardRate > requiredRate);
+    TEST_ASSERT_TRUE(psdMaxUs < 1e6 * segmentSize / sampleFrequency);
+
+    std::vector<RawCapture::Sample> samples;
+    std::vector<int64_t> marks;
+    size_t fileSize = readRawFile(samples, marks);
+
+    TEST_ASSERT_EQUAL_size_t(rawHeaderSize + stats.bytes, fileSize);
+    TEST_ASSERT_EQUAL_size_t(recording.size(), samples.size());
+    TEST_ASSERT_EQUAL_MEMORY(recording.data(), samples.data(), recording.size() * sizeof(RawCapture::Sample));
+    TEST_ASSERT_EQUAL_size_t(stats.marks, marks.size());
+    for (size_t idx = 1; idx < marks.size(); idx++)
+    {
+        TEST_ASSERT_TRUE(marks[idx] - marks[idx - 1] >= RawCapture::blockMarkIntervalUs);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_sustained_capture_benchmark);
+
+    return UNITY_END();
+}
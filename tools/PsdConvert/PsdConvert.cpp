@@ -0,0 +1,511 @@
+/**
+ * @file PsdConvert.cpp
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Host converter of the binary PSD records to the text (CSV) results implementation
+ * @version 0.1
+ * @date 2024-09-02
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include "PsdConvert.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <FastCRC.h>
+
+#include "Measurements/PsdRecord.h"
+#include "Measurements/ResultContainer.h"
+#include "Measurements/ResultCsv.h"
+
+using namespace Measurements;
+
+namespace
+{
+    // Size of the record header fields every record has (up to the bins layout)
+    constexpr size_t headerSizeMin = offsetof(PsdRecord::Header, binCount) + sizeof(PsdRecord::Header::binCount);
+    // Size of the record CRC, bytes
+    constexpr size_t crcSize = sizeof(uint32_t);
+
+    /**
+     * @brief Decoded channel of the record
+     */
+    struct Channel
+    {
+        PsdRecord::ChannelDescriptor descriptor; // Channel descriptor
+        char name[PsdRecord::nameLength + 1];    // Zero terminated channel name
+        char units[PsdRecord::unitsLength + 1];  // Zero terminated channel units
+        std::vector<double> psd;                 // PSD bins (empty if the channel has statistics only)
+    };
+
+    /**
+     * @brief Sequential reader of the record data
+     */
+    class Reader
+    {
+    public:
+        /**
+         * @brief Construct a new reader
+         *
+         * @param[in] data Record data
+         * @param[in] size Size of the data, bytes
+         */
+        Reader(const uint8_t *data, size_t size) : _data(data), _size(size), _offset(0)
+        {
+        }
+
+        /**
+         * @brief Read data at the current offset
+         *
+         * @param[out] buffer Buffer to read to
+         * @param[in] size Number of bytes to read
+         * @return true if data is read, false if the record data ends before
+         */
+        bool read(void *buffer, size_t size)
+        {
+            if (size > _size - _offset)
+            {
+                return false;
+            }
+
+            memcpy(buffer, &_data[_offset], size);
+            _offset += size;
+
+            return true;
+        }
+
+        /**
+         * @brief Skip data at the current offset
+         *
+         * @param[in] size Number of bytes to skip
+         * @return true if data is skipped, false if the record data ends before
+         */
+        bool skip(size_t size)
+        {
+            if (size > _size - _offset)
+            {
+                return false;
+            }
+
+            _offset += size;
+
+            return true;
+        }
+
+        /**
+         * @brief Get data at the current offset
+         *
+         * @return Pointer to the data
+         */
+        const uint8_t *current() const
+        {
+            return &_data[_offset];
+        }
+
+        /**
+         * @brief Get number of bytes after the current offset
+         *
+         * @return Number of bytes
+         */
+        size_t remaining() const
+        {
+            return _size - _offset;
+        }
+
+        /**
+         * @brief Get the current offset
+         *
+         * @return Offset from the record start, bytes
+         */
+        size_t offset() const
+        {
+            return _offset;
+        }
+
+    private:
+        const uint8_t *_data; // Record data
+        size_t _size;         // Size of the data, bytes
+        size_t _offset;       // Offset of the next reading
+    };
+
+    /**
+     * @brief Read record header, trailing fields unknown to the writer are zeros
+     *
+     * @param[in] reader Record reader
+     * @param[out] header Record header
+     * @return Status of the reading
+     */
+    PsdConvert::Status readHeader(Reader &reader, PsdRecord::Header &header)
+    {
+        header = {0};
+
+        const size_t prefixSize = offsetof(PsdRecord::Header, binEncoding);
+        bool result = reader.read(&header, prefixSize);
+        if (result == false)
+        {
+            return PsdConvert::Status::Truncated;
+        }
+
+        if (header.magic != PsdRecord::magic)
+        {
+            return PsdConvert::Status::BadMagic;
+        }
+
+        if (header.version != PsdRecord::version || header.headerSize < headerSizeMin)
+        {
+            return PsdConvert::Status::BadLayout;
+        }
+
+        // Newer writers may add fields this reader doesn't know
+        size_t knownSize = (header.headerSize < sizeof(header)) ? header.headerSize : sizeof(header);
+        result = reader.read(reinterpret_cast<uint8_t *>(&header) + prefixSize, knownSize - prefixSize) &&
+                 reader.skip(header.headerSize - knownSize);
+        if (result == false)
+        {
+            return PsdConvert::Status::Truncated;
+        }
+
+        if (header.binEncoding >= static_cast<uint8_t>(PsdRecord::BinEncoding::Count))
+        {
+            return PsdConvert::Status::BadLayout;
+        }
+
+        return PsdConvert::Status::Converted;
+    }
+
+    /**
+     * @brief Read PSD bins of the channel
+     *
+     * @param[in] reader Record reader
+     * @param[in] header Record header
+     * @param[in,out] channel Channel with the read descriptor, gets the bins
+     * @return Status of the reading
+     */
+    PsdConvert::Status readBins(Reader &reader, const PsdRecord::Header &header, Channel &channel)
+    {
+        const PsdRecord::ChannelDescriptor &descriptor = channel.descriptor;
+        PsdRecord::BinEncoding encoding = static_cast<PsdRecord::BinEncoding>(header.binEncoding);
+
+        channel.psd.resize(header.binCount);
+
+        bool result = false;
+        if (encoding == PsdRecord::BinEncoding::Float32)
+        {
+            std::vector<float> bins(header.binCount);
+            result = reader.read(bins.data(), bins.size() * sizeof(float));
+            for (size_t idx = 0; idx < bins.size() && result == true; idx++)
+            {
+                channel.psd[idx] = bins[idx];
+            }
+        }
+        else if (encoding == PsdRecord::BinEncoding::Log16)
+        {
+            std::vector<uint16_t> codes(header.binCount);
+            result = reader.read(codes.data(), codes.size() * sizeof(uint16_t));
+            if (result == true)
+            {
+                PsdRecord::dequantizeLog(codes.data(), codes.size(), descriptor.logMin, descriptor.logStep, channel.psd.data());
+            }
+        }
+        else if (encoding == PsdRecord::BinEncoding::LogDelta)
+        {
+            // Varints are self delimiting, the decoder finds the end of the bins
+            size_t size = PsdRecord::decompressLog(reader.current(), reader.remaining(), header.binCount,
+                                                   descriptor.logMin, descriptor.logStep, channel.psd.data());
+            result = (size > 0 || header.binCount == 0) && reader.skip(size);
+        }
+        else
+        {
+            return PsdConvert::Status::BadLayout;
+        }
+
+        return (result == true) ? PsdConvert::Status::Converted : PsdConvert::Status::Truncated;
+    }
+} // namespace
+
+/**
+ * @brief Print formatted string
+ *
+ * @param[in] format Format string
+ * @param[in] ... Arguments
+ * @return true always
+ */
+bool PsdConvert::TextOutput::printf(const char *format, ...)
+{
+    va_list args;
+
+    va_start(args, format);
+    int length = vsnprintf(nullptr, 0, format, args);
+    va_end(args);
+
+    if (length > 0)
+    {
+        size_t offset = _text.size();
+        _text.resize(offset + length + 1);
+
+        va_start(args, format);
+        vsnprintf(&_text[offset], length + 1, format, args);
+        va_end(args);
+
+        _text.resize(offset + length);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Print string and the line end
+ *
+ * @param[in] string String to print
+ * @return true always
+ */
+bool PsdConvert::TextOutput::println(const char *string)
+{
+    _text += string;
+    _text += "\r\n";
+
+    return true;
+}
+
+/**
+ * @brief Convert the binary PSD record to text in the same way as the firmware writes CSV results
+ *
+ * @param[in] data Record data, may be followed by other data
+ * @param[in] size Size of the data, bytes
+ * @param[out] output Text output
+ * @param[out] recordSize Size of the record with its CRC, bytes (valid if the record is converted)
+ * @return Status of the conversion
+ */
+PsdConvert::Status PsdConvert::convertRecord(const uint8_t *data, size_t size, TextOutput &output, size_t &recordSize)
+{
+    Reader reader(data, size);
+
+    PsdRecord::Header header;
+    Status status = readHeader(reader, header);
+    if (status != Status::Converted)
+    {
+        return status;
+    }
+
+    std::vector<Channel> channels(header.channelCount);
+    for (auto &channel : channels)
+    {
+        bool result = reader.read(&channel.descriptor, sizeof(channel.descriptor));
+        if (result == false)
+        {
+            return Status::Truncated;
+        }
+
+        snprintf(channel.name, sizeof(channel.name), "%.*s", static_cast<int>(PsdRecord::nameLength), channel.descriptor.name);
+        snprintf(channel.units, sizeof(channel.units), "%.*s", static_cast<int>(PsdRecord::unitsLength), channel.descriptor.units);
+
+        if (channel.descriptor.hasPsd != 0)
+        {
+            status = readBins(reader, header, channel);
+            if (status != Status::Converted)
+            {
+                return status;
+            }
+        }
+    }
+
+    uint32_t storedCrc;
+    size_t crcOffset = reader.offset();
+    bool result = reader.read(&storedCrc, sizeof(storedCrc));
+    if (result == false)
+    {
+        return Status::Truncated;
+    }
+
+    FastCRC32 crc32;
+    if (crc32.crc32(data, crcOffset) != storedCrc)
+    {
+        return Status::BadChecksum;
+    }
+    recordSize = crcOffset + crcSize;
+
+    char firmware[PsdRecord::firmwareLength + 1];
+    snprintf(firmware, sizeof(firmware), "%.*s", static_cast<int>(PsdRecord::firmwareLength), header.firmware);
+
+    ResultCsv::Header csvHeader = {
+        .firmware = firmware,
+        .batteryVoltage = header.batteryVoltage,
+        .batteryLevel = header.batteryLevel,
+        .startTime = {header.startTime[0], header.startTime[1], header.startTime[2],
+                      header.startTime[3], header.startTime[4], header.startTime[5]},
+        .loggingRate = header.loggingRate,
+        .measuredRate = header.measuredRate,
+        .sampleClockPpm = header.sampleClockPpm,
+        .timerDriftPpm = header.timerDriftPpm,
+        .session = header.session,
+        .isLightSleep = (header.lightSleep != 0),
+        .samples = header.samples,
+        .missedDeadlines = header.missedDeadlines,
+        .duplicatedSamples = header.duplicatedSamples,
+        .readFailures = header.readFailures,
+        .fifoOverflows = header.fifoOverflows,
+        .invalidPackets = header.invalidPackets,
+        .droppedSegments = header.droppedSegments,
+        .batchIntervalMaxUs = header.batchIntervalMaxUs,
+        .intervalMeanUs = header.intervalMeanUs,
+        .segmentSize = header.segmentSize,
+        .binCount = header.binCount,
+    };
+
+    std::vector<ResultCsv::Channel> csvChannels;
+    for (const auto &channel : channels)
+    {
+        const PsdRecord::ChannelDescriptor &descriptor = channel.descriptor;
+
+        csvChannels.push_back({
+            .name = channel.name,
+            .units = channel.units,
+            .maximum = descriptor.maximum,
+            .minimum = descriptor.minimum,
+            .mean = descriptor.mean,
+            .deviation = descriptor.deviation,
+            .psd = (descriptor.hasPsd != 0) ? channel.psd.data() : nullptr,
+            .coreFrequency = descriptor.coreFrequency,
+            .coreAmplitude = descriptor.coreAmplitude,
+        });
+    }
+
+    ResultCsv::write(output, csvHeader, csvChannels.data(), csvChannels.size());
+
+    return Status::Converted;
+}
+
+/**
+ * @brief Find the records of the time range in the result container
+ * Only the footer and the index are read, the records of the range are found by binary search.
+ * The index is rebuilt from the record trailers if the footer is broken (power fail), as the firmware does
+ *
+ * @param[in] read Container reading
+ * @param[in] size Size of the container, bytes
+ * @param[in] range Time range of the records
+ * @param[out] records Container records of the time range
+ * @param[out] isRebuilt true if the index is rebuilt, false if it is taken from the footer
+ * @return true if the records are found, false if the container has the other version or no records are found
+ */
+bool PsdConvert::readContainer(const ContainerRead &read, size_t size, const TimeRange &range,
+                               std::vector<ContainerRecord> &records, bool &isRebuilt)
+{
+    records.clear();
+    isRebuilt = false;
+
+    if (size == 0)
+    {
+        return true;
+    }
+
+    std::vector<ResultContainer::IndexEntry> entries(ResultContainer::recordsMax);
+    size_t count = 0;
+    uint32_t endOffset = 0;
+
+    ResultContainer::Footer footer = {0};
+    bool result = (size >= sizeof(footer) && read(size - sizeof(footer), &footer, sizeof(footer)));
+    if (result == true && footer.magic == ResultContainer::magic && footer.version != ResultContainer::version)
+    {
+        return false;
+    }
+
+    if (result == true)
+    {
+        result = ResultContainer::checkFooter(footer, size);
+    }
+    if (result == true)
+    {
+        count = footer.recordCount;
+        endOffset = footer.indexOffset;
+        result = (count == 0 || read(footer.indexOffset, entries.data(), count * sizeof(ResultContainer::IndexEntry)));
+    }
+    if (result == true)
+    {
+        result = (ResultContainer::calculateCrc(entries.data(), footer) == footer.crc);
+    }
+
+    if (result == false)
+    {
+        count = ResultContainer::rebuildIndex(read, size, entries.data(), entries.size(), endOffset);
+        isRebuilt = true;
+        result = (count > 0);
+    }
+
+    // Record times are ascending
+    auto last = entries.begin() + count;
+    auto first = std::lower_bound(entries.begin(), last, range.from,
+                                  [](const ResultContainer::IndexEntry &entry, uint32_t time)
+                                  { return entry.time < time; });
+    last = std::upper_bound(first, last, range.to,
+                            [](uint32_t time, const ResultContainer::IndexEntry &entry)
+                            { return time < entry.time; });
+
+    for (auto entry = first; entry < last && result == true; entry++)
+    {
+        size_t idx = entry - entries.begin();
+        size_t offset = entry->offset;
+        size_t end = (idx + 1 < count) ? entries[idx + 1].offset : endOffset;
+
+        result = (end >= offset + sizeof(ResultContainer::RecordTrailer) && end <= size);
+        if (result == true)
+        {
+            records.push_back({
+                .offset = offset,
+                .size = end - offset - sizeof(ResultContainer::RecordTrailer),
+                .time = entry->time,
+            });
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Read all the records of the result container in memory
+ *
+ * @param[in] data Container data
+ * @param[in] size Size of the data, bytes
+ * @param[out] records Container records
+ * @param[out] isRebuilt true if the index is rebuilt, false if it is taken from the footer
+ * @return true if the records are read, false if the container has the other version or no records are found
+ */
+bool PsdConvert::readContainer(const uint8_t *data, size_t size, std::vector<ContainerRecord> &records, bool &isRebuilt)
+{
+    return readContainer([data](size_t position, void *buffer, size_t length)
+                         {
+                             memcpy(buffer, &data[position], length);
+                             return true;
+                         },
+                         size, {.from = 0, .to = UINT32_MAX}, records, isRebuilt);
+}
+
+/**
+ * @brief Get the description of the conversion status
+ *
+ * @param[in] status Status of the conversion
+ * @return Status description
+ */
+const char *PsdConvert::getStatusString(Status status)
+{
+    switch (status)
+    {
+    case Status::Converted:
+        return "converted";
+    case Status::Truncated:
+        return "record is truncated";
+    case Status::BadMagic:
+        return "not a PSD record";
+    case Status::BadLayout:
+        return "unsupported record layout";
+    case Status::BadChecksum:
+        return "record CRC mismatch";
+    default:
+        return "unknown status";
+    }
+}
@@ -0,0 +1,167 @@
+/**
+ * @file PsdConvert.h
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Host converter of the binary PSD records to the text (CSV) results API
+ * @version 0.1
+ * @date 2024-09-02
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#pragma once
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace PsdConvert
+{
+    /**
+     * @brief Status of the record conversion
+     */
+    enum class Status
+    {
+        Converted,   // Record is converted
+        Truncated,   // Data ends before the end of the record
+        BadMagic,    // Data isn't a PSD record
+        BadLayout,   // Record header or encoding isn't supported
+        BadChecksum, // Record CRC doesn't match its data
+    };
+
+    /**
+     * @brief Record of the result container
+     */
+    struct ContainerRecord
+    {
+        size_t offset; // Offset of the record from the beginning of the container
+        size_t size;   // Size of the record without its trailer, bytes
+        uint32_t time; // Epoch time of the record, seconds
+    };
+
+    /**
+     * @brief Time range of the container records, both ends are included
+     */
+    struct TimeRange
+    {
+        uint32_t from; // Epoch time of the first record, seconds
+        uint32_t to;   // Epoch time of the last record, seconds
+    };
+
+    /**
+     * @brief Container reading: bool(size_t position, void *buffer, size_t size), true if all the bytes are read
+     */
+    using ContainerRead = std::function<bool(size_t position, void *buffer, size_t size)>;
+
+    /**
+     * @brief Text output collecting the converted result, has the printing interface of the result file
+     */
+    class TextOutput
+    {
+    public:
+        /**
+         * @brief Print formatted string
+         *
+         * @param[in] format Format string
+         * @param[in] ... Arguments
+         * @return true always
+         */
+        bool printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+        /**
+         * @brief Print string and the line end
+         *
+         * @param[in] string String to print
+         * @return true always
+         */
+        bool println(const char *string);
+
+        /**
+         * @brief Print string made by the formatter
+         *
+         * @tparam Formatter Function of (char *string) returning the length of the formatted string
+         * @param[in] lengthMax Maximum length of the formatted string
+         * @param[in] formatter Formatter function
+         * @return true always
+         */
+        template <typename Formatter>
+        bool format(size_t lengthMax, Formatter formatter)
+        {
+            size_t offset = _text.size();
+            _text.resize(offset + lengthMax);
+            _text.resize(offset + formatter(&_text[offset]));
+
+            return true;
+        }
+
+        /**
+         * @brief Get the printed text
+         *
+         * @return Text
+         */
+        const std::string &text() const
+        {
+            return _text;
+        }
+
+        /**
+         * @brief Clear the printed text
+         */
+        void clear()
+        {
+            _text.clear();
+        }
+
+    private:
+        std::string _text; // Printed text
+    };
+
+    /**
+     * @brief Convert the binary PSD record to text in the same way as the firmware writes CSV results
+     *
+     * @param[in] data Record data, may be followed by other data
+     * @param[in] size Size of the data, bytes
+     * @param[out] output Text output
+     * @param[out] recordSize Size of the record with its CRC, bytes (valid if the record is converted)
+     * @return Status of the conversion
+     */
+    Status convertRecord(const uint8_t *data, size_t size, TextOutput &output, size_t &recordSize);
+
+    /**
+     * @brief Find the records of the time range in the result container
+     * Only the footer and the index are read, the records of the range are found by binary search.
+     * The index is rebuilt from the record trailers if the footer is broken (power fail), as the firmware does
+     *
+     * @param[in] read Container reading
+     * @param[in] size Size of the container, bytes
+     * @param[in] range Time range of the records
+     * @param[out] records Container records of the time range
+     * @param[out] isRebuilt true if the index is rebuilt, false if it is taken from the footer
+     * @return true if the records are found, false if the container has the other version or no records are found
+     */
+    bool readContainer(const ContainerRead &read, size_t size, const TimeRange &range, std::vector<ContainerRecord> &records,
+                       bool &isRebuilt);
+
+    /**
+     * @brief Read all the records of the result container in memory
+     *
+     * @param[in] data Container data
+     * @param[in] size Size of the data, bytes
+     * @param[out] records Container records
+     * @param[out] isRebuilt true if the index is rebuilt, false if it is taken from the footer
+     * @return true if the records are read, false if the container has the other version or no records are found
+     */
+    bool readContainer(const uint8_t *data, size_t size, std::vector<ContainerRecord> &records, bool &isRebuilt);
+
+    /**
+     * @brief Get the description of the conversion status
+     *
+     * @param[in] status Status of the conversion
+     * @return Status description
+     */
+    const char *getStatusString(Status status);
+} // namespace PsdConvert
@@ -0,0 +1,310 @@
+/**
+ * @file main.cpp
+ * @author Mikhail Kalina (apollo.mk58@gmail.com)
+ * @brief Host converter of the binary PSD records to the text (CSV) results
+ * Usage: psd_convert <record file> [CSV file], the text goes to stdout without the CSV file
+ *        psd_convert <container file (.pdc)> [directory] [--from <epoch>] [--to <epoch>], every record of the time range
+ *        goes to <timestamp>.csv in the directory, only the container index and the records of the range are read
+ * @version 0.1
+ * @date 2024-09-02
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+
+#include "Measurements/PsdRecord.h"
+#include "PsdConvert.h"
+
+namespace
+{
+    // Result container file extension
+    const char *containerExtension = ".pdc";
+
+    /**
+     * @brief Read the whole file
+     *
+     * @param[in] path Path to the file
+     * @param[out] data File data
+     * @return true if the file is read, false otherwise
+     */
+    bool readFile(const char *path, std::vector<uint8_t> &data)
+    {
+        FILE *file = fopen(path, "rb");
+        if (file == nullptr)
+        {
+            return false;
+        }
+
+        uint8_t buffer[4096];
+        size_t size;
+        while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        {
+            data.insert(data.end(), buffer, buffer + size);
+        }
+
+        bool result = (ferror(file) == 0);
+        fclose(file);
+
+        return result;
+    }
+
+    /**
+     * @brief Write the text to the file, or to stdout without the file
+     *
+     * @param[in] path Path to the file (nullptr for stdout)
+     * @param[in] text Text to write
+     * @return true if the text is written, false otherwise
+     */
+    bool writeFile(const char *path, const std::string &text)
+    {
+        FILE *file = (path != nullptr) ? fopen(path, "wb") : stdout;
+        if (file == nullptr)
+        {
+            fprintf(stderr, "Can't create \"%s\"\n", path);
+            return false;
+        }
+
+        bool result = (fwrite(text.data(), 1, text.size(), file) == text.size());
+        if (file != stdout)
+        {
+            result = (fclose(file) == 0) && result;
+        }
+
+        if (result == false)
+        {
+            fprintf(stderr, "Writing failed\n");
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Convert the records written one after another
+     *
+     * @param[in] data Records data
+     * @param[in] path Path to the CSV file (nullptr for stdout)
+     * @return Exit code
+     */
+    int convertRecords(const std::vector<uint8_t> &data, const char *path)
+    {
+        PsdConvert::TextOutput output;
+        size_t offset = 0;
+        size_t recordCount = 0;
+        while (offset < data.size())
+        {
+            size_t recordSize = 0;
+            PsdConvert::Status status = PsdConvert::convertRecord(&data[offset], data.size() - offset, output, recordSize);
+            if (status != PsdConvert::Status::Converted)
+            {
+                fprintf(stderr, "Record at offset %zu: %s\n", offset, PsdConvert::getStatusString(status));
+                return 1;
+            }
+
+            offset += recordSize;
+            recordCount++;
+        }
+
+        if (writeFile(path, output.text()) == false)
+        {
+            return 1;
+        }
+
+        fprintf(stderr, "%zu records converted\n", recordCount);
+
+        return 0;
+    }
+
+    /**
+     * @brief Extract the records of the time range of the result container to CSV files, PSD records are converted
+     *
+     * @param[in] path Path to the container file
+     * @param[in] directory Directory of the CSV files
+     * @param[in] range Time range of the records
+     * @return Exit code
+     */
+    int extractContainer(const char *path, const char *directory, const PsdConvert::TimeRange &range)
+    {
+        FILE *file = fopen(path, "rb");
+        if (file == nullptr)
+        {
+            fprintf(stderr, "Can't read \"%s\"\n", path);
+            return 1;
+        }
+
+        long fileSize = -1;
+        if (fseek(file, 0, SEEK_END) == 0)
+        {
+            fileSize = ftell(file);
+        }
+        if (fileSize < 0)
+        {
+            fprintf(stderr, "Can't read \"%s\"\n", path);
+            fclose(file);
+            return 1;
+        }
+
+        size_t bytesRead = 0;
+        auto read = [file, &bytesRead](size_t position, void *buffer, size_t size)
+        {
+            bool result = (fseek(file, static_cast<long>(position), SEEK_SET) == 0 && fread(buffer, 1, size, file) == size);
+            bytesRead += size;
+
+            return result;
+        };
+
+        std::vector<PsdConvert::ContainerRecord> records;
+        bool isRebuilt = false;
+        bool result = PsdConvert::readContainer(read, fileSize, range, records, isRebuilt);
+        if (result == false)
+        {
+            fprintf(stderr, "Container is broken or has unsupported version\n");
+            fclose(file);
+            return 1;
+        }
+
+        if (isRebuilt == true)
+        {
+            fprintf(stderr, "Container has no valid index, the records are found by their trailers\n");
+        }
+
+        size_t failures = 0;
+        std::vector<uint8_t> recordData;
+        for (const auto &record : records)
+        {
+            recordData.resize(record.size);
+            if (read(record.offset, recordData.data(), record.size) == false)
+            {
+                fprintf(stderr, "Record at offset %zu isn't read\n", record.offset);
+                failures++;
+                continue;
+            }
+
+            PsdConvert::TextOutput output;
+            bool isPsd = (record.size >= sizeof(uint32_t) &&
+                          memcmp(recordData.data(), &Measurements::PsdRecord::magic, sizeof(uint32_t)) == 0);
+            if (isPsd == true)
+            {
+                size_t recordSize = 0;
+                PsdConvert::Status status = PsdConvert::convertRecord(recordData.data(), record.size, output, recordSize);
+                if (status != PsdConvert::Status::Converted)
+                {
+                    fprintf(stderr, "Record at offset %zu: %s\n", record.offset, PsdConvert::getStatusString(status));
+                    failures++;
+                    continue;
+                }
+            }
+            else
+            {
+                // CSV records are the text of the result file
+                output.printf("%.*s", static_cast<int>(record.size), reinterpret_cast<const char *>(recordData.data()));
+            }
+
+            // Same name as the result file of the file per measurement layout
+            time_t time = record.time;
+            struct tm date;
+            gmtime_r(&time, &date);
+
+            char name[80];
+            snprintf(name, sizeof(name), "%04d%02d%02dT%02d%02d%02d.csv", date.tm_year + 1900, date.tm_mon + 1,
+                     date.tm_mday, date.tm_hour, date.tm_min, date.tm_sec);
+
+            std::string csvPath = std::string(directory) + "/" + name;
+            if (writeFile(csvPath.c_str(), output.text()) == false)
+            {
+                failures++;
+            }
+        }
+
+        fclose(file);
+
+        fprintf(stderr, "%zu of %zu records extracted, %zu of %ld bytes read\n", records.size() - failures, records.size(),
+                bytesRead, fileSize);
+
+        return (failures == 0) ? 0 : 1;
+    }
+
+    /**
+     * @brief Parse the epoch time argument
+     *
+     * @param[in] string Argument string
+     * @param[out] time Epoch time, seconds
+     * @return true if the argument is a valid epoch time, false otherwise
+     */
+    bool parseTime(const char *string, uint32_t &time)
+    {
+        char *end = nullptr;
+        unsigned long long value = strtoull(string, &end, 10);
+        bool result = (end != string && *end == '\0' && value <= UINT32_MAX);
+        if (result == true)
+        {
+            time = static_cast<uint32_t>(value);
+        }
+
+        return result;
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const char *paths[2] = {nullptr, nullptr};
+    size_t pathCount = 0;
+    PsdConvert::TimeRange range = {.from = 0, .to = UINT32_MAX};
+    bool hasRange = false;
+
+    bool result = true;
+    for (int idx = 1; idx < argc && result == true; idx++)
+    {
+        bool isFrom = (strcmp(argv[idx], "--from") == 0);
+        bool isTo = (strcmp(argv[idx], "--to") == 0);
+        if (isFrom == true || isTo == true)
+        {
+            result = (idx + 1 < argc && parseTime(argv[idx + 1], isFrom ? range.from : range.to));
+            hasRange = true;
+            idx++;
+        }
+        else
+        {
+            result = (pathCount < 2);
+            if (result == true)
+            {
+                paths[pathCount++] = argv[idx];
+            }
+        }
+    }
+
+    size_t pathLength = (pathCount > 0) ? strlen(paths[0]) : 0;
+    size_t extensionLength = strlen(containerExtension);
+    bool isContainer = (pathLength > extensionLength &&
+                        strcmp(&paths[0][pathLength - extensionLength], containerExtension) == 0);
+
+    if (result == false || pathCount == 0 || (hasRange == true && isContainer == false))
+    {
+        fprintf(stderr, "Usage: %s <record file> [CSV file]\n", argv[0]);
+        fprintf(stderr, "       %s <container file%s> [directory] [--from <epoch>] [--to <epoch>]\n", argv[0], containerExtension);
+        return 2;
+    }
+
+    if (isContainer == true)
+    {
+        return extractContainer(paths[0], (pathCount == 2) ? paths[1] : ".", range);
+    }
+
+    std::vector<uint8_t> data;
+    result = readFile(paths[0], data);
+    if (result == false)
+    {
+        fprintf(stderr, "Can't read \"%s\"\n", paths[0]);
+        return 1;
+    }
+
+    return convertRecords(data, paths[1]);
+}